@@ -2080,6 +2080,26 @@ void Label::updateColor()
     }
 }
 
+void Label::resetForReuse()
+{
+    // the internal draw nodes are children too, recreate them once the children are removed
+    bool underlined = _underlineNode != nullptr;
+    Node::resetForReuse();
+    _underlineNode = nullptr;
+
+#if CC_LABEL_DEBUG_DRAW
+    _debugDrawNode = DrawNode::create();
+    addChild(_debugDrawNode);
+#endif
+    if (underlined)
+    {
+        enableUnderline();
+    }
+
+    setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    _contentDirty = true;
+}
+
 std::string Label::getDescription() const
 {
     char tmp[50];
@@ -599,6 +599,8 @@ public:
 
     virtual std::string getDescription() const override;
 
+    virtual void resetForReuse() override;
+
     virtual const Size& getContentSize() const override;
     virtual Rect getBoundingBox() const override;
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <regex>
 
@@ -39,6 +40,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCTransformHierarchy.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "math/TransformUtils.h"
@@ -58,6 +60,12 @@ NS_CC_BEGIN
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 unsigned int Node::s_globalOrderOfArrival = 0;
 
+namespace
+{
+    // sortAllChildren() sorts all the children again when more of them were added or reordered since the last sort
+    static const size_t MAX_REORDERED_CHILDREN = 16;
+}
+
 // MARK: Constructor, Destructor, Init
 
 Node::Node()
@@ -83,6 +91,10 @@ Node::Node()
 , _additionalTransformDirty(false)
 , _transformUpdated(true)
 , _cullingDirty(true)
+, _transformHierarchy(nullptr)
+, _memberTransformHierarchy(nullptr)
+, _transformHierarchyIndex(-1)
+, _touchBoundsListenerCount(0)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrderAndArrival(0)
@@ -162,6 +174,8 @@ Node::~Node()
     // attributes
     CC_SAFE_RELEASE_NULL(_glProgramState);
 
+    CC_SAFE_DELETE(_transformHierarchy);
+
     for (auto& child : _children)
     {
         child->_parent = nullptr;
@@ -218,6 +232,40 @@ void Node::cleanup()
         child->cleanup();
 }
 
+void Node::resetForReuse()
+{
+    CCASSERT(!_running, "A running node can't be reset!");
+
+    this->stopAllActions();
+    this->unscheduleAllCallbacks();
+    _eventDispatcher->removeEventListenersForTarget(this);
+    this->removeAllChildrenWithCleanup(true);
+
+    // transform
+    this->setPosition(Vec2::ZERO);
+    this->setPositionZ(0.0f);
+    this->setRotation(0.0f);
+    this->setScale(1.0f);
+    this->setSkewX(0.0f);
+    this->setSkewY(0.0f);
+    this->setAnchorPoint(Vec2::ZERO);
+    this->setIgnoreAnchorPointForPosition(false);
+    this->setAdditionalTransform(nullptr);
+
+    // display
+    this->setVisible(true);
+    this->setColor(Color3B::WHITE);
+    this->setOpacity(255);
+    this->setLocalZOrder(0);
+    this->setGlobalZOrder(0.0f);
+
+    // identity
+    this->setTag(Node::INVALID_TAG);
+    this->setName("");
+    this->setUserData(nullptr);
+    this->setUserObject(nullptr);
+}
+
 std::string Node::getDescription() const
 {
     return StringUtils::format("<Node | Tag = %d", _tag);
@@ -237,6 +285,7 @@ void Node::setSkewX(float skewX)
 
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 float Node::getSkewY() const
@@ -251,6 +300,7 @@ void Node::setSkewY(float skewY)
 
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 void Node::setLocalZOrder(int z)
@@ -303,6 +353,7 @@ void Node::setRotation(float rotation)
 
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 
     updateRotationQuat();
 }
@@ -347,6 +398,7 @@ void Node::setRotationSkewX(float rotationX)
 
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 
     updateRotationQuat();
 }
@@ -363,6 +415,7 @@ void Node::setRotationSkewY(float rotationY)
 
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 
     updateRotationQuat();
 }
@@ -382,6 +435,7 @@ void Node::setScale(float scale)
 
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 /// scaleX getter
@@ -399,6 +453,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 /// scaleX setter
@@ -409,6 +464,7 @@ void Node::setScaleX(float scaleX)
 
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 /// scaleY getter
@@ -425,6 +481,7 @@ void Node::setScaleY(float scaleY)
 
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 void Node::setScaleZ(float scaleZ)
@@ -434,6 +491,7 @@ void Node::setScaleZ(float scaleZ)
 
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 float Node::getScaleZ() const
@@ -469,6 +527,7 @@ void Node::setPosition(float x, float y)
 
     _transformUpdated = _transformDirty = _inverseDirty = true;
     _usingNormalizedPosition = false;
+    syncTransformHierarchyState();
 }
 
 float Node::getPositionX() const
@@ -502,6 +561,7 @@ void Node::setPositionZ(float positionZ)
         return;
 
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 
     _positionZ = positionZ;
 }
@@ -522,6 +582,7 @@ void Node::setNormalizedPosition(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -543,6 +604,7 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        syncTransformHierarchyState();
     }
 }
 
@@ -564,6 +626,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        syncTransformHierarchyState();
     }
 }
 
@@ -581,6 +644,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        syncTransformHierarchyState();
     }
 }
 
@@ -593,8 +657,19 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    // the transform hierarchies this node leaves or joins rebuild their arrays
+    if (_memberTransformHierarchy != nullptr && _memberTransformHierarchy != _transformHierarchy)
+    {
+        _memberTransformHierarchy->removeSubtree(this);
+    }
+    if (parent != nullptr && parent->_memberTransformHierarchy != nullptr)
+    {
+        parent->_memberTransformHierarchy->setStructureDirty();
+    }
+
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 /// isRelativeAnchorPoint getter
@@ -609,6 +684,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        syncTransformHierarchyState();
     }
 }
 
@@ -934,6 +1010,7 @@ void Node::insertChildBefore(Node* child, Node* relativeChild)
     }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     _transformUpdated = true;
+    syncTransformHierarchyState();
     child->_setLocalZOrder(relativeChild->getLocalZOrder());
     auto idx = _children.getIndex(relativeChild);
     _children.insert(idx, child);
@@ -1158,7 +1235,8 @@ void Node::insertChild(Node* child, int z)
     }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     _transformUpdated = true;
-    _reorderChildDirty = true;
+    syncTransformHierarchyState();
+    markChildReordered(child);
     _children.pushBack(child);
     child->_setLocalZOrder(z);
 }
@@ -1166,20 +1244,185 @@ void Node::insertChild(Node* child, int z)
 void Node::reorderChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Child must be non-nil");
-    _reorderChildDirty = true;
+    markChildReordered(child);
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
 }
 
+void Node::markChildReordered(Node* child)
+{
+    if (!_reorderChildDirty)
+    {
+        _reorderedChildren.clear();
+        _reorderedChildren.push_back(child);
+        _reorderChildDirty = true;
+    }
+    else if (!_reorderedChildren.empty()
+             && std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child) == _reorderedChildren.end())
+    {
+        if (_reorderedChildren.size() < MAX_REORDERED_CHILDREN)
+        {
+            _reorderedChildren.push_back(child);
+        }
+        else
+        {
+            _reorderedChildren.clear();
+        }
+    }
+}
+
 void Node::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        sortNodes(_children);
+        if (_reorderedChildren.empty())
+        {
+            sortNodes(_children);
+        }
+        else
+        {
+            sortReorderedChildren();
+        }
+        _reorderedChildren.clear();
         _reorderChildDirty = false;
     }
 }
 
+void Node::sortReorderedChildren()
+{
+    // take the reordered children out, the others keep their sorted order at the front.
+    // Removed children may still be recorded, only those found are moved.
+    std::vector<std::pair<Node*, int>> moved;
+    int remainingCount = 0;
+    int childCount = (int)_children.size();
+    auto children = _children.begin();
+    for (int i = 0; i < childCount; ++i)
+    {
+        Node* child = children[i];
+        if (std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child) != _reorderedChildren.end())
+        {
+            moved.push_back(std::make_pair(child, i));
+        }
+        else
+        {
+            children[remainingCount++] = child;
+        }
+    }
+
+#if CC_64BITS
+    // z order and arrival are unique, any sort gives the same order
+    auto before = [](Node* n1, int /*index1*/, Node* n2, int /*index2*/) {
+        return n1->_localZOrderAndArrival < n2->_localZOrderAndArrival;
+    };
+    auto originalIndex = [](int /*position*/) { return 0; };
+#else
+    // the stable sort keeps the current order of the children of the same z order
+    auto before = [](Node* n1, int index1, Node* n2, int index2) {
+        return n1->_localZOrder < n2->_localZOrder || (n1->_localZOrder == n2->_localZOrder && index1 < index2);
+    };
+    // the index a remaining child had before the reordered ones were taken out
+    std::vector<int> movedIndices;
+    for (const auto& entry : moved)
+    {
+        movedIndices.push_back(entry.second);
+    }
+    auto originalIndex = [&movedIndices](int position) {
+        int index = position;
+        for (size_t i = 0; i < movedIndices.size() && movedIndices[i] <= index; ++i)
+        {
+            ++index;
+        }
+        return index;
+    };
+#endif
+    std::sort(moved.begin(), moved.end(), [&before](const std::pair<Node*, int>& m1, const std::pair<Node*, int>& m2) {
+        return before(m1.first, m1.second, m2.first, m2.second);
+    });
+
+    // then insert them from the last one, shifting the remaining children after each of them once
+    int end = remainingCount;
+    int out = childCount;
+    for (auto it = moved.rbegin(); it != moved.rend(); ++it)
+    {
+        int first = 0;
+        int last = end;
+        while (first < last)
+        {
+            int middle = first + (last - first) / 2;
+            if (before(it->first, it->second, children[middle], originalIndex(middle)))
+            {
+                last = middle;
+            }
+            else
+            {
+                first = middle + 1;
+            }
+        }
+
+        std::move_backward(children + first, children + end, children + out);
+        out -= end - first;
+        end = first;
+        children[--out] = it->first;
+    }
+}
+
+std::string Node::benchmarkChildReordering(int childCount, int frameCount)
+{
+    static const int reorderCounts[] = { 1, 4, 16, 64 };
+
+    std::string report = StringUtils::format("Reordering children of a node of %d children over %d frames, incremental / full sort:\n",
+                                             childCount, frameCount);
+    for (int reorderCount : reorderCounts)
+    {
+        // the same children and reorders on both nodes, the second one always sorts all its children
+        Node* parents[2] = { Node::create(), Node::create() };
+        std::vector<Node*> children[2];
+        for (int i = 0; i < childCount; ++i)
+        {
+            int z = rand() % 1000;
+            for (int p = 0; p < 2; ++p)
+            {
+                Node* child = Node::create();
+                child->setTag(i);
+                parents[p]->addChild(child, z);
+                children[p].push_back(child);
+            }
+        }
+        parents[0]->sortAllChildren();
+        parents[1]->sortAllChildren();
+
+        float milliseconds[2] = { 0, 0 };
+        bool same = true;
+        for (int frame = 0; frame < frameCount; ++frame)
+        {
+            for (int i = 0; i < reorderCount; ++i)
+            {
+                int index = rand() % childCount;
+                int z = rand() % 1000;
+                parents[0]->reorderChild(children[0][index], z);
+                parents[1]->reorderChild(children[1][index], z);
+            }
+            parents[1]->_reorderedChildren.clear();
+
+            for (int p = 0; p < 2; ++p)
+            {
+                auto start = std::chrono::steady_clock::now();
+                parents[p]->sortAllChildren();
+                milliseconds[p] += std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            for (int i = 0; i < childCount && same; ++i)
+            {
+                same = parents[0]->_children.at(i)->getTag() == parents[1]->_children.at(i)->getTag();
+            }
+        }
+
+        report += StringUtils::format("%3d reordered per frame: %8.3f / %8.3f ms per frame%s\n", reorderCount,
+                                      milliseconds[0] / frameCount, milliseconds[1] / frameCount, same ? "" : "  MISMATCH");
+    }
+    return report;
+}
+
 // MARK: draw / visit
 
 void Node::draw()
@@ -1200,6 +1443,44 @@ void Node::visit()
 }
 
 uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (_transformHierarchy != nullptr)
+    {
+        _transformHierarchy->update(parentTransform, parentFlags);
+    }
+
+    uint32_t flags = collectDirtyFlags(parentFlags);
+    const Mat4* worldTransform = nullptr;
+
+    if (_memberTransformHierarchy != nullptr)
+    {
+        // the hierarchy has the world transform already, when this node is visited from its parent in it
+        if (_memberTransformHierarchy == _transformHierarchy || (_parent != nullptr && &parentTransform == &_parent->_modelViewTransform))
+        {
+            worldTransform = _memberTransformHierarchy->getWorldTransform(_transformHierarchyIndex, flags);
+        }
+
+        if (worldTransform != nullptr)
+            flags = _memberTransformHierarchy->getFlags(_transformHierarchyIndex);
+        else
+            _memberTransformHierarchy->invalidate();
+    }
+
+    if(flags & FLAGS_DIRTY_MASK)
+    {
+        _modelViewTransform = worldTransform != nullptr ? *worldTransform : this->transform(parentTransform);
+
+        // the touch bounds of the node moved or were resized
+        if (_touchBoundsListenerCount > 0)
+            _eventDispatcher->setTouchBoundsDirtyForNode(this);
+    }
+
+    clearDirtyFlags();
+
+    return flags;
+}
+
+uint32_t Node::collectDirtyFlags(uint32_t parentFlags)
 {
     if(_usingNormalizedPosition)
     {
@@ -1219,15 +1500,57 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
     flags |= (_cullingDirty ? FLAGS_CULLING_DIRTY : 0);
 
+    return flags;
+}
 
-    if(flags & FLAGS_DIRTY_MASK)
-        _modelViewTransform = this->transform(parentTransform);
-
+void Node::clearDirtyFlags()
+{
     _transformUpdated = false;
     _contentSizeDirty = false;
     _cullingDirty = false;
+    syncTransformHierarchyState();
+}
 
-    return flags;
+void Node::syncTransformHierarchyState()
+{
+    if (_memberTransformHierarchy == nullptr)
+    {
+        return;
+    }
+
+    uint32_t state = (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0)
+                   | (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0)
+                   | (_cullingDirty ? FLAGS_CULLING_DIRTY : 0)
+                   | (_visible ? 0 : TransformHierarchy::STATE_HIDDEN)
+                   | (_usingNormalizedPosition ? TransformHierarchy::STATE_NORMALIZED_POSITION : 0);
+    _memberTransformHierarchy->setNodeState(_transformHierarchyIndex, state);
+}
+
+void Node::setTransformHierarchyEnabled(bool enabled)
+{
+    if (enabled == (_transformHierarchy != nullptr))
+    {
+        return;
+    }
+
+    // the subtree leaves the hierarchy of an ancestor while it has its own, and joins it back after
+    if (_memberTransformHierarchy != nullptr && _memberTransformHierarchy != _transformHierarchy)
+    {
+        _memberTransformHierarchy->removeSubtree(this);
+    }
+
+    if (enabled)
+    {
+        _transformHierarchy = new (std::nothrow) TransformHierarchy(this);
+    }
+    else
+    {
+        CC_SAFE_DELETE(_transformHierarchy);
+        if (_parent != nullptr && _parent->_memberTransformHierarchy != nullptr)
+        {
+            _parent->_memberTransformHierarchy->setStructureDirty();
+        }
+    }
 }
 
 bool Node::isVisitableByVisitingCamera() const
@@ -1801,6 +2124,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    syncTransformHierarchyState();
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1833,6 +2157,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    syncTransformHierarchyState();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -2152,6 +2477,7 @@ void Node::setCameraMask(unsigned short mask, bool applyChildren)
 void Node::markCullingDirty()
 {
     _cullingDirty = true;
+    syncTransformHierarchyState();
 }
 
 NS_CC_END
@@ -56,6 +56,7 @@ class Director;
 class GLProgram;
 class GLProgramState;
 class Material;
+class TransformHierarchy;
 
 /**
  * @addtogroup _2d
@@ -854,10 +855,21 @@ public:
     /**
      * Sorts the children array once before drawing, instead of every time when a child is added or reordered.
      * This approach can improves the performance massively.
+     * When only a few children were added or reordered since the last sort, they are moved to their place by binary
+     * search instead, with the same resulting order.
      * @note Don't call this manually unless a child added needs to be removed in the same frame.
      */
     virtual void sortAllChildren();
 
+    /**
+     * Times sortAllChildren() over frameCount frames on a node of childCount children, a few of which get a new local
+     * z order each frame, with the incremental reordering and with a full sort, and checks they give the same order.
+     * Returns one line per number of children reordered each frame. Used by the console command "scenegraph bench".
+     * @js NA
+     * @lua NA
+     */
+    static std::string benchmarkChildReordering(int childCount, int frameCount);
+
     /**
     * Sorts helper function
     *
@@ -1072,6 +1084,17 @@ public:
      */
     virtual void cleanup();
 
+    /**
+     * Restores the node to the state of a newly created one, so that it can be reused.
+     * It stops all actions and schedulers, removes its event listeners and children,
+     * and resets its transform, visibility, color, opacity, z order, tag, name and user data.
+     * The content of the node, like a texture or a text, is kept.
+     * Subclasses resetting their own state must call the parent implementation.
+     * The node must not be running.
+     * @see NodePool
+     */
+    virtual void resetForReuse();
+
     /**
      * Override this method to draw your own node.
      * The following GL states will be enabled by default:
@@ -1780,6 +1803,20 @@ public:
      */
     void markCullingDirty();
 
+    /**
+     * Keeps the transforms of this node and its descendants in flat arrays, updated in one pass before the subtree is
+     * visited instead of node by node. It pays off on large subtrees, typically set on the running scene.
+     * Descendants that enable it too have their own arrays.
+     * @see TransformHierarchy
+     * @param enabled Whether or not the subtree uses a transform hierarchy.
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+    /**
+     * Whether or not this node owns a transform hierarchy.
+     * @see `setTransformHierarchyEnabled(bool)`
+     */
+    bool isTransformHierarchyEnabled() const { return _transformHierarchy != nullptr; }
+
 CC_CONSTRUCTOR_ACCESS:
     // Nodes should be created using create();
     Node();
@@ -1803,6 +1840,11 @@ protected:
     /// helper that reorder a child
     void insertChild(Node* child, int z);
 
+    /// records a child added or reordered since the last sort, see sortAllChildren()
+    void markChildReordered(Node* child);
+    /// moves the recorded children to their place among the others, which are still sorted
+    void sortReorderedChildren();
+
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, ssize_t index, bool doCleanup);
 
@@ -1811,6 +1853,11 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    // the flags of processParentFlags(), then the reset of the dirty flags they were made of
+    uint32_t collectDirtyFlags(uint32_t parentFlags);
+    void clearDirtyFlags();
+    // writes the dirty flags and the visibility through to _memberTransformHierarchy, after any change of them
+    void syncTransformHierarchyState();
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1846,6 +1893,7 @@ protected:
     std::int64_t _localZOrderAndArrival; /// cache, for 64bits compress optimize.
     mutable Mat4* _additionalTransform; ///< two transforms needed by additional transforms
     Vector<Node*> _children;        ///< array of children nodes
+    std::vector<Node*> _reorderedChildren; ///< children added or reordered since the last sort, empty to sort them all
     Node* _parent;                  ///< weak reference to parent node
     Director* _director;            //cached director pointer to improve rendering performance
     std::string _name;              ///<a string label, an user defined string to identify this node
@@ -1932,6 +1980,15 @@ protected:
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
     bool _cullingDirty;  ///< Whether culling is dirty
 
+    TransformHierarchy* _transformHierarchy;        ///< the transform hierarchy of the subtree, if enabled
+    TransformHierarchy* _memberTransformHierarchy;  ///< the transform hierarchy this node is stored in, if any
+    int _transformHierarchyIndex;                   ///< index of this node in _memberTransformHierarchy
+
+    int _touchBoundsListenerCount;                  ///< number of the touch listeners of this node filtering by its bounds
+
+    friend class TransformHierarchy;
+    friend class TouchBoundsIndex;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
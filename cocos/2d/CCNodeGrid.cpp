@@ -110,6 +110,7 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t p
     if(dirty)
         _modelViewTransform = this->transform(parentTransform);
     _transformUpdated = false;
+    syncTransformHierarchyState();
 
     _groupCommand.init(_globalZOrder);
     renderer->addCommand(&_groupCommand);
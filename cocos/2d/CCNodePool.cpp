@@ -0,0 +1,269 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCNodePool.h"
+
+#include <algorithm>
+
+#include "2d/CCSprite.h"
+#include "2d/CCLabel.h"
+#include "2d/CCParticleSystemQuad.h"
+
+NS_CC_BEGIN
+
+static NodePool* s_sharedNodePool = nullptr;
+
+NodePool* NodePool::getInstance()
+{
+    if (s_sharedNodePool == nullptr)
+    {
+        s_sharedNodePool = new (std::nothrow) NodePool();
+    }
+    return s_sharedNodePool;
+}
+
+void NodePool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedNodePool);
+}
+
+NodePool::NodePool()
+{
+    registerType("Sprite", []() -> Node* { return Sprite::create(); });
+    registerType("Label", []() -> Node* { return Label::create(); });
+    registerType("ParticleSystemQuad", []() -> Node* { return ParticleSystemQuad::create(); });
+}
+
+NodePool::~NodePool()
+{
+    clearAll();
+}
+
+void NodePool::registerType(const std::string& type, const Factory& factory)
+{
+    CCASSERT(factory != nullptr, "Invalid factory!");
+
+    auto iter = _pools.find(type);
+    if (iter != _pools.end())
+    {
+        // the new factory may create another class, the free nodes and their class go with the old one
+        iter->second.factory = factory;
+        iter->second.nodeType = nullptr;
+        iter->second.freeNodes.clear();
+        return;
+    }
+
+    TypePool& pool = _pools[type];
+    pool.factory = factory;
+    pool.nodeType = nullptr;
+    pool.capacity = DEFAULT_CAPACITY;
+    pool.stats = Stats();
+}
+
+bool NodePool::isTypeRegistered(const std::string& type) const
+{
+    return findPool(type) != nullptr;
+}
+
+Node* NodePool::acquire(const std::string& type)
+{
+    TypePool* pool = findPool(type);
+    if (pool == nullptr)
+    {
+        CCLOG("NodePool: type '%s' isn't registered", type.c_str());
+        return nullptr;
+    }
+
+    if (pool->freeNodes.empty())
+    {
+        return createNode(pool);
+    }
+
+    // the free list owns the node, hand it over to the autorelease pool
+    Node* node = pool->freeNodes.back();
+    node->retain();
+    node->autorelease();
+    pool->freeNodes.popBack();
+    ++pool->stats.reused;
+    return node;
+}
+
+bool NodePool::recycle(const std::string& type, Node* node)
+{
+    CCASSERT(node != nullptr, "Invalid node!");
+
+    TypePool* pool = findPool(type);
+    if (pool == nullptr)
+    {
+        CCLOG("NodePool: type '%s' isn't registered", type.c_str());
+        return false;
+    }
+
+    // the class of the type is only known once the factory created a node, that one starts the free list
+    if (pool->nodeType == nullptr)
+    {
+        Node* created = createNode(pool);
+        if (created != nullptr && pool->freeNodes.size() < pool->capacity)
+        {
+            pool->freeNodes.pushBack(created);
+        }
+    }
+    if (pool->nodeType == nullptr || *pool->nodeType != typeid(*node))
+    {
+        CCLOGERROR("NodePool: a node of class %s can't be recycled as '%s'", typeid(*node).name(), type.c_str());
+        CCASSERT(false, "The node isn't of the type it is recycled as!");
+        return false;
+    }
+    CCASSERT(!pool->freeNodes.contains(node), "The node was recycled already!");
+
+    // keeps the node alive while it's removed from its parent
+    node->retain();
+    node->removeFromParentAndCleanup(true);
+
+    if (pool->freeNodes.size() >= pool->capacity)
+    {
+        ++pool->stats.discarded;
+    }
+    else
+    {
+        node->resetForReuse();
+        pool->freeNodes.pushBack(node);
+        ++pool->stats.recycled;
+    }
+    node->release();
+    return true;
+}
+
+void NodePool::prewarm(const std::string& type, ssize_t count)
+{
+    TypePool* pool = findPool(type);
+    if (pool == nullptr)
+    {
+        CCLOG("NodePool: type '%s' isn't registered", type.c_str());
+        return;
+    }
+
+    count = std::min(count, pool->capacity);
+    while (pool->freeNodes.size() < count)
+    {
+        Node* node = createNode(pool);
+        if (node == nullptr)
+            break;
+
+        pool->freeNodes.pushBack(node);
+    }
+}
+
+void NodePool::setCapacity(const std::string& type, ssize_t capacity)
+{
+    CCASSERT(capacity >= 0, "Invalid capacity!");
+
+    TypePool* pool = findPool(type);
+    if (pool == nullptr)
+    {
+        CCLOG("NodePool: type '%s' isn't registered", type.c_str());
+        return;
+    }
+
+    pool->capacity = capacity;
+    while (pool->freeNodes.size() > capacity)
+    {
+        pool->freeNodes.popBack();
+    }
+}
+
+ssize_t NodePool::getCapacity(const std::string& type) const
+{
+    const TypePool* pool = findPool(type);
+    return pool != nullptr ? pool->capacity : 0;
+}
+
+ssize_t NodePool::getFreeCount(const std::string& type) const
+{
+    const TypePool* pool = findPool(type);
+    return pool != nullptr ? pool->freeNodes.size() : 0;
+}
+
+NodePool::Stats NodePool::getStats(const std::string& type) const
+{
+    const TypePool* pool = findPool(type);
+    return pool != nullptr ? pool->stats : Stats();
+}
+
+std::string NodePool::getDescription() const
+{
+    std::string ret;
+    char line[256];
+    for (const auto& iter : _pools)
+    {
+        const TypePool& pool = iter.second;
+        snprintf(line, sizeof(line), "%s: free %d/%d, created %u, reused %u, recycled %u, discarded %u\n",
+                 iter.first.c_str(), (int)pool.freeNodes.size(), (int)pool.capacity,
+                 pool.stats.created, pool.stats.reused, pool.stats.recycled, pool.stats.discarded);
+        ret += line;
+    }
+    return ret;
+}
+
+void NodePool::clear(const std::string& type)
+{
+    TypePool* pool = findPool(type);
+    if (pool != nullptr)
+    {
+        pool->freeNodes.clear();
+    }
+}
+
+void NodePool::clearAll()
+{
+    for (auto& iter : _pools)
+    {
+        iter.second.freeNodes.clear();
+    }
+}
+
+Node* NodePool::createNode(TypePool* pool)
+{
+    Node* node = pool->factory();
+    if (node != nullptr)
+    {
+        pool->nodeType = &typeid(*node);
+        ++pool->stats.created;
+    }
+    return node;
+}
+
+NodePool::TypePool* NodePool::findPool(const std::string& type)
+{
+    auto iter = _pools.find(type);
+    return iter != _pools.end() ? &iter->second : nullptr;
+}
+
+const NodePool::TypePool* NodePool::findPool(const std::string& type) const
+{
+    auto iter = _pools.find(type);
+    return iter != _pools.end() ? &iter->second : nullptr;
+}
+
+NS_CC_END
@@ -0,0 +1,168 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCNODE_POOL_H__
+#define __CCNODE_POOL_H__
+
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "base/CCVector.h"
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class NodePool
+ * @brief Singleton keeping free lists of nodes to reuse them instead of creating and destroying them.
+ *
+ * Each free list is keyed by a type name and has a factory creating the nodes when the list is empty.
+ * The types "Sprite", "Label" and "ParticleSystemQuad" are registered by default.
+ *
+ * A node given back with recycle() must be of the exact class the factory of its type creates, other nodes are refused.
+ * It is removed from its parent with cleanup, then Node::resetForReuse() is called.
+ * That drops its actions, schedulers, event listeners and children, and restores its transform and display state,
+ * while its content (texture, text, particle configuration, GL program state) is kept.
+ */
+class CC_DLL NodePool
+{
+public:
+    /** The factory creating an autoreleased node of a type. */
+    typedef std::function<Node*()> Factory;
+
+    /** The counters of a type. */
+    struct Stats
+    {
+        /** Number of nodes created by the factory. */
+        unsigned int created;
+        /** Number of nodes acquired from the free list. */
+        unsigned int reused;
+        /** Number of nodes given back to the free list. */
+        unsigned int recycled;
+        /** Number of nodes given back while the free list was full. */
+        unsigned int discarded;
+    };
+
+    /** The default maximum number of free nodes kept per type. */
+    static const ssize_t DEFAULT_CAPACITY = 256;
+
+    /** Returns the shared instance of the pool. */
+    static NodePool* getInstance();
+
+    /** Destroys the pool, it releases all the free nodes. */
+    static void destroyInstance();
+
+    /** Registers a type, replacing the factory of an existing one. The free nodes of a replaced factory are released.
+     *
+     * @param type The name of the type.
+     * @param factory The function creating an autoreleased node of the type.
+     * @js NA
+     */
+    void registerType(const std::string& type, const Factory& factory);
+
+    /** Whether the type was registered. */
+    bool isTypeRegistered(const std::string& type) const;
+
+    /** Takes a node from the free list of a type, or creates one if the list is empty.
+     *
+     * @param type The name of the type.
+     * @return An autoreleased node, or nullptr if the type isn't registered.
+     */
+    Node* acquire(const std::string& type);
+
+    /** Gives a node back to the free list of its type.
+     * The node is removed from its parent and reset, it's released instead if the free list is full.
+     * A node whose class isn't the one the factory of the type creates is refused: this asserts, and in release
+     * builds the node is left untouched.
+     *
+     * @param type The name of the type the node was acquired with.
+     * @param node The node to recycle.
+     * @return False if the type isn't registered or the node isn't of that type.
+     */
+    bool recycle(const std::string& type, Node* node);
+
+    /** Creates nodes until the free list of a type holds a number of them, to avoid creating them while playing.
+     *
+     * @param type The name of the type.
+     * @param count The number of free nodes wanted, it's limited by the capacity.
+     */
+    void prewarm(const std::string& type, ssize_t count);
+
+    /** Sets the maximum number of free nodes kept for a type, the extra ones are released. */
+    void setCapacity(const std::string& type, ssize_t capacity);
+
+    /** Gets the maximum number of free nodes kept for a type. */
+    ssize_t getCapacity(const std::string& type) const;
+
+    /** Gets the number of free nodes of a type. */
+    ssize_t getFreeCount(const std::string& type) const;
+
+    /** Gets the counters of a type.
+     * @js NA
+     */
+    Stats getStats(const std::string& type) const;
+
+    /** Returns the counters of all types, one line per type. */
+    std::string getDescription() const;
+
+    /** Releases the free nodes of a type. */
+    void clear(const std::string& type);
+
+    /** Releases the free nodes of all types. */
+    void clearAll();
+
+protected:
+    NodePool();
+    ~NodePool();
+
+    struct TypePool
+    {
+        Factory factory;
+        // the class of the nodes the factory creates, nullptr until it created one
+        const std::type_info* nodeType;
+        Vector<Node*> freeNodes;
+        ssize_t capacity;
+        Stats stats;
+    };
+
+    TypePool* findPool(const std::string& type);
+    const TypePool* findPool(const std::string& type) const;
+    // creates a node with the factory of a pool and records its class
+    Node* createNode(TypePool* pool);
+
+    std::unordered_map<std::string, TypePool> _pools;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCNODE_POOL_H__
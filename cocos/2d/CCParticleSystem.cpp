@@ -812,6 +812,15 @@ void ParticleSystem::onExit()
     Node::onExit();
 }
 
+void ParticleSystem::resetForReuse()
+{
+    Node::resetForReuse();
+
+    // drops the live particles, resetSystem() starts emitting again
+    stopSystem();
+    _particleCount = 0;
+}
+
 void ParticleSystem::stopSystem()
 {
     _isActive = false;
@@ -743,6 +743,7 @@ public:
     // Overrides
     virtual void onEnter() override;
     virtual void onExit() override;
+    virtual void resetForReuse() override;
     virtual void update(float dt) override;
     virtual Texture2D* getTexture() const override;
     virtual void setTexture(Texture2D *texture) override;
@@ -247,6 +247,7 @@ bool Sprite::initWithPolygon(const cocos2d::PolygonInfo &info)
     if(texture && initWithTexture(texture))
     {
         _polyInfo = info;
+        _trianglesCommand.setGeometryDirty();
         setContentSize(_polyInfo.rect.size / _director->getContentScaleFactor());
         ret = true;
     }
@@ -314,6 +315,8 @@ Sprite::Sprite(void)
 , _spriteFrame(nullptr)
 , _insideBounds(true)
 {
+    // every change of the vertices goes through setGeometryDirty()
+    _trianglesCommand.setGeometryTracked(true);
 #if CC_SPRITE_DEBUG_DRAW
     _debugDrawNode = DrawNode::create();
     addChild(_debugDrawNode);
@@ -460,6 +463,7 @@ void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimme
     }
 
     _polyInfo.setQuad(&_quad);
+    _trianglesCommand.setGeometryDirty();
 }
 
 // override this method to generate "double scale" sprites
@@ -948,6 +952,7 @@ void Sprite::setFlippedX(bool flippedX)
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.x = _contentSize.width -v.x;
         }
+        _trianglesCommand.setGeometryDirty();
         if (_textureAtlas) {
             setDirty(true);
         }
@@ -968,6 +973,7 @@ void Sprite::setFlippedY(bool flippedY)
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.y = _contentSize.height -v.y;
         }
+        _trianglesCommand.setGeometryDirty();
         if (_textureAtlas) {
             setDirty(true);
         }
@@ -998,6 +1004,7 @@ void Sprite::updateColor(void)
     for (ssize_t i = 0; i < _polyInfo.triangles.vertCount; i++) {
         _polyInfo.triangles.verts[i].colors = color4;
     }
+    _trianglesCommand.setGeometryDirty();
 
     // renders using batch node
     if (_batchNode)
@@ -1073,6 +1080,7 @@ void Sprite::setSpriteFrame(SpriteFrame *spriteFrame)
     if(spriteFrame->hasPolygonInfo())
     {
         _polyInfo = spriteFrame->getPolygonInfo();
+        _trianglesCommand.setGeometryDirty();
     }
     if (spriteFrame->hasAnchorPoint())
     {
@@ -1151,6 +1159,7 @@ void Sprite::setBatchNode(SpriteBatchNode *spriteBatchNode)
         _quad.br.vertices.set(x2, y1, 0);
         _quad.tl.vertices.set(x1, y2, 0);
         _quad.tr.vertices.set(x2, y2, 0);
+        _trianglesCommand.setGeometryDirty();
 
     } else {
 
@@ -1179,6 +1188,16 @@ void Sprite::updateBlendFunc(void)
     }
 }
 
+void Sprite::resetForReuse()
+{
+    Node::resetForReuse();
+
+    setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    setFlippedX(false);
+    setFlippedY(false);
+    updateBlendFunc();
+}
+
 std::string Sprite::getDescription() const
 {
     int texture_id = -1;
@@ -1197,6 +1216,7 @@ const PolygonInfo& Sprite::getPolygonInfo() const
 void Sprite::setPolygonInfo(const PolygonInfo& info)
 {
     _polyInfo = info;
+    _trianglesCommand.setGeometryDirty();
 }
 
 NS_CC_END
@@ -388,6 +388,21 @@ public:
      * @param PolygonInfo the polygon information object
      */
     void setPolygonInfo(const PolygonInfo& info);
+
+    /**
+     * Sets whether the sprite geometry rarely changes, e.g. backgrounds and static UI.
+     * The renderer then keeps its world space vertices in a retained buffer and only uploads
+     * them again when the transform, color or texture coordinates change.
+     *
+     * @param isStatic true if the geometry is static, false otherwise.
+     */
+    void setStaticGeometry(bool isStatic) { _trianglesCommand.setStatic(isStatic); }
+    /**
+     * Returns whether the sprite geometry is static.
+     *
+     * @return true if the geometry is static, false otherwise.
+     */
+    bool isStaticGeometry() const { return _trianglesCommand.isStatic(); }
     //
     // Overrides
     //
@@ -415,6 +430,7 @@ public:
 
     /// @{
     /// @name Functions inherited from Node.
+    virtual void resetForReuse() override;
     virtual void setScaleX(float scaleX) override;
     virtual void setScaleY(float scaleY) override;
     virtual void setScale(float scaleX, float scaleY) override;
@@ -72,6 +72,7 @@ SpriteFrame* SpriteFrame::create(const std::string& filename, const Rect& rect,
 SpriteFrame::SpriteFrame()
 : _rotated(false)
 , _texture(nullptr)
+, _atlasSourceTexture(nullptr)
 {
 
 }
@@ -91,14 +92,23 @@ bool SpriteFrame::initWithTextureFilename(const std::string& filename, const Rec
 bool SpriteFrame::initWithTexture(Texture2D* texture, const Rect& rect, bool rotated, const Vec2& offset, const Size& originalSize)
 {
     _texture = texture;
+    _rectInPixels = rect;
 
-    if (texture)
+    // small textures packed in the dynamic atlas are drawn from their page, so they batch together
+    if (texture && texture->getAtlasTexture())
     {
-        texture->retain();
+        _atlasSourceTexture = texture;
+        _atlasSourceTexture->retain();
+        _texture = texture->getAtlasTexture();
+        _rectInPixels.origin += texture->getAtlasRectInPixels().origin;
     }
 
-    _rectInPixels = rect;
-    _rect = CC_RECT_PIXELS_TO_POINTS(rect);
+    if (_texture)
+    {
+        _texture->retain();
+    }
+
+    _rect = CC_RECT_PIXELS_TO_POINTS(_rectInPixels);
     _offsetInPixels = offset;
     _offset = CC_POINT_PIXELS_TO_POINTS( _offsetInPixels );
     _originalSizeInPixels = originalSize;
@@ -129,6 +139,7 @@ SpriteFrame::~SpriteFrame()
 {
     CCLOGINFO("deallocing SpriteFrame: %p", this);
     CC_SAFE_RELEASE(_texture);
+    CC_SAFE_RELEASE(_atlasSourceTexture);
 }
 
 SpriteFrame* SpriteFrame::clone() const
@@ -137,6 +148,8 @@ SpriteFrame* SpriteFrame::clone() const
     SpriteFrame *copy = new (std::nothrow) SpriteFrame();
     copy->initWithTextureFilename(_textureFilename, _rectInPixels, _rotated, _offsetInPixels, _originalSizeInPixels);
     copy->setTexture(_texture);
+    copy->_atlasSourceTexture = _atlasSourceTexture;
+    CC_SAFE_RETAIN(_atlasSourceTexture);
     copy->setPolygonInfo(_polygonInfo);
     copy->autorelease();
     return copy;
@@ -197,6 +210,8 @@ void SpriteFrame::setTexture(Texture2D * texture)
         CC_SAFE_RELEASE(_texture);
         CC_SAFE_RETAIN(texture);
         _texture = texture;
+        // the rect is not in the atlas page anymore
+        CC_SAFE_RELEASE_NULL(_atlasSourceTexture);
     }
 }
 
@@ -167,6 +167,8 @@ public:
     inline void setOriginalSize(const Size& sizeInPixels) { _originalSize = sizeInPixels; }
 
     /** Get texture of the frame.
+     * A frame created with a texture packed in the dynamic atlas uses the atlas page instead,
+     * and its rect is in the page. See TextureCache::setDynamicAtlasEnabled().
      *
      * @return The texture of the sprite frame.
      */
@@ -268,6 +270,8 @@ protected:
     Vec2 _offsetInPixels;
     Size _originalSizeInPixels;
     Texture2D *_texture;
+    // texture the frame was created with when _texture is its dynamic atlas page, retained so its place stays reserved
+    Texture2D *_atlasSourceTexture;
     std::string  _textureFilename;
     PolygonInfo _polygonInfo;
 };
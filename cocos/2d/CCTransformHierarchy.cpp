@@ -0,0 +1,322 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTransformHierarchy.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+#include "2d/CCNode.h"
+#include "base/CCThreadPool.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // nodes that are not visited this frame, because they or one of their ancestors are hidden
+    static const uint32_t FLAGS_HIDDEN = 1u << 31;
+    // fewer dirty nodes are not worth waking the workers, smaller subtrees are not split in tasks
+    static const int MIN_TASK_NODE_COUNT = 512;
+
+    static int s_workerThreadCount = 0;
+    static experimental::ThreadPool* s_workerPool = nullptr;
+}
+
+void TransformHierarchy::setWorkerThreadCount(int count)
+{
+    count = std::max(count, 0);
+    if (count == s_workerThreadCount)
+    {
+        return;
+    }
+
+    CC_SAFE_DELETE(s_workerPool);
+    if (count > 0)
+    {
+        s_workerPool = experimental::ThreadPool::newFixedThreadPool(count);
+    }
+    s_workerThreadCount = s_workerPool != nullptr ? count : 0;
+}
+
+int TransformHierarchy::getWorkerThreadCount()
+{
+    return s_workerThreadCount;
+}
+
+TransformHierarchy::TransformHierarchy(Node* root)
+: _root(root)
+, _plannedThreadCount(0)
+, _structureDirty(true)
+, _valid(false)
+{
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    clearMembers(_root);
+}
+
+void TransformHierarchy::clearMembers(Node* node)
+{
+    if (node->_memberTransformHierarchy != this)
+    {
+        return;
+    }
+
+    node->_memberTransformHierarchy = nullptr;
+    node->_transformHierarchyIndex = -1;
+    for (const auto& child : node->_children)
+    {
+        clearMembers(child);
+    }
+}
+
+void TransformHierarchy::removeSubtree(Node* node)
+{
+    clearMembers(node);
+    _structureDirty = true;
+}
+
+void TransformHierarchy::rebuild()
+{
+    _nodes.clear();
+    _parents.clear();
+    _subtreeEnds.clear();
+    _nodeStates.clear();
+
+    // depth first, with a stack for deep trees. A null node closes the subtree of its parent index.
+    std::vector<std::pair<Node*, int>> stack;
+    stack.push_back(std::make_pair(_root, -1));
+    while (!stack.empty())
+    {
+        auto entry = stack.back();
+        stack.pop_back();
+        if (entry.first == nullptr)
+        {
+            _subtreeEnds[entry.second] = (int)_nodes.size();
+            continue;
+        }
+
+        Node* node = entry.first;
+        int index = (int)_nodes.size();
+        node->_memberTransformHierarchy = this;
+        node->_transformHierarchyIndex = index;
+        _nodes.push_back(node);
+        _parents.push_back(entry.second);
+        _subtreeEnds.push_back(index + 1);
+        _nodeStates.push_back(0);
+        node->syncTransformHierarchyState();
+
+        stack.push_back(std::make_pair(nullptr, index));
+        for (auto it = node->_children.rbegin(); it != node->_children.rend(); ++it)
+        {
+            if ((*it)->_transformHierarchy == nullptr)
+            {
+                stack.push_back(std::make_pair(*it, index));
+            }
+        }
+    }
+
+    _flags.resize(_nodes.size());
+    _localTransforms.resize(_nodes.size());
+    _worldTransforms.resize(_nodes.size());
+    _plannedThreadCount = 0;
+    _structureDirty = false;
+    _valid = false;
+}
+
+void TransformHierarchy::planTasks(int threadCount)
+{
+    _serialNodes.clear();
+    _taskRanges.clear();
+    _taskOffsets.clear();
+
+    // subtrees larger than a task are split, their roots are updated before the tasks
+    int targetSize = std::max(MIN_TASK_NODE_COUNT, (int)_nodes.size() / (threadCount * 4));
+    int rangeNodeCount = 0;
+    std::vector<int> stack(1, 0);
+    std::vector<int> children;
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+        int end = _subtreeEnds[index];
+        if (end - index <= targetSize || end == index + 1)
+        {
+            _taskRanges.push_back({ index, end });
+            rangeNodeCount += end - index;
+            continue;
+        }
+
+        _serialNodes.push_back(index);
+        children.clear();
+        for (int child = index + 1; child < end; child = _subtreeEnds[child])
+        {
+            children.push_back(child);
+        }
+        stack.insert(stack.end(), children.rbegin(), children.rend());
+    }
+
+    // then the ranges, in order, are grouped in about threadCount tasks of the same size
+    int taskSize = (rangeNodeCount + threadCount - 1) / threadCount;
+    int currentSize = 0;
+    _taskOffsets.push_back(0);
+    for (size_t i = 0; i < _taskRanges.size(); ++i)
+    {
+        currentSize += _taskRanges[i].end - _taskRanges[i].begin;
+        if (currentSize >= taskSize && i + 1 < _taskRanges.size())
+        {
+            _taskOffsets.push_back((int)i + 1);
+            currentSize = 0;
+        }
+    }
+    _taskOffsets.push_back((int)_taskRanges.size());
+    _plannedThreadCount = threadCount;
+}
+
+void TransformHierarchy::update(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (_structureDirty)
+    {
+        rebuild();
+    }
+
+    // propagate the flags the way Node::processParentFlags() computes them, from the states the nodes wrote through.
+    // Only nodes with a normalized position are asked, on the main thread as their flags depend on their parent.
+    static const uint32_t OWN_FLAGS = Node::FLAGS_TRANSFORM_DIRTY | Node::FLAGS_CONTENT_SIZE_DIRTY | Node::FLAGS_CULLING_DIRTY;
+    uint32_t forcedFlags = _valid ? 0 : Node::FLAGS_TRANSFORM_DIRTY;
+    int count = (int)_nodes.size();
+    int dirtyCount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t flags = (i == 0) ? parentFlags : _flags[_parents[i]];
+        uint32_t state = _nodeStates[i];
+        if ((flags & FLAGS_HIDDEN) || (state & STATE_HIDDEN))
+        {
+            // left dirty, for the first frame they are visible again
+            _flags[i] = FLAGS_HIDDEN;
+            continue;
+        }
+
+        if (state & STATE_NORMALIZED_POSITION)
+        {
+            flags = _nodes[i]->collectDirtyFlags(flags);
+        }
+        else
+        {
+            flags |= state & OWN_FLAGS;
+        }
+        flags |= forcedFlags;
+        if (flags & Node::FLAGS_DIRTY_MASK)
+        {
+            ++dirtyCount;
+        }
+        else if (state & OWN_FLAGS)
+        {
+            _nodes[i]->clearDirtyFlags();
+        }
+        _flags[i] = flags;
+    }
+
+    // then the transforms of the dirty nodes, which only touch the nodes themselves
+    int threadCount = s_workerThreadCount + 1;
+    if (threadCount == 1 || dirtyCount < MIN_TASK_NODE_COUNT * 2)
+    {
+        updateTransforms(0, count, parentTransform);
+    }
+    else
+    {
+        if (_plannedThreadCount != threadCount)
+        {
+            planTasks(threadCount);
+        }
+
+        for (int index : _serialNodes)
+        {
+            updateTransforms(index, index + 1, parentTransform);
+        }
+
+        auto runTask = [this, &parentTransform](int task) {
+            for (int i = _taskOffsets[task]; i < _taskOffsets[task + 1]; ++i)
+            {
+                updateTransforms(_taskRanges[i].begin, _taskRanges[i].end, parentTransform);
+            }
+        };
+
+        int taskCount = (int)_taskOffsets.size() - 1;
+        int pendingTasks = taskCount - 1;
+        std::mutex pendingMutex;
+        std::condition_variable tasksDone;
+        for (int task = 1; task < taskCount; ++task)
+        {
+            s_workerPool->pushTask([&, task](int /*threadId*/) {
+                runTask(task);
+                // counted down under the lock, so that the main thread can't return before it is released
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                if (--pendingTasks == 0)
+                {
+                    tasksDone.notify_one();
+                }
+            });
+        }
+        runTask(0);
+
+        std::unique_lock<std::mutex> lock(pendingMutex);
+        tasksDone.wait(lock, [&pendingTasks]() { return pendingTasks == 0; });
+    }
+
+    _valid = true;
+}
+
+void TransformHierarchy::updateTransforms(int begin, int end, const Mat4& parentTransform)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        if (!(_flags[i] & Node::FLAGS_DIRTY_MASK))
+        {
+            continue;
+        }
+
+        // getNodeToParentTransform() reads the dirty flags, they are cleared after it
+        Node* node = _nodes[i];
+        _localTransforms[i] = node->getNodeToParentTransform();
+        node->clearDirtyFlags();
+
+        int parent = _parents[i];
+        Mat4::multiply(parent < 0 ? parentTransform : _worldTransforms[parent], _localTransforms[i], &_worldTransforms[i]);
+    }
+}
+
+const Mat4* TransformHierarchy::getWorldTransform(int index, uint32_t flags) const
+{
+    // flags the update didn't see mean the node or an ancestor changed since
+    if (!_valid || (_flags[index] & FLAGS_HIDDEN) || (flags & ~_flags[index]) != 0)
+    {
+        return nullptr;
+    }
+    return &_worldTransforms[index];
+}
+
+NS_CC_END
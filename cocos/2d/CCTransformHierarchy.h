@@ -0,0 +1,141 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_TRANSFORM_HIERARCHY_H__
+#define __CC_TRANSFORM_HIERARCHY_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/Mat4.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ The transforms of a subtree in flat arrays, see Node::setTransformHierarchyEnabled().
+ The nodes are stored depth first, so that every node comes after its parent and every subtree is a contiguous range.
+ The nodes write their dirty flags and visibility through to the arrays whenever they change (see setNodeState()), so
+ each frame the root propagates the flags of the subtree in one pass over the arrays, without reading the nodes, then
+ computes the local and world transforms of the dirty nodes in a second linear pass. With worker threads (see setWorkerThreadCount()) the
+ second pass of large subtrees is split in ranges of whole subtrees, updated concurrently; every node is still
+ computed the same way, by a single thread, so the transforms are identical to the serial ones.
+ Node::processParentFlags() then only copies the world transform of a node when it is visited from its parent in the
+ hierarchy; a node visited from anywhere else, or made dirty after the update, falls back to computing its own
+ transform and the whole hierarchy is recomputed the next frame.
+ Nodes that enable their own hierarchy are left out of their ancestors' one.
+ */
+class CC_DLL TransformHierarchy
+{
+public:
+    /** Bits of the node states besides the dirty flags of Node, see setNodeState(). */
+    static const uint32_t STATE_HIDDEN = 1u << 31;
+    // the position follows the content size of the parent, so the node is asked for its flags each frame
+    static const uint32_t STATE_NORMALIZED_POSITION = 1u << 30;
+
+    explicit TransformHierarchy(Node* root);
+    ~TransformHierarchy();
+
+    /** Updates the flags and the world transforms of the subtree, called by the root in Node::processParentFlags(). */
+    void update(const Mat4& parentTransform, uint32_t parentFlags);
+
+    /** Called when a child is added or removed in the subtree, the arrays are rebuilt on the next update. */
+    void setStructureDirty() { _structureDirty = true; }
+
+    /** Computes all the world transforms on the next update. */
+    void invalidate() { _valid = false; }
+
+    /** Returns the world transform of a node if it is up to date for a visit with these flags, or nullptr. */
+    const Mat4* getWorldTransform(int index, uint32_t flags) const;
+
+    /**
+     Sets the dirty flags of a node (FLAGS_TRANSFORM_DIRTY, FLAGS_CONTENT_SIZE_DIRTY and FLAGS_CULLING_DIRTY) and its
+     STATE_ bits, called by the node whenever they change. Until the next rebuild the index may be stale, the rebuild
+     reads the states of all the nodes again.
+     */
+    void setNodeState(int index, uint32_t state) { _nodeStates[index] = state; }
+
+    /** Returns the flags of a node, as Node::processParentFlags() would have computed them in the last update. */
+    uint32_t getFlags(int index) const { return _flags[index]; }
+
+    /** Returns the number of nodes in the hierarchy. */
+    int getNodeCount() const { return (int)_nodes.size(); }
+
+    /** Removes a detached subtree from the hierarchy. */
+    void removeSubtree(Node* node);
+
+    /**
+     Sets the number of worker threads updating the transforms of large hierarchies along with the main thread.
+     0, the default, updates them on the main thread only.
+     */
+    static void setWorkerThreadCount(int count);
+
+    /** Returns the number of worker threads. */
+    static int getWorkerThreadCount();
+
+protected:
+    struct Range
+    {
+        int begin;
+        int end;
+    };
+
+    void rebuild();
+    void clearMembers(Node* node);
+    // splits the nodes in serial nodes, then tasks of whole subtrees
+    void planTasks(int threadCount);
+    void updateTransforms(int begin, int end, const Mat4& parentTransform);
+
+    Node* _root;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    // the end of the subtree of each node
+    std::vector<int> _subtreeEnds;
+    // the ancestors of the task ranges, updated first on the main thread
+    std::vector<int> _serialNodes;
+    std::vector<Range> _taskRanges;
+    // the first range of each task, and the range count at the end
+    std::vector<int> _taskOffsets;
+    int _plannedThreadCount;
+    // written by the nodes, see setNodeState()
+    std::vector<uint32_t> _nodeStates;
+    std::vector<uint32_t> _flags;
+    std::vector<Mat4> _localTransforms;
+    std::vector<Mat4> _worldTransforms;
+    bool _structureDirty;
+    bool _valid;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_TRANSFORM_HIERARCHY_H__
@@ -60,6 +60,7 @@ cocos2d.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
 2d/CCNodeGrid.cpp \
+2d/CCNodePool.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
@@ -78,6 +79,7 @@ cocos2d.cpp \
 2d/CCTMXTiledMap.cpp \
 2d/CCTMXXMLParser.cpp \
 2d/CCTextFieldTTF.cpp \
+2d/CCTransformHierarchy.cpp \
 2d/CCTileMapAtlas.cpp \
 2d/CCTransition.cpp \
 2d/CCTransitionPageTurn.cpp \
@@ -87,6 +89,7 @@ cocos2d.cpp \
 platform/CCFileUtils.cpp \
 platform/CCGLView.cpp \
 platform/CCImage.cpp \
+platform/CCDecodedImageCache.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
 $(MATHNEONFILE) \
@@ -130,6 +133,7 @@ base/CCScheduler.cpp \
 base/CCScriptSupport.cpp \
 base/CCThreadPool.cpp \
 base/CCTouch.cpp \
+base/CCTouchBoundsIndex.cpp \
 base/CCUserDefault-android.cpp \
 base/CCUserDefault.cpp \
 base/CCValue.cpp \
@@ -144,6 +148,7 @@ base/ccTypes.cpp \
 base/ccUTF8.cpp \
 base/ccUtils.cpp \
 base/etc1.cpp \
+base/etc2.cpp \
 base/pvr.cpp \
 renderer/CCBatchCommand.cpp \
 renderer/CCCustomCommand.cpp \
@@ -154,12 +159,15 @@ renderer/CCGLProgramStateCache.cpp \
 renderer/CCGroupCommand.cpp \
 renderer/CCPrimitive.cpp \
 renderer/CCPrimitiveCommand.cpp \
+renderer/CCRenderCapture.cpp \
+renderer/CCFrameAllocator.cpp \
 renderer/CCQuadCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCDynamicAtlas.cpp \
 renderer/CCTrianglesCommand.cpp \
 renderer/CCVertexIndexBuffer.cpp \
 renderer/CCVertexIndexData.cpp \
@@ -271,6 +279,15 @@ LOCAL_CPPFLAGS := -Wno-deprecated-declarations
 LOCAL_EXPORT_CFLAGS   := -DUSE_FILE32API
 LOCAL_EXPORT_CPPFLAGS := -Wno-deprecated-declarations
 
+# Headless build: ndk-build CC_USE_GL_NULL=1 redirects the GL calls to the null backend,
+# see CC_USE_NULL_GL in base/ccConfig.h and GLViewNull::runBenchmark()
+ifeq ($(CC_USE_GL_NULL),1)
+LOCAL_SRC_FILES += platform/CCGLNull.cpp \
+platform/CCGLViewNull.cpp
+LOCAL_CFLAGS += -DCC_USE_NULL_GL=1
+LOCAL_EXPORT_CFLAGS += -DCC_USE_NULL_GL=1
+endif
+
 include $(BUILD_STATIC_LIBRARY)
 
 #==============================================================
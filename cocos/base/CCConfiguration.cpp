@@ -43,6 +43,8 @@ Configuration::Configuration()
 , _maxModelviewStackDepth(0)
 , _supportsPVRTC(false)
 , _supportsETC1(false)
+, _supportsETC2(false)
+, _supportsASTC(false)
 //, _supportsS3TC(false)
 //, _supportsATITC(false)
 , _supportsNPOT(false)
@@ -52,6 +54,8 @@ Configuration::Configuration()
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
 , _supportsOESMapBuffer(false)
+, _supportsOESElementIndexUint(false)
+, _supportsInstancedArrays(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -131,6 +135,13 @@ void Configuration::gatherGPUInfo()
     _supportsETC1 = checkForGLExtension("GL_OES_compressed_ETC1_RGB8_texture");
     _valueDict["gl.supports_ETC1"] = Value(_supportsETC1);
 
+    const char* glVersion = (const char*)glGetString(GL_VERSION);
+    _supportsETC2 = (glVersion && strncmp(glVersion, "OpenGL ES 3.", 12) == 0) || checkForGLExtension("GL_ARB_ES3_compatibility");
+    _valueDict["gl.supports_ETC2"] = Value(_supportsETC2);
+
+    _supportsASTC = checkForGLExtension("GL_KHR_texture_compression_astc_ldr");
+    _valueDict["gl.supports_ASTC"] = Value(_supportsASTC);
+
 //    _supportsS3TC = checkForGLExtension("GL_EXT_texture_compression_s3tc");
 //    _valueDict["gl.supports_S3TC"] = Value(_supportsS3TC);
 //
@@ -155,6 +166,19 @@ void Configuration::gatherGPUInfo()
     _supportsOESMapBuffer = checkForGLExtension("GL_OES_mapbuffer");
     _valueDict["gl.supports_OES_map_buffer"] = Value(_supportsOESMapBuffer);
 
+    _supportsOESElementIndexUint = checkForGLExtension("GL_OES_element_index_uint");
+    _valueDict["gl.supports_OES_element_index_uint"] = Value(_supportsOESElementIndexUint);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    // the entry points are looked up at runtime
+    _supportsInstancedArrays = checkForGLExtension("GL_EXT_instanced_arrays") && glDrawArraysInstancedEXT && glVertexAttribDivisorEXT;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+    _supportsInstancedArrays = checkForGLExtension("GL_EXT_instanced_arrays");
+#else
+    _supportsInstancedArrays = checkForGLExtension("GL_ARB_instanced_arrays") && checkForGLExtension("GL_ARB_draw_instanced");
+#endif
+    _valueDict["gl.supports_instanced_arrays"] = Value(_supportsInstancedArrays);
+
     _supportsOESDepth24 = checkForGLExtension("GL_OES_depth24");
     _valueDict["gl.supports_OES_depth24"] = Value(_supportsOESDepth24);
 
@@ -224,6 +248,16 @@ bool Configuration::supportsETC() const
 #endif
 }
 
+bool Configuration::supportsETC2() const
+{
+    return _supportsETC2;
+}
+
+bool Configuration::supportsASTC() const
+{
+    return _supportsASTC;
+}
+
 //bool Configuration::supportsS3TC() const
 //{
 //#ifdef GL_EXT_texture_compression_s3tc
@@ -274,6 +308,21 @@ bool Configuration::supportsMapBuffer() const
 #endif
 }
 
+bool Configuration::supportsElementIndexUint() const
+{
+    // GL_UNSIGNED_INT indices are core in desktop OpenGL, an extension in OpenGL ES 2.0.
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+    return _supportsOESElementIndexUint;
+#else
+    return true;
+#endif
+}
+
+bool Configuration::supportsInstancedArrays() const
+{
+    return _supportsInstancedArrays;
+}
+
 bool Configuration::supportsOESDepth24() const
 {
     return _supportsOESDepth24;
@@ -107,6 +107,20 @@ public:
      */
     bool supportsETC() const;
 
+    /** Whether or not ETC2 Texture Compressed is supported.
+     *
+     * ETC2 is core in OpenGL ES 3.0, desktop GL exposes it through GL_ARB_ES3_compatibility.
+     *
+     * @return Is true if supports ETC2 Texture Compressed.
+     */
+    bool supportsETC2() const;
+
+    /** Whether or not ASTC Texture Compressed (LDR profile) is supported.
+     *
+     * @return Is true if supports ASTC Texture Compressed.
+     */
+    bool supportsASTC() const;
+
     /** Whether or not S3TC Texture Compressed is supported.
      *
      * @return Is true if supports S3TC Texture Compressed.
@@ -163,6 +177,24 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not 32-bit indices (`GL_UNSIGNED_INT`) can be used with glDrawElements().
+     *
+     * On Desktop it returns `true`.
+     * On Mobile it checks for the extension `GL_OES_element_index_uint`
+     *
+     * @return Whether or not `GL_UNSIGNED_INT` indices are supported.
+     */
+    bool supportsElementIndexUint() const;
+
+    /** Whether or not instanced drawing, with per instance vertex attributes, is supported.
+     *
+     * On Desktop it checks for the extensions `GL_ARB_instanced_arrays` and `GL_ARB_draw_instanced`.
+     * On Mobile it checks for the extension `GL_EXT_instanced_arrays`
+     *
+     * @return Whether or not GL::drawArraysInstanced() and GL::vertexAttribDivisor() can be used.
+     */
+    bool supportsInstancedArrays() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -241,6 +273,8 @@ protected:
     GLint           _maxModelviewStackDepth;
     bool            _supportsPVRTC;
     bool            _supportsETC1;
+    bool            _supportsETC2;
+    bool            _supportsASTC;
 //    bool            _supportsS3TC;
 //    bool            _supportsATITC;
     bool            _supportsNPOT;
@@ -248,6 +282,8 @@ protected:
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
     bool            _supportsOESMapBuffer;
+    bool            _supportsOESElementIndexUint;
+    bool            _supportsInstancedArrays;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
     GLint           _maxSamplesAllowed;
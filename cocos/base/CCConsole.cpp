@@ -73,6 +73,8 @@
 #include "2d/CCScene.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCRenderer.h"
+#include "math/MathUtil.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
 NS_CC_BEGIN
@@ -393,6 +395,7 @@ Console::Console()
 , _bindAddress("")
 {
     createCommandAllocator();
+    createCommandCapture();
     createCommandConfig();
     createCommandDebugMsg();
     createCommandDirector();
@@ -400,6 +403,7 @@ Console::Console()
     createCommandFileUtils();
     createCommandFps();
     createCommandHelp();
+    createCommandMath();
     createCommandProjection();
     createCommandResolution();
     createCommandSceneGraph();
@@ -897,6 +901,12 @@ void Console::createCommandAllocator()
         CC_CALLBACK_2(Console::commandAllocator, this)});
 }
 
+void Console::createCommandCapture()
+{
+    addCommand({"capture", "Save the render commands of the next frame into a file of the writable path. Args: [-h | help | filename]",
+        CC_CALLBACK_2(Console::commandCapture, this)});
+}
+
 void Console::createCommandConfig()
 {
     addCommand({"config", "Print the Configuration object. Args: [-h | help | ]",
@@ -951,6 +961,13 @@ void Console::createCommandHelp()
     addCommand({"help", "Print this message. Args: [ ]", CC_CALLBACK_2(Console::commandHelp, this)});
 }
 
+void Console::createCommandMath()
+{
+    addCommand({"math", "math commands, type -h or [math help] to list supported directives"});
+    addSubCommand("math", {"bench", "Time the vertex transform and index rebasing of 20000 vertices, per element and batched.",
+        CC_CALLBACK_2(Console::commandMathSubCommandBench, this)});
+}
+
 void Console::createCommandProjection()
 {
     addCommand({"projection", "Change or print the current projection. Args: [-h | help | 2d | 3d | ]",
@@ -970,15 +987,21 @@ void Console::createCommandResolution()
 
 void Console::createCommandSceneGraph()
 {
-    addCommand({"scenegraph", "Print the scene graph", CC_CALLBACK_2(Console::commandSceneGraph, this)});
+    addCommand({"scenegraph", "Print the scene graph. Args: [-h | help | bench | ]", CC_CALLBACK_2(Console::commandSceneGraph, this)});
+    addSubCommand("scenegraph", {"bench", "Time the z order churn of a node of 5000 children, incremental and full sort.",
+        CC_CALLBACK_2(Console::commandSceneGraphSubCommandBench, this)});
 }
 
 void Console::createCommandTexture()
 {
-    addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | ] ",
+    addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | budget | bench | ] ",
         CC_CALLBACK_2(Console::commandTextures, this)});
     addSubCommand("texture", {"flush", "Purges the dictionary of loaded textures.",
         CC_CALLBACK_2(Console::commandTexturesSubCommandFlush, this)});
+    addSubCommand("texture", {"budget", "Print or set the memory budget of the TextureCache. Args: [MB]",
+        CC_CALLBACK_2(Console::commandTexturesSubCommandBudget, this)});
+    addSubCommand("texture", {"bench", "Time the pixel format conversions of a 2048 x 2048 image, scalar and SIMD.",
+        CC_CALLBACK_2(Console::commandTexturesSubCommandBench, this)});
 }
 
 void Console::createCommandTouch()
@@ -1008,6 +1031,23 @@ void Console::commandAllocator(int fd, const std::string& args)
 {
 }
 
+void Console::commandCapture(int fd, const std::string& args)
+{
+    std::string filename(args);
+    Console::Utility::trim(filename);
+    if (filename.empty())
+    {
+        filename = "frame.ccrc";
+    }
+
+    std::string path = FileUtils::getInstance()->getWritablePath() + filename;
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Director::getInstance()->getRenderer()->captureNextFrame(path);
+    });
+    Console::Utility::mydprintf(fd, "Capturing the next frame into: %s\n", path.c_str());
+}
+
 void Console::commandConfig(int fd, const std::string& args)
 {
     Scheduler *sched = Director::getInstance()->getScheduler();
@@ -1103,6 +1143,15 @@ void Console::commandHelp(int fd, const std::string& args)
     sendHelp(fd, _commands, "\nAvailable commands:\n");
 }
 
+void Console::commandMathSubCommandBench(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", MathUtil::benchmarkVertexTransform(20000, 200).c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandProjection(int fd, const std::string& args)
 {
     auto director = Director::getInstance();
@@ -1190,6 +1239,15 @@ void Console::commandSceneGraph(int fd, const std::string& args)
     sched->performFunctionInCocosThread( std::bind(&Console::printSceneGraphBoot, this, fd) );
 }
 
+void Console::commandSceneGraphSubCommandBench(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Node::benchmarkChildReordering(5000, 200).c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandTextures(int fd, const std::string& args)
 {
     Scheduler *sched = Director::getInstance()->getScheduler();
@@ -1207,6 +1265,38 @@ void Console::commandTexturesSubCommandFlush(int fd, const std::string& args)
     });
 }
 
+void Console::commandTexturesSubCommandBudget(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args,' ');
+    if (argv.size() == 2 && Console::Utility::isFloat(argv[1]))
+    {
+        size_t bytes = (size_t)(utils::atof(argv[1].c_str()) * 1024 * 1024);
+        Scheduler *sched = Director::getInstance()->getScheduler();
+        sched->performFunctionInCocosThread( [=](){
+            Director::getInstance()->getTextureCache()->setMemoryBudget(bytes);
+        });
+        return;
+    }
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto textureCache = Director::getInstance()->getTextureCache();
+        Console::Utility::mydprintf(fd, "TextureCache memory usage: %.2f MB, budget: %.2f MB\n",
+                                    textureCache->getMemoryUsage() / (1024.0f*1024.0f),
+                                    textureCache->getMemoryBudget() / (1024.0f*1024.0f));
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandTexturesSubCommandBench(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Texture2D::benchmarkPixelFormatConversions(2048, 2048).c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandTouchSubCommandTap(int fd, const std::string& args)
 {
     auto argv = Console::Utility::split(args,' ');
@@ -194,6 +194,7 @@ protected:
 
     // create a map of command.
     void createCommandAllocator();
+    void createCommandCapture();
     void createCommandConfig();
     void createCommandDebugMsg();
     void createCommandDirector();
@@ -201,6 +202,7 @@ protected:
     void createCommandFileUtils();
     void createCommandFps();
     void createCommandHelp();
+    void createCommandMath();
     void createCommandProjection();
     void createCommandResolution();
     void createCommandSceneGraph();
@@ -211,6 +213,7 @@ protected:
 
     // Add commands here
     void commandAllocator(int fd, const std::string& args);
+    void commandCapture(int fd, const std::string& args);
     void commandConfig(int fd, const std::string& args);
     void commandDebugMsg(int fd, const std::string& args);
     void commandDebugMsgSubCommandOnOff(int fd, const std::string& args);
@@ -225,14 +228,18 @@ protected:
     void commandFps(int fd, const std::string& args);
     void commandFpsSubCommandOnOff(int fd, const std::string& args);
     void commandHelp(int fd, const std::string& args);
+    void commandMathSubCommandBench(int fd, const std::string& args);
     void commandProjection(int fd, const std::string& args);
     void commandProjectionSubCommand2d(int fd, const std::string& args);
     void commandProjectionSubCommand3d(int fd, const std::string& args);
     void commandResolution(int fd, const std::string& args);
     void commandResolutionSubCommandEmpty(int fd, const std::string& args);
     void commandSceneGraph(int fd, const std::string& args);
+    void commandSceneGraphSubCommandBench(int fd, const std::string& args);
     void commandTextures(int fd, const std::string& args);
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
+    void commandTexturesSubCommandBudget(int fd, const std::string& args);
+    void commandTexturesSubCommandBench(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
     void commandUpload(int fd);
@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
+#include "2d/CCNodePool.h"
+#include "2d/CCTransformHierarchy.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
@@ -1053,6 +1055,9 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
 
+    // release the recycled nodes before the caches they use
+    NodePool::destroyInstance();
+
     // purge bitmap cache
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
@@ -1081,6 +1086,7 @@ void Director::reset()
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    TransformHierarchy::setWorkerThreadCount(0);
     spine::SkeletonBatch::destroyInstance();
     
     // cocos2d-x specific data structures
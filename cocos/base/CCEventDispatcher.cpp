@@ -34,9 +34,13 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCTouchBoundsIndex.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
 
+// The cell size in points of the grid used to filter touches by node bounds
+#define TOUCH_BOUNDS_CELL_SIZE 128.0f
+
 namespace
 {
 
@@ -193,6 +197,7 @@ EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _touchBoundsIndex(nullptr)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -210,6 +215,7 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_touchBoundsIndex);
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -408,10 +414,25 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
 
     listeners->push_back(listener);
+
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+        && static_cast<EventListenerTouchOneByOne*>(listener)->isFilterByNodeBounds())
+    {
+        if (_touchBoundsIndex == nullptr)
+        {
+            _touchBoundsIndex = new (std::nothrow) TouchBoundsIndex(TOUCH_BOUNDS_CELL_SIZE);
+        }
+        _touchBoundsIndex->addListener(static_cast<EventListenerTouchOneByOne*>(listener));
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
 {
+    if (_touchBoundsIndex && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+    {
+        _touchBoundsIndex->removeListener(static_cast<EventListenerTouchOneByOne*>(listener));
+    }
+
     std::vector<EventListener*>* listeners = nullptr;
     auto found = _nodeListenersMap.find(node);
     if (found != _nodeListenersMap.end())
@@ -899,9 +920,14 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
         auto mutableTouchesIter = mutableTouches.begin();
         auto touchesIter = originalTouches.begin();
 
+        // Only the touch listeners whose node bounds contain the touch location are candidates to claim a new touch
+        bool filterByNodeBounds = _touchBoundsIndex && !_touchBoundsIndex->empty()
+            && event->getEventCode() == EventTouch::EventCode::BEGAN;
+
         for (; touchesIter != originalTouches.end(); ++touchesIter)
         {
             bool isSwallowed = false;
+            unsigned int touchBoundsStamp = filterByNodeBounds ? _touchBoundsIndex->markCandidates((*touchesIter)->getLocation()) : 0;
 
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
@@ -919,7 +945,12 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 
                 if (eventCode == EventTouch::EventCode::BEGAN)
                 {
-                    if (listener->onTouchBegan)
+                    if (filterByNodeBounds && listener->_filterByNodeBounds && listener->_node != nullptr
+                        && listener->_touchBoundsStamp != touchBoundsStamp)
+                    {
+                        // The touch began outside of the node bounds.
+                    }
+                    else if (listener->onTouchBegan)
                     {
                         isClaimed = listener->onTouchBegan(*touchesIter, event);
                         if (isClaimed && listener->_isRegistered)
@@ -1468,6 +1499,14 @@ void EventDispatcher::setDirtyForNode(Node* node)
     }
 }
 
+void EventDispatcher::setTouchBoundsDirtyForNode(Node* node)
+{
+    if (_touchBoundsIndex)
+    {
+        _touchBoundsIndex->setDirtyForNode(node);
+    }
+}
+
 void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
 {    
     auto iter = _priorityDirtyFlagMap.find(listenerID);
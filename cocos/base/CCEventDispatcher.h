@@ -48,6 +48,7 @@ class EventTouch;
 class Node;
 class EventCustom;
 class EventListenerCustom;
+class TouchBoundsIndex;
 
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
@@ -210,6 +211,9 @@ protected:
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
 
+    /** The world bounds of a node with touch listeners filtering by node bounds changed. */
+    void setTouchBoundsDirtyForNode(Node* node);
+
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
      */
@@ -337,6 +341,9 @@ protected:
     int _nodePriorityIndex;
 
     std::set<std::string> _internalCustomListenerIDs;
+
+    /** The grid of the touch listeners filtering by node bounds, created with the first of them */
+    TouchBoundsIndex* _touchBoundsIndex;
 };
 
 
@@ -39,6 +39,8 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _filterByNodeBounds(false)
+, _touchBoundsStamp(0)
 {
 }
 
@@ -67,6 +69,17 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setFilterByNodeBounds(bool filter)
+{
+    CCASSERT(!isRegistered(), "The bounds filter can't be changed after the listener was added!");
+    _filterByNodeBounds = filter;
+}
+
+bool EventListenerTouchOneByOne::isFilterByNodeBounds() const
+{
+    return _filterByNodeBounds;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -108,6 +121,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
 
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_filterByNodeBounds = _filterByNodeBounds;
     }
     else
     {
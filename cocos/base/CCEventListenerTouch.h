@@ -68,6 +68,20 @@ public:
      */
     bool isSwallowTouches();
 
+    /** Whether or not to only dispatch the touches which begin inside the bounds of the associated node.
+     * The bounds are the content size of the node transformed to world space, for listeners with scene graph priority only.
+     * The dispatcher skips onTouchBegan for the touches outside of them, using a grid of the node bounds instead of calling every listener.
+     * It should be set before the listener is added to the dispatcher.
+     *
+     * @param filter True if the touches outside of the node bounds don't need to be dispatched.
+     */
+    void setFilterByNodeBounds(bool filter);
+    /** Is filtering touches by node bounds or not.
+     *
+     * @return True if the touches outside of the node bounds aren't dispatched.
+     */
+    bool isFilterByNodeBounds() const;
+
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -90,8 +104,11 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _filterByNodeBounds;
+    unsigned int _touchBoundsStamp;
 
     friend class EventDispatcher;
+    friend class TouchBoundsIndex;
 };
 
 /** @class EventListenerTouchAllAtOnce
@@ -151,6 +151,7 @@ extern void CC_DLL ProfilingResetTimingBlock(const char *timerName);
 extern bool kProfilerCategorySprite;
 extern bool kProfilerCategoryBatchSprite;
 extern bool kProfilerCategoryParticles;
+extern bool kProfilerCategoryRenderer;
 
 // end of global group
 /// @}
@@ -0,0 +1,214 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCTouchBoundsIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/CCEventListenerTouch.h"
+#include "2d/CCNode.h"
+#include "math/CCAffineTransform.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // Bounds spanning more cells than this are kept in a list tested on every query,
+    // so full screen listeners don't fill the whole grid.
+    const int MAX_CELLS_PER_LISTENER = 64;
+    // Keeps the cell coordinates of far away nodes inside the range of cellKey().
+    const float MAX_CELL_COORD = 1 << 20;
+}
+
+TouchBoundsIndex::TouchBoundsIndex(float cellSize)
+: _cellSize(cellSize)
+, _stamp(0)
+{
+    CCASSERT(cellSize > 0, "Invalid cell size!");
+}
+
+TouchBoundsIndex::~TouchBoundsIndex()
+{
+    for (auto& iter : _nodeListeners)
+    {
+        iter.first->_touchBoundsListenerCount = 0;
+    }
+}
+
+void TouchBoundsIndex::addListener(EventListenerTouchOneByOne* listener)
+{
+    Node* node = listener->getAssociatedNode();
+    CCASSERT(node != nullptr, "Only listeners with scene graph priority can be indexed!");
+    CCASSERT(_entries.find(listener) == _entries.end(), "The listener was indexed already!");
+
+    Entry& entry = _entries[listener];
+    entry.listener = listener;
+    entry.binned = false;
+    entry.oversized = false;
+
+    _nodeListeners[node].push_back(listener);
+    ++node->_touchBoundsListenerCount;
+    _dirtyNodes.insert(node);
+}
+
+void TouchBoundsIndex::removeListener(EventListenerTouchOneByOne* listener)
+{
+    auto entryIter = _entries.find(listener);
+    if (entryIter == _entries.end())
+        return;
+
+    unbin(&entryIter->second);
+    _entries.erase(entryIter);
+
+    Node* node = listener->getAssociatedNode();
+    auto nodeIter = _nodeListeners.find(node);
+    if (nodeIter != _nodeListeners.end())
+    {
+        auto& listeners = nodeIter->second;
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+        --node->_touchBoundsListenerCount;
+
+        if (listeners.empty())
+        {
+            _nodeListeners.erase(nodeIter);
+            _dirtyNodes.erase(node);
+        }
+    }
+}
+
+void TouchBoundsIndex::setDirtyForNode(Node* node)
+{
+    _dirtyNodes.insert(node);
+}
+
+unsigned int TouchBoundsIndex::markCandidates(const Vec2& point)
+{
+    updateDirtyNodes();
+
+    // 0 is the stamp of listeners which were never a candidate
+    if (++_stamp == 0)
+        _stamp = 1;
+
+    auto testEntries = [this, &point](const std::vector<Entry*>& entries) {
+        for (auto entry : entries)
+        {
+            if (entry->bounds.containsPoint(point))
+                entry->listener->_touchBoundsStamp = _stamp;
+        }
+    };
+
+    auto cellIter = _cells.find(cellKey(cellCoord(point.x), cellCoord(point.y)));
+    if (cellIter != _cells.end())
+        testEntries(cellIter->second);
+    testEntries(_oversized);
+
+    return _stamp;
+}
+
+void TouchBoundsIndex::updateDirtyNodes()
+{
+    for (auto node : _dirtyNodes)
+    {
+        auto nodeIter = _nodeListeners.find(node);
+        if (nodeIter == _nodeListeners.end())
+            continue;
+
+        const Rect bounds = RectApplyTransform(Rect(Vec2::ZERO, node->getContentSize()), node->getNodeToWorldTransform());
+        for (auto listener : nodeIter->second)
+        {
+            Entry& entry = _entries[listener];
+            unbin(&entry);
+            entry.bounds = bounds;
+            bin(&entry);
+        }
+    }
+    _dirtyNodes.clear();
+}
+
+void TouchBoundsIndex::bin(Entry* entry)
+{
+    const Rect& bounds = entry->bounds;
+    entry->minCellX = cellCoord(bounds.getMinX());
+    entry->minCellY = cellCoord(bounds.getMinY());
+    entry->maxCellX = cellCoord(bounds.getMaxX());
+    entry->maxCellY = cellCoord(bounds.getMaxY());
+    entry->binned = true;
+
+    long long cellCount = (long long)(entry->maxCellX - entry->minCellX + 1) * (entry->maxCellY - entry->minCellY + 1);
+    entry->oversized = cellCount > MAX_CELLS_PER_LISTENER;
+    if (entry->oversized)
+    {
+        _oversized.push_back(entry);
+        return;
+    }
+
+    for (int y = entry->minCellY; y <= entry->maxCellY; ++y)
+    {
+        for (int x = entry->minCellX; x <= entry->maxCellX; ++x)
+        {
+            _cells[cellKey(x, y)].push_back(entry);
+        }
+    }
+}
+
+void TouchBoundsIndex::unbin(Entry* entry)
+{
+    if (!entry->binned)
+        return;
+
+    entry->binned = false;
+    if (entry->oversized)
+    {
+        _oversized.erase(std::find(_oversized.begin(), _oversized.end(), entry));
+        return;
+    }
+
+    for (int y = entry->minCellY; y <= entry->maxCellY; ++y)
+    {
+        for (int x = entry->minCellX; x <= entry->maxCellX; ++x)
+        {
+            auto cellIter = _cells.find(cellKey(x, y));
+            CCASSERT(cellIter != _cells.end(), "The cell of a binned listener is missing!");
+
+            auto& entries = cellIter->second;
+            entries.erase(std::find(entries.begin(), entries.end(), entry));
+            if (entries.empty())
+                _cells.erase(cellIter);
+        }
+    }
+}
+
+int TouchBoundsIndex::cellCoord(float value) const
+{
+    float coord = std::floor(value / _cellSize);
+    return (int)std::max(-MAX_CELL_COORD, std::min(coord, MAX_CELL_COORD));
+}
+
+long long TouchBoundsIndex::cellKey(int x, int y)
+{
+    return ((long long)x << 32) | (unsigned int)y;
+}
+
+NS_CC_END
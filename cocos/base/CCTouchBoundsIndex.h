@@ -0,0 +1,118 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_TOUCH_BOUNDS_INDEX_H__
+#define __CC_TOUCH_BOUNDS_INDEX_H__
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+class EventListenerTouchOneByOne;
+
+/** @class TouchBoundsIndex
+ * @brief A uniform grid of the world bounds of the nodes whose one by one touch listeners filter touches by node bounds.
+ *
+ * EventDispatcher uses it to find the listeners a touch may begin on without calling every onTouchBegan.
+ * The bounds of a node are recomputed lazily, only after the node reported a transform or content size change.
+ * @see EventListenerTouchOneByOne::setFilterByNodeBounds
+ * @js NA
+ */
+class CC_DLL TouchBoundsIndex
+{
+public:
+    /** Constructor.
+     *
+     * @param cellSize The size of a grid cell in points.
+     */
+    explicit TouchBoundsIndex(float cellSize);
+    /** Destructor. */
+    ~TouchBoundsIndex();
+
+    /** Adds a listener with scene graph priority, its node bounds are computed on the next query. */
+    void addListener(EventListenerTouchOneByOne* listener);
+    /** Removes a listener, must be called before the listener is dissociated from its node. */
+    void removeListener(EventListenerTouchOneByOne* listener);
+
+    /** The world transform or content size of the node changed, the bounds of its listeners are recomputed on the next query. */
+    void setDirtyForNode(Node* node);
+
+    /** Stamps every indexed listener whose node bounds contain the point.
+     *
+     * @param point A touch location in world coordinates.
+     * @return The stamp set to the listeners, it's different for every query.
+     */
+    unsigned int markCandidates(const Vec2& point);
+
+    /** Whether there isn't any listener indexed. */
+    bool empty() const { return _entries.empty(); }
+
+private:
+    struct Entry
+    {
+        EventListenerTouchOneByOne* listener;
+        Rect bounds;
+        int minCellX;
+        int minCellY;
+        int maxCellX;
+        int maxCellY;
+        bool binned;
+        bool oversized;
+    };
+
+    void updateDirtyNodes();
+    void bin(Entry* entry);
+    void unbin(Entry* entry);
+    int cellCoord(float value) const;
+    static long long cellKey(int x, int y);
+
+    float _cellSize;
+    unsigned int _stamp;
+
+    std::unordered_map<EventListenerTouchOneByOne*, Entry> _entries;
+    std::unordered_map<Node*, std::vector<EventListenerTouchOneByOne*>> _nodeListeners;
+    std::unordered_set<Node*> _dirtyNodes;
+    /** The listeners of each cell, indexed by cellKey(). */
+    std::unordered_map<long long, std::vector<Entry*>> _cells;
+    /** The listeners covering too many cells to be binned, they are tested on every query. */
+    std::vector<Entry*> _oversized;
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_TOUCH_BOUNDS_INDEX_H__
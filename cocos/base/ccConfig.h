@@ -273,6 +273,20 @@ THE SOFTWARE.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_USE_NULL_GL
+ * If enabled, all the GL calls of the engine are redirected to a null backend (see platform/CCGLNull.h)
+ * that does not need a GL context: it only keeps track of the objects and counts the calls.
+ * Use it together with GLViewNull to run the renderer headless, e.g. to benchmark its CPU cost
+ * with GLViewNull::runBenchmark(). Nothing is drawn when it is enabled.
+ * On Android, build with ndk-build CC_USE_GL_NULL=1: it defines this macro and compiles
+ * platform/CCGLNull.cpp and platform/CCGLViewNull.cpp, which the default project files leave out.
+ *
+ * To enable set it to a value different than 0. Disabled by default.
+ */
+#ifndef CC_USE_NULL_GL
+#define CC_USE_NULL_GL 0
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
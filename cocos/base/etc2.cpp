@@ -0,0 +1,286 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/etc2.h"
+
+#include <string.h>
+
+/* ETC2 is a superset of ETC1, see the OpenGL ES 3.0 specification, appendix C.1.
+
+ A differential block whose red, green or blue component overflows the 5 bit
+ range when the delta is applied selects one of the new modes:
+
+ T mode (red overflows)
+
+ 63 62 61 60 59 58 57 56 55 54 53 52 51 50 49 48
+ -----------------------------------------------
+ | -  -  - | R1a | - | R1b | G1 (4bits)| B1 (4bits)|
+ -----------------------------------------------
+
+ 47 46 45 44 43 42 41 40 39 38 37 36 35 34  33  32
+ ---------------------------------------------------
+ | R2 (4bits)| G2 (4bits)| B2 (4bits)| da  |diff| db |
+ ---------------------------------------------------
+
+ H mode (green overflows)
+
+ 63 62 61 60 59 58 57 56 55 54 53 52 51 50 49 48 47
+ --------------------------------------------------
+ | -| R1 (4bits)| G1a   | -  -  - |G1b|B1a| -| B1b |
+ --------------------------------------------------
+
+ 46 45 44 43 42 41 40 39 38 37 36 35 34  33  32
+ ------------------------------------------------
+ | R2 (4bits)| G2 (4bits)| B2 (4bits)|da|diff|db|
+ ------------------------------------------------
+
+ Planar mode (blue overflows): three 6:7:6 colors O, H and V
+
+ RO 62..57, GO 56 + 54..49, BO 48 + 44..43 + 41..39, RH 38..34 + 32,
+ GH 31..25, BH 24..19, RV 18..13, GV 12..6, BV 5..0
+
+ T and H blocks use the two bit pixel index (msb << 1 | lsb) to pick one of
+ four paint colors, planar blocks interpolate the three colors.
+
+ EAC alpha blocks store an 8 bit base codeword, a 4 bit multiplier, a 4 bit
+ modifier table index and sixteen 3 bit pixel indices, pixel a first.
+ */
+
+static const int kDistanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const int kAlphaModifierTable[16][8] = {
+    { -3, -6,  -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 },
+    { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 },
+    { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 },
+    { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 },
+    { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 },
+    { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 },
+    { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+    { -3, -5,  -7,  -9, 2, 4, 6,  8 } };
+
+static const int kLookup[8] = { 0, 1, 2, 3, -4, -3, -2, -1 };
+
+static inline etc1_byte clamp(int x) {
+    return (etc1_byte) (x >= 0 ? (x < 255 ? x : 255) : 0);
+}
+
+static
+inline int convert4To8(int b) {
+    int c = b & 0xf;
+    return (c << 4) | c;
+}
+
+static
+inline int convert6To8(int b) {
+    int c = b & 0x3f;
+    return (c << 2) | (c >> 4);
+}
+
+static
+inline int convert7To8(int b) {
+    int c = b & 0x7f;
+    return (c << 1) | (c >> 6);
+}
+
+static
+void decode_paint_colors(etc1_byte* pOut, const int paint[4][3], etc1_uint32 low) {
+    for (int k = 0; k < 16; k++) {
+        int x = k >> 2;
+        int y = k & 3;
+        int index = ((low >> k) & 1) | ((low >> (k + 15)) & 2);
+        etc1_byte* q = pOut + 3 * (x + 4 * y);
+        *q++ = clamp(paint[index][0]);
+        *q++ = clamp(paint[index][1]);
+        *q++ = clamp(paint[index][2]);
+    }
+}
+
+static
+void decode_t_block(etc1_uint32 high, etc1_uint32 low, etc1_byte* pOut) {
+    int r1 = convert4To8(((high >> 25) & 0xc) | ((high >> 24) & 0x3));
+    int g1 = convert4To8(high >> 20);
+    int b1 = convert4To8(high >> 16);
+    int r2 = convert4To8(high >> 12);
+    int g2 = convert4To8(high >> 8);
+    int b2 = convert4To8(high >> 4);
+    int d = kDistanceTable[((high >> 1) & 6) | (high & 1)];
+    const int paint[4][3] = {
+        { r1, g1, b1 },
+        { r2 + d, g2 + d, b2 + d },
+        { r2, g2, b2 },
+        { r2 - d, g2 - d, b2 - d } };
+    decode_paint_colors(pOut, paint, low);
+}
+
+static
+void decode_h_block(etc1_uint32 high, etc1_uint32 low, etc1_byte* pOut) {
+    int r1 = (high >> 27) & 0xf;
+    int g1 = ((high >> 23) & 0xe) | ((high >> 20) & 1);
+    int b1 = ((high >> 16) & 0x8) | ((high >> 15) & 0x7);
+    int r2 = (high >> 11) & 0xf;
+    int g2 = (high >> 7) & 0xf;
+    int b2 = (high >> 3) & 0xf;
+    // The lowest distance bit is implied by the ordering of the base colors.
+    int ordering = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+    int d = kDistanceTable[(high & 4) | ((high & 1) << 1) | ordering];
+    r1 = convert4To8(r1);
+    g1 = convert4To8(g1);
+    b1 = convert4To8(b1);
+    r2 = convert4To8(r2);
+    g2 = convert4To8(g2);
+    b2 = convert4To8(b2);
+    const int paint[4][3] = {
+        { r1 + d, g1 + d, b1 + d },
+        { r1 - d, g1 - d, b1 - d },
+        { r2 + d, g2 + d, b2 + d },
+        { r2 - d, g2 - d, b2 - d } };
+    decode_paint_colors(pOut, paint, low);
+}
+
+static
+void decode_planar_block(etc1_uint32 high, etc1_uint32 low, etc1_byte* pOut) {
+    int ro = convert6To8(high >> 25);
+    int go = convert7To8(((high >> 18) & 0x40) | ((high >> 17) & 0x3f));
+    int bo = convert6To8(((high >> 11) & 0x20) | ((high >> 8) & 0x18) | ((high >> 7) & 0x7));
+    int rh = convert6To8(((high >> 1) & 0x3e) | (high & 1));
+    int gh = convert7To8(low >> 25);
+    int bh = convert6To8(low >> 19);
+    int rv = convert6To8(low >> 13);
+    int gv = convert7To8(low >> 6);
+    int bv = convert6To8(low);
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            etc1_byte* q = pOut + 3 * (x + 4 * y);
+            *q++ = clamp((x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2);
+            *q++ = clamp((x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2);
+            *q++ = clamp((x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2);
+        }
+    }
+}
+
+// Input is an ETC2 RGB8 compressed version of the data.
+// Output is a 4 x 4 square of 3-byte pixels in form R, G, B
+
+void etc2_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
+    etc1_uint32 high = (pIn[0] << 24) | (pIn[1] << 16) | (pIn[2] << 8) | pIn[3];
+    etc1_uint32 low = (pIn[4] << 24) | (pIn[5] << 16) | (pIn[6] << 8) | pIn[7];
+    if (high & 2) {
+        int r = (int) ((high >> 27) & 0x1f) + kLookup[(high >> 24) & 7];
+        int g = (int) ((high >> 19) & 0x1f) + kLookup[(high >> 16) & 7];
+        int b = (int) ((high >> 11) & 0x1f) + kLookup[(high >> 8) & 7];
+        if (r < 0 || r > 31) {
+            decode_t_block(high, low, pOut);
+            return;
+        }
+        if (g < 0 || g > 31) {
+            decode_h_block(high, low, pOut);
+            return;
+        }
+        if (b < 0 || b > 31) {
+            decode_planar_block(high, low, pOut);
+            return;
+        }
+    }
+    etc1_decode_block(pIn, pOut);
+}
+
+void etc2_decode_alpha_block(const etc1_byte* pIn, etc1_byte* pOut) {
+    int base = pIn[0];
+    int multiplier = pIn[1] >> 4;
+    const int* table = kAlphaModifierTable[pIn[1] & 0xf];
+    etc1_uint32 high = (pIn[2] << 24) | (pIn[3] << 16) | (pIn[4] << 8) | pIn[5];
+    etc1_uint32 low = (pIn[6] << 8) | pIn[7];
+    for (int k = 0; k < 16; k++) {
+        // 48 index bits, pixel a in the most significant three.
+        int shift = 45 - 3 * k;
+        int index = shift >= 16 ? (high >> (shift - 16)) & 7
+                : ((high << (16 - shift)) | (low >> shift)) & 7;
+        int x = k >> 2;
+        int y = k & 3;
+        pOut[x + 4 * y] = clamp(base + table[index] * multiplier);
+    }
+}
+
+etc1_uint32 etc2_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height, etc1_bool hasAlpha) {
+    etc1_uint32 blockSize = hasAlpha ? ETC2_RGBA_ENCODED_BLOCK_SIZE : ETC2_RGB_ENCODED_BLOCK_SIZE;
+    return ((width + 3) >> 2) * ((height + 3) >> 2) * blockSize;
+}
+
+int etc2_decode_image(const etc1_byte* pIn, etc1_bool hasAlpha, etc1_byte* pOut,
+        etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride) {
+    if (pixelSize < 3 || pixelSize > 4 || (hasAlpha && pixelSize != 4)) {
+        return -1;
+    }
+    etc1_byte block[ETC1_DECODED_BLOCK_SIZE];
+    etc1_byte alpha[16];
+
+    etc1_uint32 encodedWidth = (width + 3) & ~3;
+    etc1_uint32 encodedHeight = (height + 3) & ~3;
+
+    for (etc1_uint32 y = 0; y < encodedHeight; y += 4) {
+        etc1_uint32 yEnd = height - y;
+        if (yEnd > 4) {
+            yEnd = 4;
+        }
+        for (etc1_uint32 x = 0; x < encodedWidth; x += 4) {
+            etc1_uint32 xEnd = width - x;
+            if (xEnd > 4) {
+                xEnd = 4;
+            }
+            if (hasAlpha) {
+                etc2_decode_alpha_block(pIn, alpha);
+                pIn += ETC2_RGB_ENCODED_BLOCK_SIZE;
+            } else {
+                memset(alpha, 0xff, sizeof(alpha));
+            }
+            etc2_decode_block(pIn, block);
+            pIn += ETC2_RGB_ENCODED_BLOCK_SIZE;
+            for (etc1_uint32 cy = 0; cy < yEnd; cy++) {
+                const etc1_byte* q = block + (cy * 4) * 3;
+                etc1_byte* p = pOut + pixelSize * x + stride * (y + cy);
+                if (pixelSize == 3) {
+                    memcpy(p, q, xEnd * 3);
+                } else {
+                    const etc1_byte* a = alpha + cy * 4;
+                    for (etc1_uint32 cx = 0; cx < xEnd; cx++) {
+                        *p++ = *q++;
+                        *p++ = *q++;
+                        *p++ = *q++;
+                        *p++ = *a++;
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __etc2_h__
+#define __etc2_h__
+/// @cond DO_NOT_SHOW
+
+#include "base/etc1.h"
+
+#define ETC2_RGB_ENCODED_BLOCK_SIZE 8
+#define ETC2_RGBA_ENCODED_BLOCK_SIZE 16
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Decode a block of ETC2 RGB8 pixels.
+//
+// pIn is an ETC2 RGB8 compressed block (8 bytes). Individual and differential
+// blocks decode exactly like ETC1, T, H and planar blocks use the ETC2 modes.
+//
+// pOut is a pointer to a ETC1_DECODED_BLOCK_SIZE array of bytes that represent a
+// 4 x 4 square of 3-byte pixels in form R, G, B. Byte (3 * (x + 4 * y) is the R
+// value of pixel (x, y).
+
+void etc2_decode_block(const etc1_byte* pIn, etc1_byte* pOut);
+
+// Decode a block of EAC alpha values.
+//
+// pIn is the 8 byte alpha half of an ETC2 RGBA8 (ETC2_EAC) block.
+//
+// pOut is a pointer to a 16 byte array, byte (x + 4 * y) is the alpha value
+// of pixel (x, y).
+
+void etc2_decode_alpha_block(const etc1_byte* pIn, etc1_byte* pOut);
+
+// Return the size of the encoded image data.
+
+etc1_uint32 etc2_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height, etc1_bool hasAlpha);
+
+// Decode an entire image.
+// pIn - pointer to encoded data, ETC2 RGB8 blocks or ETC2 RGBA8 blocks if hasAlpha is set.
+// pOut - pointer to the image data. Will be written such that
+//        pixel (x,y) is at pIn + pixelSize * x + stride * y. Must be
+//        large enough to store entire image.
+// pixelSize can be 3 or 4. 3 is a GL_BYTE RGB image, 4 is a GL_BYTE RGBA image,
+// which is the only valid size if hasAlpha is set.
+// returns non-zero if there is an error.
+
+int etc2_decode_image(const etc1_byte* pIn, etc1_bool hasAlpha, etc1_byte* pOut,
+        etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+/// @endcond
+#endif
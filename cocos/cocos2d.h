@@ -121,6 +121,7 @@ THE SOFTWARE.
 #include "2d/CCMotionStreak.h"
 #include "2d/CCNode.h"
 #include "2d/CCNodeGrid.h"
+#include "2d/CCNodePool.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystem.h"
@@ -142,6 +143,8 @@ THE SOFTWARE.
 
 // renderer
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCDynamicAtlas.h"
+#include "renderer/CCFrameAllocator.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
@@ -162,6 +165,7 @@ THE SOFTWARE.
 
 // platform
 #include "platform/CCCommon.h"
+#include "platform/CCDecodedImageCache.h"
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCImage.h"
@@ -210,6 +210,8 @@ void DBCCSprite::draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transfor
 
 cocos2d::PolygonInfo& DBCCSprite::getPolygonInfoModify()
 {
+    // the vertices are moved through the returned reference
+    _trianglesCommand.setGeometryDirty();
     return this->_polyInfo;
 }
 
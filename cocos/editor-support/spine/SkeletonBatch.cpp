@@ -33,7 +33,6 @@
 #include <algorithm>
 
 USING_NS_CC;
-#define EVENT_AFTER_DRAW_RESET_POSITION "director_after_draw"
 using std::max;
 
 namespace spine {
@@ -52,66 +51,20 @@ namespace spine {
         }
     }
 
-    SkeletonBatch::SkeletonBatch ()
-    {
-        _firstCommand = new Command();
-        _command = _firstCommand;
-
-        Director::getInstance()->getEventDispatcher()->addCustomEventListener(EVENT_AFTER_DRAW_RESET_POSITION, [this](EventCustom* eventCustom){
-            this->update(0);
-        });;
-    }
-
-    SkeletonBatch::~SkeletonBatch () {
-        Director::getInstance()->getEventDispatcher()->removeCustomEventListeners(EVENT_AFTER_DRAW_RESET_POSITION);
-
-        Command* command = _firstCommand;
-        while (command) {
-            Command* next = command->next;
-            delete command;
-            command = next;
-        }
-    }
-
-    void SkeletonBatch::update (float delta) {
-        _command = _firstCommand;
-    }
-
     void SkeletonBatch::addCommand (cocos2d::Renderer* renderer, float globalZOrder, GLuint textureID, GLProgramState* glProgramState,
                                     BlendFunc blendFunc, const TrianglesCommand::Triangles& triangles, const Mat4& transform, uint32_t transformFlags
                                     ) {
-        if (_command->triangles->verts) {
-            free(_command->triangles->verts);
-            _command->triangles->verts = NULL;
-        }
-        
-        _command->triangles->verts = (V3F_C4B_T2F *)malloc(sizeof(V3F_C4B_T2F) * triangles.vertCount);
-        memcpy(_command->triangles->verts, triangles.verts, sizeof(V3F_C4B_T2F) * triangles.vertCount);
-        
-        _command->triangles->vertCount = triangles.vertCount;
-        _command->triangles->indexCount = triangles.indexCount;
-        _command->triangles->indices = triangles.indices;
-        
-        _command->trianglesCommand->init(globalZOrder, textureID, glProgramState, blendFunc, *_command->triangles, transform, transformFlags);
-        renderer->addCommand(_command->trianglesCommand);
-        
-        if (!_command->next) _command->next = new Command();
-        _command = _command->next;
-    }
+        // The attachment vertices are reused by the next slot showing the same attachment, so the command gets a copy.
+        // Both live in the renderer's frame allocator until the frame is drawn.
+        FrameAllocator* allocator = renderer->getFrameAllocator();
 
-    SkeletonBatch::Command::Command () :
-    next(nullptr)
-    {
-        trianglesCommand = new TrianglesCommand();
-        triangles = new TrianglesCommand::Triangles();
-    }
+        TrianglesCommand::Triangles copy = triangles;
+        copy.verts = allocator->allocateArray<V3F_C4B_T2F>(triangles.vertCount);
+        memcpy(copy.verts, triangles.verts, sizeof(V3F_C4B_T2F) * triangles.vertCount);
 
-    SkeletonBatch::Command::~Command () {
-        if (triangles->verts) {
-            free(triangles->verts);
-        }
-        delete triangles;
-        delete trianglesCommand;
+        TrianglesCommand* command = allocator->newObject<TrianglesCommand>();
+        command->init(globalZOrder, textureID, glProgramState, blendFunc, copy, transform, transformFlags);
+        renderer->addCommand(command);
     }
 
 }
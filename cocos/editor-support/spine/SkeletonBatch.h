@@ -42,27 +42,8 @@ namespace spine {
         
         static void destroyInstance ();
         
-        void update (float delta);
-        
         void addCommand (cocos2d::Renderer* renderer, float globalOrder, GLuint textureID, cocos2d::GLProgramState* glProgramState,
                          cocos2d::BlendFunc blendType, const cocos2d::TrianglesCommand:: Triangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
-        
-    protected:
-        SkeletonBatch ();
-        virtual ~SkeletonBatch ();
-        
-        class Command {
-        public:
-            Command ();
-            virtual ~Command ();
-            
-            cocos2d::TrianglesCommand* trianglesCommand;
-            cocos2d::TrianglesCommand::Triangles* triangles;
-            Command* next;
-        };
-        
-        Command* _firstCommand;
-        Command* _command;
     };
     
 }
@@ -20,6 +20,11 @@ This file was modified to fit the cocos2d-x project
 
 #include "math/MathUtil.h"
 #include "base/ccMacros.h"
+#include "base/ccTypes.h"
+#include "base/ccUTF8.h"
+
+#include <chrono>
+#include <vector>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include <cpu-features.h>
@@ -275,4 +280,130 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVertices(m, src, dst, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVertices(m, src, dst, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVertices(m, src, dst, count);
+    else MathUtilC::transformVertices(m, src, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformVertices(m, src, dst, count);
+#else
+    MathUtilC::transformVertices(m, src, dst, count);
+#endif
+}
+
+void MathUtil::transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformIndices(src, dst, count, offset);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformIndices(src, dst, count, offset);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformIndices(src, dst, count, offset);
+    else MathUtilC::transformIndices(src, dst, count, offset);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformIndices(src, dst, count, offset);
+#else
+    MathUtilC::transformIndices(src, dst, count, offset);
+#endif
+}
+
+void MathUtil::transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformIndices(src, dst, count, offset);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformIndices(src, dst, count, offset);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformIndices(src, dst, count, offset);
+    else MathUtilC::transformIndices(src, dst, count, offset);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformIndices(src, dst, count, offset);
+#else
+    MathUtilC::transformIndices(src, dst, count, offset);
+#endif
+}
+
+std::string MathUtil::benchmarkVertexTransform(int vertexCount, int iterations)
+{
+    // sprite-like vertices, 4 per quad with 6 indices, under a rotated and scaled model view
+    std::vector<V3F_C4B_T2F> vertices(vertexCount);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        vertices[i].vertices.set((float)(rand() % 2048), (float)(rand() % 2048), 0.0f);
+        vertices[i].colors = Color4B(rand() & 0xFF, rand() & 0xFF, rand() & 0xFF, 0xFF);
+        vertices[i].texCoords = Tex2F((rand() % 1024) / 1024.0f, (rand() % 1024) / 1024.0f);
+    }
+    const int indexCount = vertexCount / 4 * 6;
+    std::vector<unsigned short> indices(indexCount);
+    static const unsigned short quadIndices[6] = { 0, 1, 2, 3, 2, 1 };
+    for (int i = 0; i < indexCount; ++i)
+    {
+        indices[i] = (unsigned short)(i / 6 * 4 + quadIndices[i % 6]);
+    }
+
+    Mat4 modelView;
+    Mat4::createRotationZ(0.3f, &modelView);
+    modelView.scale(1.5f);
+    modelView.translate(100.0f, 50.0f, 0.0f);
+
+    std::vector<V3F_C4B_T2F> outVertices[2] = { vertices, vertices };
+    std::vector<unsigned int> outIndices[2] = { std::vector<unsigned int>(indexCount), std::vector<unsigned int>(indexCount) };
+    const unsigned int indexOffset = 1000;
+
+    float milliseconds[2][2] = { { 0, 0 }, { 0, 0 } };
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        // per vertex and per index, as Renderer::fillVerticesAndIndices() used to
+        auto start = std::chrono::steady_clock::now();
+        memcpy((float*)outVertices[0].data(), (const float*)vertices.data(), sizeof(V3F_C4B_T2F) * vertexCount);
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            modelView.transformPoint(&outVertices[0][i].vertices);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < indexCount; ++i)
+        {
+            outIndices[0][i] = indices[i] + indexOffset;
+        }
+        auto end = std::chrono::steady_clock::now();
+        milliseconds[0][0] += std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(middle - start).count();
+        milliseconds[1][0] += std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end - middle).count();
+
+        start = std::chrono::steady_clock::now();
+        transformVertices(modelView.m, vertices.data(), outVertices[1].data(), vertexCount);
+        middle = std::chrono::steady_clock::now();
+        transformIndices(indices.data(), outIndices[1].data(), indexCount, indexOffset);
+        end = std::chrono::steady_clock::now();
+        milliseconds[0][1] += std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(middle - start).count();
+        milliseconds[1][1] += std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end - middle).count();
+    }
+
+    // NEON may fuse the multiply-adds, so positions are compared with a tolerance
+    bool sameVertices = true;
+    for (int i = 0; i < vertexCount && sameVertices; ++i)
+    {
+        const V3F_C4B_T2F& a = outVertices[0][i];
+        const V3F_C4B_T2F& b = outVertices[1][i];
+        sameVertices = fabsf(a.vertices.x - b.vertices.x) < 0.01f && fabsf(a.vertices.y - b.vertices.y) < 0.01f
+                    && fabsf(a.vertices.z - b.vertices.z) < 0.01f && a.colors == b.colors
+                    && a.texCoords.u == b.texCoords.u && a.texCoords.v == b.texCoords.v;
+    }
+    bool sameIndices = outIndices[0] == outIndices[1];
+
+    std::string report = StringUtils::format("Transforming %d vertices and rebasing %d indices over %d iterations, per element / batched:\n",
+                                             vertexCount, indexCount, iterations);
+    report += StringUtils::format("vertices %8.1f / %8.1f Mverts/s%s\n",
+                                  vertexCount * (float)iterations / (milliseconds[0][0] * 1000.0f),
+                                  vertexCount * (float)iterations / (milliseconds[0][1] * 1000.0f), sameVertices ? "" : "  MISMATCH");
+    report += StringUtils::format("indices  %8.1f / %8.1f Mindices/s%s\n",
+                                  indexCount * (float)iterations / (milliseconds[1][0] * 1000.0f),
+                                  indexCount * (float)iterations / (milliseconds[1][1] * 1000.0f), sameIndices ? "" : "  MISMATCH");
+    return report;
+}
+
 NS_CC_MATH_END
@@ -26,6 +26,8 @@
 #include <xmmintrin.h>
 #endif
 
+#include <string>
+
 #include "math/CCMathBase.h"
 
 /**
@@ -35,6 +37,8 @@
 
 NS_CC_MATH_BEGIN
 
+struct V3F_C4B_T2F;
+
 /**
  * Defines a math utility class.
  *
@@ -87,6 +91,48 @@ public:
      * @return interpolated float value
      */
     static float lerp(float from, float to, float alpha);
+
+    /**
+     * Transforms the positions of a span of vertices by the given matrix (w is
+     * assumed to be 1). Colors and texture coordinates are copied unchanged.
+     * src and dst may point to the same vertices.
+     *
+     * @param m the column-major 4x4 matrix.
+     * @param src the source vertices.
+     * @param dst the destination vertices.
+     * @param count the number of vertices.
+     */
+    static void transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+
+    /**
+     * Copies a span of indices and adds offset to each of them.
+     *
+     * @param src the source indices.
+     * @param dst the destination indices.
+     * @param count the number of indices.
+     * @param offset the value added to every index.
+     */
+    static void transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+
+    /**
+     * Copies a span of 16-bit indices into 32-bit indices and adds offset to each of them.
+     *
+     * @param src the source indices.
+     * @param dst the destination indices.
+     * @param count the number of indices.
+     * @param offset the value added to every index.
+     */
+    static void transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset);
+
+    /**
+     * Times transformVertices() and transformIndices() over iterations passes of vertexCount sprite vertices
+     * against the former per vertex loop of Mat4::transformPoint() and per index additions, and checks they
+     * give the same results. Returns one line per kernel, in millions of vertices or indices per second.
+     * Used by the console command "math bench".
+     * @js NA
+     * @lua NA
+     */
+    static std::string benchmarkVertexTransform(int vertexCount, int iterations);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -42,6 +42,11 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+
+    inline static void transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+    inline static void transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +220,38 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+    if (dst != src)
+        memcpy((float*)dst, (const float*)src, sizeof(V3F_C4B_T2F) * count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vec3& v = dst[i].vertices;
+        float x = v.x * m[0] + v.y * m[4] + v.z * m[8] + m[12];
+        float y = v.x * m[1] + v.y * m[5] + v.z * m[9] + m[13];
+        float z = v.x * m[2] + v.y * m[6] + v.z * m[10] + m[14];
+
+        v.x = x;
+        v.y = y;
+        v.z = z;
+    }
+}
+
+inline void MathUtilC::transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilC::transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 NS_CC_MATH_END
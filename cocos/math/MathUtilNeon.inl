@@ -17,6 +17,8 @@
 
  This file was modified to fit the cocos2d-x project
  */
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -41,6 +43,11 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+
+    inline static void transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+    inline static void transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -268,4 +275,58 @@ inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst
                  );
 }
 
+inline void MathUtilNeon::transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+    if (dst != src)
+        memcpy((float*)dst, (const float*)src, sizeof(V3F_C4B_T2F) * count);
+
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col2 = vld1q_f32(m + 8);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float* v = &dst[i].vertices.x;
+        float32x4_t r = vmulq_n_f32(col0, v[0]);
+        r = vmlaq_n_f32(r, col1, v[1]);
+        r = vmlaq_n_f32(r, col2, v[2]);
+        r = vaddq_f32(r, col3);
+
+        // store x, y, z only: w would overwrite the vertex color
+        vst1_f32(v, vget_low_f32(r));
+        vst1q_lane_f32(v + 2, r, 2);
+    }
+}
+
+inline void MathUtilNeon::transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    const uint16x8_t o = vdupq_n_u16(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), o));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilNeon::transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset)
+{
+    const uint32x4_t o = vdupq_n_u32(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const uint16x8_t v = vld1q_u16(src + i);
+        vst1q_u32(dst + i, vaddw_u16(o, vget_low_u16(v)));
+        vst1q_u32(dst + i + 4, vaddw_u16(o, vget_high_u16(v)));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 NS_CC_MATH_END
@@ -1,3 +1,7 @@
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
 #ifdef __SSE__
@@ -151,6 +155,76 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+class MathUtilSSE
+{
+public:
+    inline static void transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+
+    inline static void transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+    inline static void transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset);
+};
+
+inline void MathUtilSSE::transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+    if (dst != src)
+        memcpy((float*)dst, (const float*)src, sizeof(V3F_C4B_T2F) * count);
+
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float* v = &dst[i].vertices.x;
+        // same evaluation order as MathUtilC, so results are bit-exact
+        __m128 r = _mm_mul_ps(col0, _mm_load1_ps(v));
+        r = _mm_add_ps(r, _mm_mul_ps(col1, _mm_load1_ps(v + 1)));
+        r = _mm_add_ps(r, _mm_mul_ps(col2, _mm_load1_ps(v + 2)));
+        r = _mm_add_ps(r, col3);
+
+        // store x, y, z only: w would overwrite the vertex color
+        _mm_storel_pi((__m64*)v, r);
+        _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+    }
+}
+
+inline void MathUtilSSE::transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i o = _mm_set1_epi16((short)offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi16(v, o));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilSSE::transformIndices(const unsigned short* src, unsigned int* dst, size_t count, unsigned int offset)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i o = _mm_set1_epi32((int)offset);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi32(_mm_unpacklo_epi16(v, zero), o));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_add_epi32(_mm_unpackhi_epi16(v, zero), o));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 #endif
 
 
@@ -0,0 +1,289 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCDecodedImageCache.h"
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <thread>
+
+#include "platform/CCImage.h"
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+#include "base/ccUTF8.h"
+#include "xxhash/xxhash.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+#include "platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    static const char DECODED_IMAGE_MAGIC[4] = { 'C', 'C', 'D', 'I' };
+    // bump it whenever the layout of the entries or the decoders' output change
+    static const uint32_t DECODED_IMAGE_VERSION = 4;
+
+    enum DecodedImageFlag
+    {
+        PREMULTIPLIED_ALPHA = 1,
+        // whether PNG files were premultiplied when the entry was made
+        PNG_PREMULTIPLIED_ALPHA_ENABLED = 2,
+    };
+
+    // followed by the path of the file and the pixels
+    struct DecodedImageHeader
+    {
+        char magic[4];
+        uint32_t version;
+        int64_t sourceSize;
+        // the modification time of the file, or of the APK holding it
+        int64_t sourceStamp;
+        uint32_t pathLength;
+        uint32_t flags;
+        int32_t width;
+        int32_t height;
+        int32_t renderFormat;
+        int32_t fileType;
+        // the format the image was asked for, see Image::initWithImageFile(path, format)
+        int32_t targetFormat;
+        uint64_t dataLength;
+    };
+}
+
+DecodedImageCache* DecodedImageCache::getInstance()
+{
+    // the loading threads of TextureCache may ask for it first
+    static DecodedImageCache s_sharedDecodedImageCache;
+    return &s_sharedDecodedImageCache;
+}
+
+DecodedImageCache::DecodedImageCache()
+: _enabled(false)
+, _cachePathCreated(false)
+{
+}
+
+void DecodedImageCache::setCachePath(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_pathMutex);
+    _cachePath = path;
+    if (!_cachePath.empty() && _cachePath.back() != '/')
+    {
+        _cachePath += '/';
+    }
+    _cachePathCreated = false;
+}
+
+std::string DecodedImageCache::getCachePath() const
+{
+    std::lock_guard<std::mutex> lock(_pathMutex);
+    if (_cachePath.empty())
+    {
+        _cachePath = FileUtils::getInstance()->getWritablePath() + "decoded_images/";
+    }
+    return _cachePath;
+}
+
+void DecodedImageCache::removeAll()
+{
+    std::string cachePath = getCachePath();
+    FileUtils::getInstance()->removeDirectory(cachePath);
+
+    std::lock_guard<std::mutex> lock(_pathMutex);
+    _cachePathCreated = false;
+}
+
+bool DecodedImageCache::getSourceKey(const std::string& fullPath, int64_t* size, int64_t* stamp) const
+{
+    if (fullPath.empty())
+    {
+        return false;
+    }
+
+    long fileSize = FileUtils::getInstance()->getFileSize(fullPath);
+    if (fileSize <= 0)
+    {
+        return false;
+    }
+    *size = fileSize;
+
+    struct stat info;
+    if (stat(FileUtils::getInstance()->getSuitableFOpen(fullPath).c_str(), &info) == 0)
+    {
+        *stamp = (int64_t)info.st_mtime;
+        return true;
+    }
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    // Assets inside the APK can't be stat()ed. An app update may change them without changing their size,
+    // but it replaces the APK, so the entries of packaged files follow the modification time of the APK.
+    if (stat(getApkPath(), &info) == 0)
+    {
+        *stamp = (int64_t)info.st_mtime;
+        return true;
+    }
+#endif
+    return false;
+}
+
+std::string DecodedImageCache::getEntryPath(const std::string& cachePath, const std::string& fullPath) const
+{
+    // the path is stored in the entry too, colliding hashes just miss
+    return cachePath + StringUtils::format("%08x.img", XXH32(fullPath.c_str(), (int)fullPath.length(), 0));
+}
+
+bool DecodedImageCache::loadImage(const std::string& fullPath, Texture2D::PixelFormat targetFormat, Image* image)
+{
+    int64_t sourceSize = 0;
+    int64_t sourceStamp = 0;
+    if (!_enabled || !getSourceKey(fullPath, &sourceSize, &sourceStamp))
+    {
+        return false;
+    }
+
+    FileUtils* fileUtils = FileUtils::getInstance();
+    std::string entryPath = getEntryPath(getCachePath(), fullPath);
+    if (!fileUtils->isFileExist(entryPath))
+    {
+        return false;
+    }
+
+    Data data = fileUtils->getDataFromFile(entryPath);
+    if (data.getSize() < (ssize_t)sizeof(DecodedImageHeader))
+    {
+        return false;
+    }
+
+    DecodedImageHeader header;
+    memcpy(&header, data.getBytes(), sizeof(header));
+    uint32_t expectedFlags = Image::PNG_PREMULTIPLIED_ALPHA_ENABLED ? PNG_PREMULTIPLIED_ALPHA_ENABLED : 0;
+    if (memcmp(header.magic, DECODED_IMAGE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != DECODED_IMAGE_VERSION
+        || header.sourceSize != sourceSize
+        || header.sourceStamp != sourceStamp
+        || (header.flags & PNG_PREMULTIPLIED_ALPHA_ENABLED) != expectedFlags
+        || header.targetFormat != (int32_t)targetFormat
+        || header.pathLength != fullPath.length()
+        || header.dataLength != (uint64_t)(data.getSize() - sizeof(header) - header.pathLength)
+        || memcmp(data.getBytes() + sizeof(header), fullPath.c_str(), header.pathLength) != 0)
+    {
+        CCLOG("cocos2d: DecodedImageCache: dropping the outdated entry of %s", fullPath.c_str());
+        fileUtils->removeFile(entryPath);
+        return false;
+    }
+
+    auto formatInfo = Texture2D::getPixelFormatInfoMap().find((Texture2D::PixelFormat)header.renderFormat);
+    if (formatInfo == Texture2D::getPixelFormatInfoMap().end() || formatInfo->second.compressed
+        || header.dataLength != (uint64_t)header.width * header.height * formatInfo->second.bpp / 8)
+    {
+        fileUtils->removeFile(entryPath);
+        return false;
+    }
+
+    // the pixels are moved to the front of the buffer, which the image takes over
+    ssize_t bufferSize = 0;
+    unsigned char* buffer = data.takeBuffer(&bufferSize);
+    memmove(buffer, buffer + sizeof(header) + header.pathLength, (size_t)header.dataLength);
+
+    image->_data = buffer;
+    image->_dataLen = (ssize_t)header.dataLength;
+    image->_width = header.width;
+    image->_height = header.height;
+    image->_renderFormat = (Texture2D::PixelFormat)header.renderFormat;
+    image->_fileType = (Image::Format)header.fileType;
+    image->_targetFormat = targetFormat;
+    image->_hasPremultipliedAlpha = (header.flags & PREMULTIPLIED_ALPHA) != 0;
+    image->_filePath = fullPath;
+    return true;
+}
+
+void DecodedImageCache::saveImage(const std::string& fullPath, Texture2D::PixelFormat targetFormat, Image* image)
+{
+    if (!_enabled)
+    {
+        return;
+    }
+
+    // compressed textures load about as fast as an entry would, TGA files are raw already
+    Image::Format fileType = image->_fileType;
+    if ((fileType != Image::Format::PNG && fileType != Image::Format::JPG && fileType != Image::Format::WEBP && fileType != Image::Format::TIFF)
+        || image->isCompressed() || image->getNumberOfMipmaps() > 1 || image->getData() == nullptr)
+    {
+        return;
+    }
+
+    // zeroed, so that the padding isn't written uninitialized
+    DecodedImageHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!getSourceKey(fullPath, &header.sourceSize, &header.sourceStamp))
+    {
+        return;
+    }
+    memcpy(header.magic, DECODED_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = DECODED_IMAGE_VERSION;
+    header.pathLength = (uint32_t)fullPath.length();
+    header.flags = (image->hasPremultipliedAlpha() ? PREMULTIPLIED_ALPHA : 0)
+                 | (Image::PNG_PREMULTIPLIED_ALPHA_ENABLED ? PNG_PREMULTIPLIED_ALPHA_ENABLED : 0);
+    header.width = image->getWidth();
+    header.height = image->getHeight();
+    header.renderFormat = (int32_t)image->getRenderFormat();
+    header.fileType = (int32_t)fileType;
+    header.targetFormat = (int32_t)targetFormat;
+    header.dataLength = (uint64_t)image->getDataLen();
+
+    FileUtils* fileUtils = FileUtils::getInstance();
+    std::string cachePath = getCachePath();
+    {
+        std::lock_guard<std::mutex> lock(_pathMutex);
+        if (!_cachePathCreated)
+        {
+            _cachePathCreated = fileUtils->createDirectory(cachePath);
+        }
+    }
+
+    // written aside and renamed, so that no thread or later launch ever reads half an entry
+    std::string entryPath = getEntryPath(cachePath, fullPath);
+    std::string tempPath = entryPath + StringUtils::format(".%u.tmp", (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()));
+    FILE* fp = fopen(fileUtils->getSuitableFOpen(tempPath).c_str(), "wb");
+    if (fp == nullptr)
+    {
+        CCLOG("cocos2d: DecodedImageCache: can't write %s", tempPath.c_str());
+        return;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, fp) == 1
+                && fwrite(fullPath.c_str(), 1, fullPath.length(), fp) == fullPath.length()
+                && fwrite(image->getData(), 1, (size_t)image->getDataLen(), fp) == (size_t)image->getDataLen();
+    written = fclose(fp) == 0 && written;
+
+    if (!written || !fileUtils->renameFile(tempPath, entryPath))
+    {
+        CCLOG("cocos2d: DecodedImageCache: can't write %s", entryPath.c_str());
+        fileUtils->removeFile(tempPath);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_DECODED_IMAGE_CACHE_H__
+#define __CC_DECODED_IMAGE_CACHE_H__
+
+#include "platform/CCPlatformMacros.h"
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "renderer/CCTexture2D.h"
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+NS_CC_BEGIN
+
+class Image;
+
+/**
+ * @class DecodedImageCache
+ * @brief A disk cache of decoded images, for faster launches.
+ *
+ * Decoding PNG, JPEG, WebP and TIFF files is expensive. The cache keeps their decoded (and premultiplied) pixels
+ * under the cache path, the next launches read them back instead of decoding the files again.
+ * An entry is only used while the file has the same path, size and modification time.
+ * Android APK assets have no modification time of their own, their entries follow the modification time of the APK,
+ * which changes whenever the app is updated. Files with neither are not cached.
+ *
+ * Image::initWithImageFile() and the loading threads of TextureCache::addImageAsync() use it. Disabled by default.
+ * @js NA
+ */
+class CC_DLL DecodedImageCache
+{
+public:
+    /** Returns the shared instance of the cache. */
+    static DecodedImageCache* getInstance();
+
+    /** Enables or disables the cache. */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+
+    /** Whether or not the cache is enabled. */
+    bool isEnabled() const { return _enabled; }
+
+    /** Sets the directory of the cache entries. Default is "decoded_images/" in the writable path. */
+    void setCachePath(const std::string& path);
+
+    /** Returns the directory of the cache entries. */
+    std::string getCachePath() const;
+
+    /** Removes all the entries of the cache. */
+    void removeAll();
+
+    /** Initializes an empty image with the cached pixels of a file.
+     * @param fullPath The full path of the image file.
+     * @param targetFormat The pixel format the image is decoded for, see Image::initWithImageFile(path, format).
+     * @return False if the cache is disabled or has no up to date entry for the file and format.
+     */
+    bool loadImage(const std::string& fullPath, Texture2D::PixelFormat targetFormat, Image* image);
+
+    /** Stores the pixels of an image decoded from a file, unless they aren't worth caching (e.g. compressed textures).
+     * @param fullPath The full path of the image file.
+     * @param targetFormat The pixel format the image was decoded for.
+     */
+    void saveImage(const std::string& fullPath, Texture2D::PixelFormat targetFormat, Image* image);
+
+protected:
+    DecodedImageCache();
+
+    // the size and modification time (the APK's for packaged files) the entries of a file must match, false if there are none
+    bool getSourceKey(const std::string& fullPath, int64_t* size, int64_t* stamp) const;
+    std::string getEntryPath(const std::string& cachePath, const std::string& fullPath) const;
+
+    std::atomic<bool> _enabled;
+    mutable std::mutex _pathMutex;
+    mutable std::string _cachePath;
+    bool _cachePathCreated;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_DECODED_IMAGE_CACHE_H__
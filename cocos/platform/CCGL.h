@@ -28,6 +28,7 @@ THE SOFTWARE.
 /// @cond DO_NOT_SHOW
 
 #include "platform/CCPlatformConfig.h"
+#include "base/ccConfig.h"
 
 #if CC_TARGET_PLATFORM == CC_PLATFORM_MAC
 #include "platform/mac/CCGL-mac.h"
@@ -39,8 +40,10 @@ THE SOFTWARE.
 #include "platform/win32/CCGL-win32.h"
 #elif CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
 #include "platform/winrt/CCGL.h"
-#elif CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
-#include "platform/linux/CCGL-linux.h"
+#endif
+
+#if CC_USE_NULL_GL
+#include "platform/CCGLNull.h"
 #endif
 
 /// @endcond
@@ -0,0 +1,1406 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/CCGL.h"
+
+#if CC_USE_NULL_GL
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+NS_CC_BEGIN
+
+namespace GLNull
+{
+
+namespace
+{
+    struct Variable
+    {
+        std::string name;
+        GLenum type;
+        GLint size;
+    };
+
+    struct Shader
+    {
+        GLenum type;
+        std::string source;
+    };
+
+    struct Program
+    {
+        std::vector<GLuint> shaders;
+        std::unordered_map<std::string, GLuint> boundAttribs;
+        std::vector<Variable> attributes;
+        std::vector<Variable> uniforms;
+    };
+
+    struct Context
+    {
+        GLuint nextName = 1;
+        GLenum error = GL_NO_ERROR;
+
+        GLuint arrayBuffer = 0;
+        GLuint elementArrayBuffer = 0;
+        GLuint framebuffer = 0;
+        GLuint renderbuffer = 0;
+        GLuint program = 0;
+
+        GLint viewport[4] = {0, 0, 0, 0};
+        GLint scissorBox[4] = {0, 0, 0, 0};
+        GLfloat clearColor[4] = {0, 0, 0, 0};
+        GLfloat clearDepth = 1;
+        GLint clearStencil = 0;
+        GLboolean depthMask = GL_TRUE;
+        GLuint stencilWriteMask = 0xFF;
+        GLuint stencilValueMask = 0xFF;
+        GLint stencilRef = 0;
+        GLenum stencilFunc = GL_ALWAYS;
+
+        std::unordered_set<GLenum> enabledCaps;
+        std::unordered_set<GLuint> textures;
+        std::unordered_set<GLuint> framebuffers;
+        std::unordered_set<GLuint> renderbuffers;
+        std::unordered_set<GLuint> vertexArrays;
+        // glMapBuffer() needs real storage, so the size of every buffer is kept
+        std::unordered_map<GLuint, std::vector<unsigned char>> buffers;
+        std::unordered_map<GLuint, Shader> shaders;
+        std::unordered_map<GLuint, Program> programs;
+    };
+
+    Stats s_stats;
+
+    Context& context()
+    {
+        static Context s_context;
+        return s_context;
+    }
+
+    inline void countCall()
+    {
+        ++s_stats.calls;
+    }
+
+    inline void countStateChange()
+    {
+        ++s_stats.calls;
+        ++s_stats.stateChanges;
+    }
+
+    inline void countUniform()
+    {
+        ++s_stats.calls;
+        ++s_stats.uniformUpdates;
+    }
+
+    void genNames(GLsizei n, GLuint* names, std::unordered_set<GLuint>& objects)
+    {
+        countCall();
+        auto& ctx = context();
+        for (GLsizei i = 0; i < n; ++i)
+        {
+            names[i] = ctx.nextName++;
+            objects.insert(names[i]);
+        }
+    }
+
+    void deleteNames(GLsizei n, const GLuint* names, std::unordered_set<GLuint>& objects)
+    {
+        countCall();
+        for (GLsizei i = 0; i < n; ++i)
+            objects.erase(names[i]);
+    }
+
+    GLuint& bufferBinding(GLenum target)
+    {
+        auto& ctx = context();
+        return target == GL_ELEMENT_ARRAY_BUFFER ? ctx.elementArrayBuffer : ctx.arrayBuffer;
+    }
+
+    void copyString(const std::string& str, GLsizei bufsize, GLsizei* length, GLchar* dst)
+    {
+        GLsizei len = 0;
+        if (dst && bufsize > 0)
+        {
+            len = std::min((GLsizei)str.length(), bufsize - 1);
+            memcpy(dst, str.c_str(), len);
+            dst[len] = '\0';
+        }
+        if (length)
+            *length = len;
+    }
+
+    GLenum variableType(const std::string& type)
+    {
+        static const std::unordered_map<std::string, GLenum> types = {
+            {"float", GL_FLOAT}, {"vec2", GL_FLOAT_VEC2}, {"vec3", GL_FLOAT_VEC3}, {"vec4", GL_FLOAT_VEC4},
+            {"int", GL_INT}, {"ivec2", GL_INT_VEC2}, {"ivec3", GL_INT_VEC3}, {"ivec4", GL_INT_VEC4},
+            {"bool", GL_BOOL}, {"bvec2", GL_BOOL_VEC2}, {"bvec3", GL_BOOL_VEC3}, {"bvec4", GL_BOOL_VEC4},
+            {"mat2", GL_FLOAT_MAT2}, {"mat3", GL_FLOAT_MAT3}, {"mat4", GL_FLOAT_MAT4},
+            {"sampler2D", GL_SAMPLER_2D}, {"samplerCube", GL_SAMPLER_CUBE},
+        };
+        auto iter = types.find(type);
+        return iter != types.end() ? iter->second : GL_FLOAT;
+    }
+
+    void addVariable(std::vector<Variable>& variables, const std::string& type, const std::string& declarator)
+    {
+        Variable variable;
+        variable.type = variableType(type);
+        variable.size = 1;
+        variable.name = declarator;
+
+        // arrays are reported the way drivers do: "name[0]" with the array size
+        auto bracket = declarator.find('[');
+        if (bracket != std::string::npos)
+        {
+            variable.name = declarator.substr(0, bracket) + "[0]";
+            variable.size = std::max(1, atoi(declarator.c_str() + bracket + 1));
+        }
+
+        for (const auto& existing : variables)
+        {
+            if (existing.name == variable.name)
+                return;
+        }
+        variables.push_back(variable);
+    }
+
+    /* Collects the "attribute" and "uniform" declarations of a GLSL source. Good enough for the
+     * engine shaders: preprocessor lines and comments are skipped, everything else is tokenized. */
+    void parseDeclarations(const std::string& source, Program& program)
+    {
+        std::vector<std::string> tokens;
+        std::string token;
+        bool lineComment = false;
+        bool blockComment = false;
+        bool preprocessor = false;
+        bool lineStart = true;
+
+        for (size_t i = 0, len = source.length(); i < len; ++i)
+        {
+            char c = source[i];
+            char next = i + 1 < len ? source[i + 1] : '\0';
+
+            if (c == '\n')
+            {
+                lineComment = preprocessor = false;
+                lineStart = true;
+            }
+            if (lineComment || preprocessor)
+                continue;
+            if (blockComment)
+            {
+                if (c == '*' && next == '/')
+                {
+                    blockComment = false;
+                    ++i;
+                }
+                continue;
+            }
+            if (c == '/' && (next == '/' || next == '*'))
+            {
+                if (!token.empty())
+                {
+                    tokens.push_back(token);
+                    token.clear();
+                }
+                lineComment = (next == '/');
+                blockComment = (next == '*');
+                ++i;
+                continue;
+            }
+            if (c == '#' && lineStart)
+            {
+                preprocessor = true;
+                continue;
+            }
+
+            if (isalnum((unsigned char)c) || c == '_' || c == '[' || c == ']')
+            {
+                token += c;
+                lineStart = false;
+                continue;
+            }
+            if (!isspace((unsigned char)c))
+                lineStart = false;
+
+            if (!token.empty())
+            {
+                tokens.push_back(token);
+                token.clear();
+            }
+            if (c == ';' || c == ',' || c == '{' || c == '}' || c == '(' || c == ')')
+                tokens.push_back(std::string(1, c));
+        }
+        if (!token.empty())
+            tokens.push_back(token);
+
+        for (size_t i = 0, count = tokens.size(); i < count; ++i)
+        {
+            bool isUniform = tokens[i] == "uniform";
+            if (!isUniform && tokens[i] != "attribute")
+                continue;
+
+            size_t j = i + 1;
+            if (j < count && (tokens[j] == "lowp" || tokens[j] == "mediump" || tokens[j] == "highp"))
+                ++j;
+            if (j >= count)
+                break;
+
+            const std::string& type = tokens[j++];
+            for (; j < count && tokens[j] != ";"; ++j)
+            {
+                if (tokens[j] != ",")
+                    addVariable(isUniform ? program.uniforms : program.attributes, type, tokens[j]);
+            }
+            i = j;
+        }
+    }
+
+    GLint uniformLocation(const Program& program, const char* name)
+    {
+        std::string key(name);
+        if (key.find('[') == std::string::npos)
+            key += "[0]";
+
+        for (size_t i = 0, count = program.uniforms.size(); i < count; ++i)
+        {
+            const auto& uniformName = program.uniforms[i].name;
+            if (uniformName == name || uniformName == key)
+                return (GLint)i;
+        }
+        return -1;
+    }
+} // namespace
+
+const Stats& getStats()
+{
+    return s_stats;
+}
+
+void resetStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+// Textures and framebuffers
+
+void activeTexture(GLenum texture)
+{
+    countStateChange();
+}
+
+void bindTexture(GLenum target, GLuint texture)
+{
+    countStateChange();
+    if (texture != 0)
+        context().textures.insert(texture);
+}
+
+void genTextures(GLsizei n, GLuint* textures)
+{
+    genNames(n, textures, context().textures);
+}
+
+void deleteTextures(GLsizei n, const GLuint* textures)
+{
+    deleteNames(n, textures, context().textures);
+}
+
+GLboolean isTexture(GLuint texture)
+{
+    countCall();
+    return context().textures.count(texture) ? GL_TRUE : GL_FALSE;
+}
+
+void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    countCall();
+    ++s_stats.textureUploads;
+
+    size_t bytesPerPixel = 4;
+    if (type == GL_UNSIGNED_SHORT_5_6_5 || type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_5_5_1)
+        bytesPerPixel = 2;
+    else if (format == GL_RGB)
+        bytesPerPixel = 3;
+    else if (format == GL_LUMINANCE_ALPHA)
+        bytesPerPixel = 2;
+    else if (format == GL_ALPHA || format == GL_LUMINANCE)
+        bytesPerPixel = 1;
+
+    if (pixels)
+        s_stats.uploadedBytes += (size_t)width * height * bytesPerPixel;
+}
+
+void texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    texImage2D(target, level, format, width, height, 0, format, type, pixels);
+}
+
+void compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data)
+{
+    countCall();
+    ++s_stats.textureUploads;
+    s_stats.uploadedBytes += imageSize;
+}
+
+void compressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid* data)
+{
+    compressedTexImage2D(target, level, format, width, height, 0, imageSize, data);
+}
+
+void copyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border)
+{
+    countCall();
+}
+
+void copyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    countCall();
+}
+
+void texParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    countStateChange();
+}
+
+void texParameteri(GLenum target, GLenum pname, GLint param)
+{
+    countStateChange();
+}
+
+void getTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
+{
+    countCall();
+    *params = 0;
+}
+
+void generateMipmap(GLenum target)
+{
+    countCall();
+}
+
+void pixelStorei(GLenum pname, GLint param)
+{
+    countStateChange();
+}
+
+void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    countCall();
+    if (pixels)
+        memset(pixels, 0, (size_t)width * height * (format == GL_RGB ? 3 : 4));
+}
+
+void bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    countStateChange();
+    context().framebuffer = framebuffer;
+}
+
+void genFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    genNames(n, framebuffers, context().framebuffers);
+}
+
+void deleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    deleteNames(n, framebuffers, context().framebuffers);
+}
+
+GLboolean isFramebuffer(GLuint framebuffer)
+{
+    countCall();
+    return context().framebuffers.count(framebuffer) ? GL_TRUE : GL_FALSE;
+}
+
+GLenum checkFramebufferStatus(GLenum target)
+{
+    countCall();
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    countStateChange();
+}
+
+void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+    countStateChange();
+}
+
+void discardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments)
+{
+    countCall();
+}
+
+void bindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    countStateChange();
+    context().renderbuffer = renderbuffer;
+}
+
+void genRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    genNames(n, renderbuffers, context().renderbuffers);
+}
+
+void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    deleteNames(n, renderbuffers, context().renderbuffers);
+}
+
+GLboolean isRenderbuffer(GLuint renderbuffer)
+{
+    countCall();
+    return context().renderbuffers.count(renderbuffer) ? GL_TRUE : GL_FALSE;
+}
+
+void renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    countCall();
+}
+
+// Buffers and vertex arrays
+
+void bindBuffer(GLenum target, GLuint buffer)
+{
+    countStateChange();
+    bufferBinding(target) = buffer;
+}
+
+void genBuffers(GLsizei n, GLuint* buffers)
+{
+    countCall();
+    auto& ctx = context();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        buffers[i] = ctx.nextName++;
+        ctx.buffers[buffers[i]];
+    }
+}
+
+void deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    countCall();
+    auto& ctx = context();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        ctx.buffers.erase(buffers[i]);
+        if (ctx.arrayBuffer == buffers[i])
+            ctx.arrayBuffer = 0;
+        if (ctx.elementArrayBuffer == buffers[i])
+            ctx.elementArrayBuffer = 0;
+    }
+}
+
+GLboolean isBuffer(GLuint buffer)
+{
+    countCall();
+    return context().buffers.count(buffer) ? GL_TRUE : GL_FALSE;
+}
+
+void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    countCall();
+    ++s_stats.bufferUploads;
+    if (data)
+        s_stats.uploadedBytes += size;
+
+    auto iter = context().buffers.find(bufferBinding(target));
+    if (iter != context().buffers.end())
+        iter->second.resize(size);
+}
+
+void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    countCall();
+    ++s_stats.bufferUploads;
+    s_stats.uploadedBytes += size;
+}
+
+void* mapBuffer(GLenum target, GLenum access)
+{
+    countCall();
+    ++s_stats.bufferUploads;
+
+    auto iter = context().buffers.find(bufferBinding(target));
+    if (iter == context().buffers.end() || iter->second.empty())
+    {
+        context().error = GL_INVALID_OPERATION;
+        return nullptr;
+    }
+    s_stats.uploadedBytes += iter->second.size();
+    return iter->second.data();
+}
+
+GLboolean unmapBuffer(GLenum target)
+{
+    countCall();
+    return GL_TRUE;
+}
+
+void bindVertexArray(GLuint array)
+{
+    countStateChange();
+}
+
+void genVertexArrays(GLsizei n, GLuint* arrays)
+{
+    genNames(n, arrays, context().vertexArrays);
+}
+
+void deleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    deleteNames(n, arrays, context().vertexArrays);
+}
+
+void enableVertexAttribArray(GLuint index)
+{
+    countStateChange();
+}
+
+void disableVertexAttribArray(GLuint index)
+{
+    countStateChange();
+}
+
+void vertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* ptr)
+{
+    countStateChange();
+}
+
+void vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    countStateChange();
+}
+
+void vertexAttrib1f(GLuint indx, GLfloat x)
+{
+    countStateChange();
+}
+
+void vertexAttrib1fv(GLuint indx, const GLfloat* values)
+{
+    countStateChange();
+}
+
+void vertexAttrib2f(GLuint indx, GLfloat x, GLfloat y)
+{
+    countStateChange();
+}
+
+void vertexAttrib2fv(GLuint indx, const GLfloat* values)
+{
+    countStateChange();
+}
+
+void vertexAttrib3f(GLuint indx, GLfloat x, GLfloat y, GLfloat z)
+{
+    countStateChange();
+}
+
+void vertexAttrib3fv(GLuint indx, const GLfloat* values)
+{
+    countStateChange();
+}
+
+void vertexAttrib4f(GLuint indx, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+    countStateChange();
+}
+
+void vertexAttrib4fv(GLuint indx, const GLfloat* values)
+{
+    countStateChange();
+}
+
+// Drawing
+
+void clear(GLbitfield mask)
+{
+    countCall();
+}
+
+void drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    countCall();
+    ++s_stats.drawCalls;
+    s_stats.drawnVertices += count;
+}
+
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+    countCall();
+    ++s_stats.drawCalls;
+    s_stats.drawnVertices += count * instanceCount;
+}
+
+void drawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    countCall();
+    ++s_stats.drawCalls;
+    s_stats.drawnVertices += count;
+}
+
+void finish()
+{
+    countCall();
+}
+
+void flush()
+{
+    countCall();
+}
+
+// Fixed function state
+
+void enable(GLenum cap)
+{
+    countStateChange();
+    context().enabledCaps.insert(cap);
+}
+
+void disable(GLenum cap)
+{
+    countStateChange();
+    context().enabledCaps.erase(cap);
+}
+
+GLboolean isEnabled(GLenum cap)
+{
+    countCall();
+    return context().enabledCaps.count(cap) ? GL_TRUE : GL_FALSE;
+}
+
+void blendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    countStateChange();
+}
+
+void blendEquation(GLenum mode)
+{
+    countStateChange();
+}
+
+void blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+{
+    countStateChange();
+}
+
+void blendFunc(GLenum sfactor, GLenum dfactor)
+{
+    countStateChange();
+}
+
+void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    countStateChange();
+}
+
+void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    countStateChange();
+    auto& ctx = context();
+    ctx.clearColor[0] = red;
+    ctx.clearColor[1] = green;
+    ctx.clearColor[2] = blue;
+    ctx.clearColor[3] = alpha;
+}
+
+void clearDepth(GLfloat depth)
+{
+    countStateChange();
+    context().clearDepth = depth;
+}
+
+void clearStencil(GLint s)
+{
+    countStateChange();
+    context().clearStencil = s;
+}
+
+void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    countStateChange();
+}
+
+void cullFace(GLenum mode)
+{
+    countStateChange();
+}
+
+void frontFace(GLenum mode)
+{
+    countStateChange();
+}
+
+void depthFunc(GLenum func)
+{
+    countStateChange();
+}
+
+void depthMask(GLboolean flag)
+{
+    countStateChange();
+    context().depthMask = flag;
+}
+
+void depthRange(GLfloat zNear, GLfloat zFar)
+{
+    countStateChange();
+}
+
+void hint(GLenum target, GLenum mode)
+{
+    countStateChange();
+}
+
+void lineWidth(GLfloat width)
+{
+    countStateChange();
+}
+
+void polygonOffset(GLfloat factor, GLfloat units)
+{
+    countStateChange();
+}
+
+void sampleCoverage(GLfloat value, GLboolean invert)
+{
+    countStateChange();
+}
+
+void scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    countStateChange();
+    auto& ctx = context();
+    ctx.scissorBox[0] = x;
+    ctx.scissorBox[1] = y;
+    ctx.scissorBox[2] = width;
+    ctx.scissorBox[3] = height;
+}
+
+void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    countStateChange();
+    auto& ctx = context();
+    ctx.viewport[0] = x;
+    ctx.viewport[1] = y;
+    ctx.viewport[2] = width;
+    ctx.viewport[3] = height;
+}
+
+void stencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    countStateChange();
+    auto& ctx = context();
+    ctx.stencilFunc = func;
+    ctx.stencilRef = ref;
+    ctx.stencilValueMask = mask;
+}
+
+void stencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
+{
+    stencilFunc(func, ref, mask);
+}
+
+void stencilMask(GLuint mask)
+{
+    countStateChange();
+    context().stencilWriteMask = mask;
+}
+
+void stencilMaskSeparate(GLenum face, GLuint mask)
+{
+    stencilMask(mask);
+}
+
+void stencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    countStateChange();
+}
+
+void stencilOpSeparate(GLenum face, GLenum fail, GLenum zfail, GLenum zpass)
+{
+    countStateChange();
+}
+
+// Queries
+
+GLenum getError()
+{
+    countCall();
+    auto& ctx = context();
+    GLenum error = ctx.error;
+    ctx.error = GL_NO_ERROR;
+    return error;
+}
+
+const GLubyte* getString(GLenum name)
+{
+    countCall();
+    switch (name)
+    {
+        case GL_VENDOR:
+            return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER:
+            return (const GLubyte*)"Null GL";
+        case GL_VERSION:
+            return (const GLubyte*)"OpenGL ES 2.0 (Null GL)";
+        case GL_SHADING_LANGUAGE_VERSION:
+            return (const GLubyte*)"OpenGL ES GLSL ES 1.00";
+        case GL_EXTENSIONS:
+            return (const GLubyte*)"GL_OES_vertex_array_object GL_OES_mapbuffer GL_OES_element_index_uint GL_OES_depth24 GL_OES_packed_depth_stencil GL_EXT_instanced_arrays GL_ARB_instanced_arrays GL_ARB_draw_instanced";
+        default:
+            return (const GLubyte*)"";
+    }
+}
+
+void getIntegerv(GLenum pname, GLint* params)
+{
+    countCall();
+    auto& ctx = context();
+    switch (pname)
+    {
+        case GL_MAX_TEXTURE_SIZE:
+            params[0] = 4096;
+            break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_ATTRIBS:
+            params[0] = 16;
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            params[0] = ctx.framebuffer;
+            break;
+        case GL_RENDERBUFFER_BINDING:
+            params[0] = ctx.renderbuffer;
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            params[0] = ctx.arrayBuffer;
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            params[0] = ctx.elementArrayBuffer;
+            break;
+        case GL_CURRENT_PROGRAM:
+            params[0] = ctx.program;
+            break;
+        case GL_VIEWPORT:
+            memcpy(params, ctx.viewport, sizeof(ctx.viewport));
+            break;
+        case GL_SCISSOR_BOX:
+            memcpy(params, ctx.scissorBox, sizeof(ctx.scissorBox));
+            break;
+        case GL_STENCIL_CLEAR_VALUE:
+            params[0] = ctx.clearStencil;
+            break;
+        case GL_STENCIL_WRITEMASK:
+            params[0] = ctx.stencilWriteMask;
+            break;
+        case GL_STENCIL_VALUE_MASK:
+            params[0] = ctx.stencilValueMask;
+            break;
+        case GL_STENCIL_REF:
+            params[0] = ctx.stencilRef;
+            break;
+        case GL_STENCIL_FUNC:
+            params[0] = ctx.stencilFunc;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void getFloatv(GLenum pname, GLfloat* params)
+{
+    countCall();
+    auto& ctx = context();
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:
+            memcpy(params, ctx.clearColor, sizeof(ctx.clearColor));
+            break;
+        case GL_DEPTH_CLEAR_VALUE:
+            params[0] = ctx.clearDepth;
+            break;
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+        {
+            const GLint* box = pname == GL_VIEWPORT ? ctx.viewport : ctx.scissorBox;
+            for (int i = 0; i < 4; ++i)
+                params[i] = (GLfloat)box[i];
+            break;
+        }
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void getBooleanv(GLenum pname, GLboolean* params)
+{
+    countCall();
+    if (pname == GL_DEPTH_WRITEMASK)
+        params[0] = context().depthMask;
+    else
+        params[0] = context().enabledCaps.count(pname) ? GL_TRUE : GL_FALSE;
+}
+
+// Shaders and programs
+
+GLuint createShader(GLenum type)
+{
+    countCall();
+    auto& ctx = context();
+    GLuint name = ctx.nextName++;
+    ctx.shaders[name].type = type;
+    return name;
+}
+
+void deleteShader(GLuint shader)
+{
+    countCall();
+    context().shaders.erase(shader);
+}
+
+GLboolean isShader(GLuint shader)
+{
+    countCall();
+    return context().shaders.count(shader) ? GL_TRUE : GL_FALSE;
+}
+
+void shaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    countCall();
+    auto iter = context().shaders.find(shader);
+    if (iter == context().shaders.end())
+        return;
+
+    auto& source = iter->second.source;
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (length && length[i] >= 0)
+            source.append(string[i], length[i]);
+        else
+            source.append(string[i]);
+        // the strings are concatenated by the compiler, keep the lines apart for the parser
+        source += '\n';
+    }
+}
+
+void compileShader(GLuint shader)
+{
+    countCall();
+}
+
+void releaseShaderCompiler()
+{
+    countCall();
+}
+
+void getShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    countCall();
+    switch (pname)
+    {
+        case GL_COMPILE_STATUS:
+            params[0] = GL_TRUE;
+            break;
+        case GL_SHADER_TYPE:
+        case GL_SHADER_SOURCE_LENGTH:
+        {
+            auto iter = context().shaders.find(shader);
+            if (iter == context().shaders.end())
+                params[0] = 0;
+            else if (pname == GL_SHADER_TYPE)
+                params[0] = iter->second.type;
+            else
+                params[0] = (GLint)iter->second.source.length() + 1;
+            break;
+        }
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void getShaderInfoLog(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog)
+{
+    countCall();
+    copyString("", bufsize, length, infolog);
+}
+
+void getShaderSource(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* source)
+{
+    countCall();
+    auto iter = context().shaders.find(shader);
+    copyString(iter != context().shaders.end() ? iter->second.source : "", bufsize, length, source);
+}
+
+GLuint createProgram()
+{
+    countCall();
+    auto& ctx = context();
+    GLuint name = ctx.nextName++;
+    ctx.programs[name];
+    return name;
+}
+
+void deleteProgram(GLuint program)
+{
+    countCall();
+    context().programs.erase(program);
+}
+
+GLboolean isProgram(GLuint program)
+{
+    countCall();
+    return context().programs.count(program) ? GL_TRUE : GL_FALSE;
+}
+
+void attachShader(GLuint program, GLuint shader)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    if (iter != context().programs.end())
+        iter->second.shaders.push_back(shader);
+}
+
+void detachShader(GLuint program, GLuint shader)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    if (iter != context().programs.end())
+    {
+        auto& shaders = iter->second.shaders;
+        shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+    }
+}
+
+void getAttachedShaders(GLuint program, GLsizei maxcount, GLsizei* count, GLuint* shaders)
+{
+    countCall();
+    GLsizei written = 0;
+    auto iter = context().programs.find(program);
+    if (iter != context().programs.end())
+    {
+        for (auto shader : iter->second.shaders)
+        {
+            if (written >= maxcount)
+                break;
+            shaders[written++] = shader;
+        }
+    }
+    if (count)
+        *count = written;
+}
+
+void bindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    if (iter != context().programs.end())
+        iter->second.boundAttribs[name] = index;
+}
+
+void linkProgram(GLuint program)
+{
+    countCall();
+    auto& ctx = context();
+    auto iter = ctx.programs.find(program);
+    if (iter == ctx.programs.end())
+        return;
+
+    auto& p = iter->second;
+    p.attributes.clear();
+    p.uniforms.clear();
+    for (auto shader : p.shaders)
+    {
+        auto shaderIter = ctx.shaders.find(shader);
+        if (shaderIter != ctx.shaders.end())
+            parseDeclarations(shaderIter->second.source, p);
+    }
+}
+
+void validateProgram(GLuint program)
+{
+    countCall();
+}
+
+void useProgram(GLuint program)
+{
+    countStateChange();
+    context().program = program;
+}
+
+void getProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    countCall();
+    params[0] = 0;
+
+    auto iter = context().programs.find(program);
+    if (iter == context().programs.end())
+        return;
+
+    const auto& p = iter->second;
+    switch (pname)
+    {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            params[0] = GL_TRUE;
+            break;
+        case GL_ATTACHED_SHADERS:
+            params[0] = (GLint)p.shaders.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            params[0] = (GLint)p.attributes.size();
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            params[0] = (GLint)p.uniforms.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+        {
+            const auto& variables = pname == GL_ACTIVE_ATTRIBUTE_MAX_LENGTH ? p.attributes : p.uniforms;
+            for (const auto& variable : variables)
+                params[0] = std::max(params[0], (GLint)variable.name.length() + 1);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void getProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog)
+{
+    countCall();
+    copyString("", bufsize, length, infolog);
+}
+
+void getActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    if (iter == context().programs.end() || index >= iter->second.attributes.size())
+    {
+        context().error = GL_INVALID_VALUE;
+        return;
+    }
+
+    const auto& variable = iter->second.attributes[index];
+    *size = variable.size;
+    *type = variable.type;
+    copyString(variable.name, bufsize, length, name);
+}
+
+void getActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    if (iter == context().programs.end() || index >= iter->second.uniforms.size())
+    {
+        context().error = GL_INVALID_VALUE;
+        return;
+    }
+
+    const auto& variable = iter->second.uniforms[index];
+    *size = variable.size;
+    *type = variable.type;
+    copyString(variable.name, bufsize, length, name);
+}
+
+GLint getAttribLocation(GLuint program, const GLchar* name)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    if (iter == context().programs.end())
+        return -1;
+
+    const auto& p = iter->second;
+    auto bound = p.boundAttribs.find(name);
+    if (bound != p.boundAttribs.end())
+        return (GLint)bound->second;
+
+    // unbound attributes are placed after the ones bound by the engine
+    GLint location = 0;
+    for (const auto& b : p.boundAttribs)
+        location = std::max(location, (GLint)b.second + 1);
+    for (const auto& attribute : p.attributes)
+    {
+        if (attribute.name == name)
+            return location;
+        if (p.boundAttribs.find(attribute.name) == p.boundAttribs.end())
+            ++location;
+    }
+    return -1;
+}
+
+GLint getUniformLocation(GLuint program, const GLchar* name)
+{
+    countCall();
+    auto iter = context().programs.find(program);
+    return iter != context().programs.end() ? uniformLocation(iter->second, name) : -1;
+}
+
+void getUniformfv(GLuint program, GLint location, GLfloat* params)
+{
+    countCall();
+    params[0] = 0;
+}
+
+void getUniformiv(GLuint program, GLint location, GLint* params)
+{
+    countCall();
+    params[0] = 0;
+}
+
+void uniform1f(GLint location, GLfloat x)
+{
+    countUniform();
+}
+
+void uniform1fv(GLint location, GLsizei count, const GLfloat* v)
+{
+    countUniform();
+}
+
+void uniform1i(GLint location, GLint x)
+{
+    countUniform();
+}
+
+void uniform1iv(GLint location, GLsizei count, const GLint* v)
+{
+    countUniform();
+}
+
+void uniform2f(GLint location, GLfloat x, GLfloat y)
+{
+    countUniform();
+}
+
+void uniform2fv(GLint location, GLsizei count, const GLfloat* v)
+{
+    countUniform();
+}
+
+void uniform2i(GLint location, GLint x, GLint y)
+{
+    countUniform();
+}
+
+void uniform2iv(GLint location, GLsizei count, const GLint* v)
+{
+    countUniform();
+}
+
+void uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
+{
+    countUniform();
+}
+
+void uniform3fv(GLint location, GLsizei count, const GLfloat* v)
+{
+    countUniform();
+}
+
+void uniform3i(GLint location, GLint x, GLint y, GLint z)
+{
+    countUniform();
+}
+
+void uniform3iv(GLint location, GLsizei count, const GLint* v)
+{
+    countUniform();
+}
+
+void uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+    countUniform();
+}
+
+void uniform4fv(GLint location, GLsizei count, const GLfloat* v)
+{
+    countUniform();
+}
+
+void uniform4i(GLint location, GLint x, GLint y, GLint z, GLint w)
+{
+    countUniform();
+}
+
+void uniform4iv(GLint location, GLsizei count, const GLint* v)
+{
+    countUniform();
+}
+
+void uniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    countUniform();
+}
+
+void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    countUniform();
+}
+
+void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    countUniform();
+}
+
+// Debug markers
+
+void pushGroupMarker(GLsizei length, const GLchar* marker)
+{
+    countCall();
+}
+
+void popGroupMarker()
+{
+    countCall();
+}
+
+void insertEventMarker(GLsizei length, const GLchar* marker)
+{
+    countCall();
+}
+
+} // namespace GLNull
+
+NS_CC_END
+
+#endif // CC_USE_NULL_GL
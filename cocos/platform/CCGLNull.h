@@ -0,0 +1,535 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __PLATFORM_CCGLNULL_H__
+#define __PLATFORM_CCGLNULL_H__
+/// @cond DO_NOT_SHOW
+
+/*
+ * Null GL backend.
+ *
+ * When CC_USE_NULL_GL is enabled (see ccConfig.h) every GL entry point used by the engine is
+ * redirected to the functions declared here. They never talk to a driver: they hand out object
+ * names, remember the little state the engine queries back (bindings, viewport, clear values,
+ * shader uniforms/attributes), and count every call. This allows running Director::drawScene()
+ * without a GL context, e.g. to measure the CPU cost of the renderer on a GPU-less machine.
+ *
+ * Include "platform/CCGL.h" instead of this file.
+ */
+
+#include <stddef.h>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+namespace GLNull
+{
+    /** Counters of the GL calls issued since the last call to resetStats(). */
+    struct Stats
+    {
+        /** Every GL call */
+        unsigned int calls;
+        /** glDrawArrays() and glDrawElements() calls */
+        unsigned int drawCalls;
+        /** Vertices (or indices) submitted by the draw calls */
+        unsigned int drawnVertices;
+        /** Bindings, capabilities, blending, depth/stencil and program changes */
+        unsigned int stateChanges;
+        /** glUniform*() calls */
+        unsigned int uniformUpdates;
+        /** glBufferData(), glBufferSubData() and glMapBuffer() calls */
+        unsigned int bufferUploads;
+        /** glTexImage2D(), glTexSubImage2D() and their compressed versions */
+        unsigned int textureUploads;
+        /** Bytes uploaded by the buffer and texture uploads */
+        size_t uploadedBytes;
+    };
+
+    CC_DLL const Stats& getStats();
+    CC_DLL void resetStats();
+
+    CC_DLL void activeTexture(GLenum texture);
+    CC_DLL void attachShader(GLuint program, GLuint shader);
+    CC_DLL void bindAttribLocation(GLuint program, GLuint index, const GLchar* name);
+    CC_DLL void bindBuffer(GLenum target, GLuint buffer);
+    CC_DLL void bindFramebuffer(GLenum target, GLuint framebuffer);
+    CC_DLL void bindRenderbuffer(GLenum target, GLuint renderbuffer);
+    CC_DLL void bindTexture(GLenum target, GLuint texture);
+    CC_DLL void bindVertexArray(GLuint array);
+    CC_DLL void blendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+    CC_DLL void blendEquation(GLenum mode);
+    CC_DLL void blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha);
+    CC_DLL void blendFunc(GLenum sfactor, GLenum dfactor);
+    CC_DLL void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+    CC_DLL void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+    CC_DLL void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+    CC_DLL GLenum checkFramebufferStatus(GLenum target);
+    CC_DLL void clear(GLbitfield mask);
+    CC_DLL void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+    CC_DLL void clearDepth(GLfloat depth);
+    CC_DLL void clearStencil(GLint s);
+    CC_DLL void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+    CC_DLL void compileShader(GLuint shader);
+    CC_DLL void compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data);
+    CC_DLL void compressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid* data);
+    CC_DLL void copyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border);
+    CC_DLL void copyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
+    CC_DLL GLuint createProgram();
+    CC_DLL GLuint createShader(GLenum type);
+    CC_DLL void cullFace(GLenum mode);
+    CC_DLL void deleteBuffers(GLsizei n, const GLuint* buffers);
+    CC_DLL void deleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+    CC_DLL void deleteProgram(GLuint program);
+    CC_DLL void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+    CC_DLL void deleteShader(GLuint shader);
+    CC_DLL void deleteTextures(GLsizei n, const GLuint* textures);
+    CC_DLL void deleteVertexArrays(GLsizei n, const GLuint* arrays);
+    CC_DLL void depthFunc(GLenum func);
+    CC_DLL void depthMask(GLboolean flag);
+    CC_DLL void depthRange(GLfloat zNear, GLfloat zFar);
+    CC_DLL void detachShader(GLuint program, GLuint shader);
+    CC_DLL void disable(GLenum cap);
+    CC_DLL void disableVertexAttribArray(GLuint index);
+    CC_DLL void discardFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments);
+    CC_DLL void drawArrays(GLenum mode, GLint first, GLsizei count);
+    CC_DLL void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+    CC_DLL void drawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+    CC_DLL void enable(GLenum cap);
+    CC_DLL void enableVertexAttribArray(GLuint index);
+    CC_DLL void finish();
+    CC_DLL void flush();
+    CC_DLL void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+    CC_DLL void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+    CC_DLL void frontFace(GLenum mode);
+    CC_DLL void genBuffers(GLsizei n, GLuint* buffers);
+    CC_DLL void generateMipmap(GLenum target);
+    CC_DLL void genFramebuffers(GLsizei n, GLuint* framebuffers);
+    CC_DLL void genRenderbuffers(GLsizei n, GLuint* renderbuffers);
+    CC_DLL void genTextures(GLsizei n, GLuint* textures);
+    CC_DLL void genVertexArrays(GLsizei n, GLuint* arrays);
+    CC_DLL void getActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    CC_DLL void getActiveUniform(GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    CC_DLL void getAttachedShaders(GLuint program, GLsizei maxcount, GLsizei* count, GLuint* shaders);
+    CC_DLL GLint getAttribLocation(GLuint program, const GLchar* name);
+    CC_DLL void getBooleanv(GLenum pname, GLboolean* params);
+    CC_DLL GLenum getError();
+    CC_DLL void getFloatv(GLenum pname, GLfloat* params);
+    CC_DLL void getIntegerv(GLenum pname, GLint* params);
+    CC_DLL void getProgramiv(GLuint program, GLenum pname, GLint* params);
+    CC_DLL void getProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog);
+    CC_DLL void getShaderiv(GLuint shader, GLenum pname, GLint* params);
+    CC_DLL void getShaderInfoLog(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog);
+    CC_DLL void getShaderSource(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* source);
+    CC_DLL const GLubyte* getString(GLenum name);
+    CC_DLL void getTexParameterfv(GLenum target, GLenum pname, GLfloat* params);
+    CC_DLL void getUniformfv(GLuint program, GLint location, GLfloat* params);
+    CC_DLL void getUniformiv(GLuint program, GLint location, GLint* params);
+    CC_DLL GLint getUniformLocation(GLuint program, const GLchar* name);
+    CC_DLL void hint(GLenum target, GLenum mode);
+    CC_DLL GLboolean isBuffer(GLuint buffer);
+    CC_DLL GLboolean isEnabled(GLenum cap);
+    CC_DLL GLboolean isFramebuffer(GLuint framebuffer);
+    CC_DLL GLboolean isProgram(GLuint program);
+    CC_DLL GLboolean isRenderbuffer(GLuint renderbuffer);
+    CC_DLL GLboolean isShader(GLuint shader);
+    CC_DLL GLboolean isTexture(GLuint texture);
+    CC_DLL void lineWidth(GLfloat width);
+    CC_DLL void linkProgram(GLuint program);
+    CC_DLL void* mapBuffer(GLenum target, GLenum access);
+    CC_DLL void pixelStorei(GLenum pname, GLint param);
+    CC_DLL void polygonOffset(GLfloat factor, GLfloat units);
+    CC_DLL void pushGroupMarker(GLsizei length, const GLchar* marker);
+    CC_DLL void popGroupMarker();
+    CC_DLL void insertEventMarker(GLsizei length, const GLchar* marker);
+    CC_DLL void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels);
+    CC_DLL void releaseShaderCompiler();
+    CC_DLL void renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+    CC_DLL void sampleCoverage(GLfloat value, GLboolean invert);
+    CC_DLL void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+    CC_DLL void shaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+    CC_DLL void stencilFunc(GLenum func, GLint ref, GLuint mask);
+    CC_DLL void stencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+    CC_DLL void stencilMask(GLuint mask);
+    CC_DLL void stencilMaskSeparate(GLenum face, GLuint mask);
+    CC_DLL void stencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+    CC_DLL void stencilOpSeparate(GLenum face, GLenum fail, GLenum zfail, GLenum zpass);
+    CC_DLL void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+    CC_DLL void texParameterf(GLenum target, GLenum pname, GLfloat param);
+    CC_DLL void texParameteri(GLenum target, GLenum pname, GLint param);
+    CC_DLL void texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels);
+    CC_DLL void uniform1f(GLint location, GLfloat x);
+    CC_DLL void uniform1fv(GLint location, GLsizei count, const GLfloat* v);
+    CC_DLL void uniform1i(GLint location, GLint x);
+    CC_DLL void uniform1iv(GLint location, GLsizei count, const GLint* v);
+    CC_DLL void uniform2f(GLint location, GLfloat x, GLfloat y);
+    CC_DLL void uniform2fv(GLint location, GLsizei count, const GLfloat* v);
+    CC_DLL void uniform2i(GLint location, GLint x, GLint y);
+    CC_DLL void uniform2iv(GLint location, GLsizei count, const GLint* v);
+    CC_DLL void uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z);
+    CC_DLL void uniform3fv(GLint location, GLsizei count, const GLfloat* v);
+    CC_DLL void uniform3i(GLint location, GLint x, GLint y, GLint z);
+    CC_DLL void uniform3iv(GLint location, GLsizei count, const GLint* v);
+    CC_DLL void uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+    CC_DLL void uniform4fv(GLint location, GLsizei count, const GLfloat* v);
+    CC_DLL void uniform4i(GLint location, GLint x, GLint y, GLint z, GLint w);
+    CC_DLL void uniform4iv(GLint location, GLsizei count, const GLint* v);
+    CC_DLL void uniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    CC_DLL void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    CC_DLL void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    CC_DLL GLboolean unmapBuffer(GLenum target);
+    CC_DLL void useProgram(GLuint program);
+    CC_DLL void validateProgram(GLuint program);
+    CC_DLL void vertexAttrib1f(GLuint indx, GLfloat x);
+    CC_DLL void vertexAttrib1fv(GLuint indx, const GLfloat* values);
+    CC_DLL void vertexAttrib2f(GLuint indx, GLfloat x, GLfloat y);
+    CC_DLL void vertexAttrib2fv(GLuint indx, const GLfloat* values);
+    CC_DLL void vertexAttrib3f(GLuint indx, GLfloat x, GLfloat y, GLfloat z);
+    CC_DLL void vertexAttrib3fv(GLuint indx, const GLfloat* values);
+    CC_DLL void vertexAttrib4f(GLuint indx, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+    CC_DLL void vertexAttrib4fv(GLuint indx, const GLfloat* values);
+    CC_DLL void vertexAttribDivisor(GLuint index, GLuint divisor);
+    CC_DLL void vertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* ptr);
+    CC_DLL void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+} // namespace GLNull
+
+NS_CC_END
+
+// The platform headers may already map some of these names to extension entry points,
+// so every name is undefined before being redirected.
+#undef glActiveTexture
+#undef glAttachShader
+#undef glBindAttribLocation
+#undef glBindBuffer
+#undef glBindFramebuffer
+#undef glBindRenderbuffer
+#undef glBindTexture
+#undef glBindVertexArray
+#undef glBindVertexArrayOES
+#undef glBindVertexArrayAPPLE
+#undef glBlendColor
+#undef glBlendEquation
+#undef glBlendEquationSeparate
+#undef glBlendFunc
+#undef glBlendFuncSeparate
+#undef glBufferData
+#undef glBufferSubData
+#undef glCheckFramebufferStatus
+#undef glClear
+#undef glClearColor
+#undef glClearDepth
+#undef glClearDepthf
+#undef glClearStencil
+#undef glColorMask
+#undef glCompileShader
+#undef glCompressedTexImage2D
+#undef glCompressedTexSubImage2D
+#undef glCopyTexImage2D
+#undef glCopyTexSubImage2D
+#undef glCreateProgram
+#undef glCreateShader
+#undef glCullFace
+#undef glDeleteBuffers
+#undef glDeleteFramebuffers
+#undef glDeleteProgram
+#undef glDeleteRenderbuffers
+#undef glDeleteShader
+#undef glDeleteTextures
+#undef glDeleteVertexArrays
+#undef glDeleteVertexArraysOES
+#undef glDeleteVertexArraysAPPLE
+#undef glDepthFunc
+#undef glDepthMask
+#undef glDepthRange
+#undef glDepthRangef
+#undef glDetachShader
+#undef glDisable
+#undef glDisableVertexAttribArray
+#undef glDiscardFramebufferEXT
+#undef glDrawArrays
+#undef glDrawArraysInstanced
+#undef glDrawArraysInstancedARB
+#undef glDrawArraysInstancedEXT
+#undef glDrawElements
+#undef glEnable
+#undef glEnableVertexAttribArray
+#undef glFinish
+#undef glFlush
+#undef glFramebufferRenderbuffer
+#undef glFramebufferTexture2D
+#undef glFrontFace
+#undef glGenBuffers
+#undef glGenerateMipmap
+#undef glGenFramebuffers
+#undef glGenRenderbuffers
+#undef glGenTextures
+#undef glGenVertexArrays
+#undef glGenVertexArraysOES
+#undef glGenVertexArraysAPPLE
+#undef glGetActiveAttrib
+#undef glGetActiveUniform
+#undef glGetAttachedShaders
+#undef glGetAttribLocation
+#undef glGetBooleanv
+#undef glGetError
+#undef glGetFloatv
+#undef glGetIntegerv
+#undef glGetProgramiv
+#undef glGetProgramInfoLog
+#undef glGetShaderiv
+#undef glGetShaderInfoLog
+#undef glGetShaderSource
+#undef glGetString
+#undef glGetTexParameterfv
+#undef glGetUniformfv
+#undef glGetUniformiv
+#undef glGetUniformLocation
+#undef glHint
+#undef glInsertEventMarkerEXT
+#undef glIsBuffer
+#undef glIsEnabled
+#undef glIsFramebuffer
+#undef glIsProgram
+#undef glIsRenderbuffer
+#undef glIsShader
+#undef glIsTexture
+#undef glLineWidth
+#undef glLinkProgram
+#undef glMapBuffer
+#undef glMapBufferOES
+#undef glPixelStorei
+#undef glPolygonOffset
+#undef glPopGroupMarkerEXT
+#undef glPushGroupMarkerEXT
+#undef glReadPixels
+#undef glReleaseShaderCompiler
+#undef glRenderbufferStorage
+#undef glSampleCoverage
+#undef glScissor
+#undef glShaderSource
+#undef glStencilFunc
+#undef glStencilFuncSeparate
+#undef glStencilMask
+#undef glStencilMaskSeparate
+#undef glStencilOp
+#undef glStencilOpSeparate
+#undef glTexImage2D
+#undef glTexParameterf
+#undef glTexParameteri
+#undef glTexSubImage2D
+#undef glUniform1f
+#undef glUniform1fv
+#undef glUniform1i
+#undef glUniform1iv
+#undef glUniform2f
+#undef glUniform2fv
+#undef glUniform2i
+#undef glUniform2iv
+#undef glUniform3f
+#undef glUniform3fv
+#undef glUniform3i
+#undef glUniform3iv
+#undef glUniform4f
+#undef glUniform4fv
+#undef glUniform4i
+#undef glUniform4iv
+#undef glUniformMatrix2fv
+#undef glUniformMatrix3fv
+#undef glUniformMatrix4fv
+#undef glUnmapBuffer
+#undef glUnmapBufferOES
+#undef glUseProgram
+#undef glValidateProgram
+#undef glVertexAttrib1f
+#undef glVertexAttrib1fv
+#undef glVertexAttrib2f
+#undef glVertexAttrib2fv
+#undef glVertexAttrib3f
+#undef glVertexAttrib3fv
+#undef glVertexAttrib4f
+#undef glVertexAttrib4fv
+#undef glVertexAttribDivisor
+#undef glVertexAttribDivisorARB
+#undef glVertexAttribDivisorEXT
+#undef glVertexAttribPointer
+#undef glViewport
+
+#define glActiveTexture                 cocos2d::GLNull::activeTexture
+#define glAttachShader                  cocos2d::GLNull::attachShader
+#define glBindAttribLocation            cocos2d::GLNull::bindAttribLocation
+#define glBindBuffer                    cocos2d::GLNull::bindBuffer
+#define glBindFramebuffer               cocos2d::GLNull::bindFramebuffer
+#define glBindRenderbuffer              cocos2d::GLNull::bindRenderbuffer
+#define glBindTexture                   cocos2d::GLNull::bindTexture
+#define glBindVertexArray               cocos2d::GLNull::bindVertexArray
+#define glBindVertexArrayOES            cocos2d::GLNull::bindVertexArray
+#define glBindVertexArrayAPPLE          cocos2d::GLNull::bindVertexArray
+#define glBlendColor                    cocos2d::GLNull::blendColor
+#define glBlendEquation                 cocos2d::GLNull::blendEquation
+#define glBlendEquationSeparate         cocos2d::GLNull::blendEquationSeparate
+#define glBlendFunc                     cocos2d::GLNull::blendFunc
+#define glBlendFuncSeparate             cocos2d::GLNull::blendFuncSeparate
+#define glBufferData                    cocos2d::GLNull::bufferData
+#define glBufferSubData                 cocos2d::GLNull::bufferSubData
+#define glCheckFramebufferStatus        cocos2d::GLNull::checkFramebufferStatus
+#define glClear                         cocos2d::GLNull::clear
+#define glClearColor                    cocos2d::GLNull::clearColor
+#define glClearDepth                    cocos2d::GLNull::clearDepth
+#define glClearDepthf                   cocos2d::GLNull::clearDepth
+#define glClearStencil                  cocos2d::GLNull::clearStencil
+#define glColorMask                     cocos2d::GLNull::colorMask
+#define glCompileShader                 cocos2d::GLNull::compileShader
+#define glCompressedTexImage2D          cocos2d::GLNull::compressedTexImage2D
+#define glCompressedTexSubImage2D       cocos2d::GLNull::compressedTexSubImage2D
+#define glCopyTexImage2D                cocos2d::GLNull::copyTexImage2D
+#define glCopyTexSubImage2D             cocos2d::GLNull::copyTexSubImage2D
+#define glCreateProgram                 cocos2d::GLNull::createProgram
+#define glCreateShader                  cocos2d::GLNull::createShader
+#define glCullFace                      cocos2d::GLNull::cullFace
+#define glDeleteBuffers                 cocos2d::GLNull::deleteBuffers
+#define glDeleteFramebuffers            cocos2d::GLNull::deleteFramebuffers
+#define glDeleteProgram                 cocos2d::GLNull::deleteProgram
+#define glDeleteRenderbuffers           cocos2d::GLNull::deleteRenderbuffers
+#define glDeleteShader                  cocos2d::GLNull::deleteShader
+#define glDeleteTextures                cocos2d::GLNull::deleteTextures
+#define glDeleteVertexArrays            cocos2d::GLNull::deleteVertexArrays
+#define glDeleteVertexArraysOES         cocos2d::GLNull::deleteVertexArrays
+#define glDeleteVertexArraysAPPLE       cocos2d::GLNull::deleteVertexArrays
+#define glDepthFunc                     cocos2d::GLNull::depthFunc
+#define glDepthMask                     cocos2d::GLNull::depthMask
+#define glDepthRange                    cocos2d::GLNull::depthRange
+#define glDepthRangef                   cocos2d::GLNull::depthRange
+#define glDetachShader                  cocos2d::GLNull::detachShader
+#define glDisable                       cocos2d::GLNull::disable
+#define glDisableVertexAttribArray      cocos2d::GLNull::disableVertexAttribArray
+#define glDiscardFramebufferEXT         cocos2d::GLNull::discardFramebuffer
+#define glDrawArrays                    cocos2d::GLNull::drawArrays
+#define glDrawArraysInstanced           cocos2d::GLNull::drawArraysInstanced
+#define glDrawArraysInstancedARB        cocos2d::GLNull::drawArraysInstanced
+#define glDrawArraysInstancedEXT        cocos2d::GLNull::drawArraysInstanced
+#define glDrawElements                  cocos2d::GLNull::drawElements
+#define glEnable                        cocos2d::GLNull::enable
+#define glEnableVertexAttribArray       cocos2d::GLNull::enableVertexAttribArray
+#define glFinish                        cocos2d::GLNull::finish
+#define glFlush                         cocos2d::GLNull::flush
+#define glFramebufferRenderbuffer       cocos2d::GLNull::framebufferRenderbuffer
+#define glFramebufferTexture2D          cocos2d::GLNull::framebufferTexture2D
+#define glFrontFace                     cocos2d::GLNull::frontFace
+#define glGenBuffers                    cocos2d::GLNull::genBuffers
+#define glGenerateMipmap                cocos2d::GLNull::generateMipmap
+#define glGenFramebuffers               cocos2d::GLNull::genFramebuffers
+#define glGenRenderbuffers              cocos2d::GLNull::genRenderbuffers
+#define glGenTextures                   cocos2d::GLNull::genTextures
+#define glGenVertexArrays               cocos2d::GLNull::genVertexArrays
+#define glGenVertexArraysOES            cocos2d::GLNull::genVertexArrays
+#define glGenVertexArraysAPPLE          cocos2d::GLNull::genVertexArrays
+#define glGetActiveAttrib               cocos2d::GLNull::getActiveAttrib
+#define glGetActiveUniform              cocos2d::GLNull::getActiveUniform
+#define glGetAttachedShaders            cocos2d::GLNull::getAttachedShaders
+#define glGetAttribLocation             cocos2d::GLNull::getAttribLocation
+#define glGetBooleanv                   cocos2d::GLNull::getBooleanv
+#define glGetError                      cocos2d::GLNull::getError
+#define glGetFloatv                     cocos2d::GLNull::getFloatv
+#define glGetIntegerv                   cocos2d::GLNull::getIntegerv
+#define glGetProgramiv                  cocos2d::GLNull::getProgramiv
+#define glGetProgramInfoLog             cocos2d::GLNull::getProgramInfoLog
+#define glGetShaderiv                   cocos2d::GLNull::getShaderiv
+#define glGetShaderInfoLog              cocos2d::GLNull::getShaderInfoLog
+#define glGetShaderSource               cocos2d::GLNull::getShaderSource
+#define glGetString                     cocos2d::GLNull::getString
+#define glGetTexParameterfv             cocos2d::GLNull::getTexParameterfv
+#define glGetUniformfv                  cocos2d::GLNull::getUniformfv
+#define glGetUniformiv                  cocos2d::GLNull::getUniformiv
+#define glGetUniformLocation            cocos2d::GLNull::getUniformLocation
+#define glHint                          cocos2d::GLNull::hint
+#define glInsertEventMarkerEXT          cocos2d::GLNull::insertEventMarker
+#define glIsBuffer                      cocos2d::GLNull::isBuffer
+#define glIsEnabled                     cocos2d::GLNull::isEnabled
+#define glIsFramebuffer                 cocos2d::GLNull::isFramebuffer
+#define glIsProgram                     cocos2d::GLNull::isProgram
+#define glIsRenderbuffer                cocos2d::GLNull::isRenderbuffer
+#define glIsShader                      cocos2d::GLNull::isShader
+#define glIsTexture                     cocos2d::GLNull::isTexture
+#define glLineWidth                     cocos2d::GLNull::lineWidth
+#define glLinkProgram                   cocos2d::GLNull::linkProgram
+#define glMapBuffer                     cocos2d::GLNull::mapBuffer
+#define glMapBufferOES                  cocos2d::GLNull::mapBuffer
+#define glPixelStorei                   cocos2d::GLNull::pixelStorei
+#define glPolygonOffset                 cocos2d::GLNull::polygonOffset
+#define glPopGroupMarkerEXT             cocos2d::GLNull::popGroupMarker
+#define glPushGroupMarkerEXT            cocos2d::GLNull::pushGroupMarker
+#define glReadPixels                    cocos2d::GLNull::readPixels
+#define glReleaseShaderCompiler         cocos2d::GLNull::releaseShaderCompiler
+#define glRenderbufferStorage           cocos2d::GLNull::renderbufferStorage
+#define glSampleCoverage                cocos2d::GLNull::sampleCoverage
+#define glScissor                       cocos2d::GLNull::scissor
+#define glShaderSource                  cocos2d::GLNull::shaderSource
+#define glStencilFunc                   cocos2d::GLNull::stencilFunc
+#define glStencilFuncSeparate           cocos2d::GLNull::stencilFuncSeparate
+#define glStencilMask                   cocos2d::GLNull::stencilMask
+#define glStencilMaskSeparate           cocos2d::GLNull::stencilMaskSeparate
+#define glStencilOp                     cocos2d::GLNull::stencilOp
+#define glStencilOpSeparate             cocos2d::GLNull::stencilOpSeparate
+#define glTexImage2D                    cocos2d::GLNull::texImage2D
+#define glTexParameterf                 cocos2d::GLNull::texParameterf
+#define glTexParameteri                 cocos2d::GLNull::texParameteri
+#define glTexSubImage2D                 cocos2d::GLNull::texSubImage2D
+#define glUniform1f                     cocos2d::GLNull::uniform1f
+#define glUniform1fv                    cocos2d::GLNull::uniform1fv
+#define glUniform1i                     cocos2d::GLNull::uniform1i
+#define glUniform1iv                    cocos2d::GLNull::uniform1iv
+#define glUniform2f                     cocos2d::GLNull::uniform2f
+#define glUniform2fv                    cocos2d::GLNull::uniform2fv
+#define glUniform2i                     cocos2d::GLNull::uniform2i
+#define glUniform2iv                    cocos2d::GLNull::uniform2iv
+#define glUniform3f                     cocos2d::GLNull::uniform3f
+#define glUniform3fv                    cocos2d::GLNull::uniform3fv
+#define glUniform3i                     cocos2d::GLNull::uniform3i
+#define glUniform3iv                    cocos2d::GLNull::uniform3iv
+#define glUniform4f                     cocos2d::GLNull::uniform4f
+#define glUniform4fv                    cocos2d::GLNull::uniform4fv
+#define glUniform4i                     cocos2d::GLNull::uniform4i
+#define glUniform4iv                    cocos2d::GLNull::uniform4iv
+#define glUniformMatrix2fv              cocos2d::GLNull::uniformMatrix2fv
+#define glUniformMatrix3fv              cocos2d::GLNull::uniformMatrix3fv
+#define glUniformMatrix4fv              cocos2d::GLNull::uniformMatrix4fv
+#define glUnmapBuffer                   cocos2d::GLNull::unmapBuffer
+#define glUnmapBufferOES                cocos2d::GLNull::unmapBuffer
+#define glUseProgram                    cocos2d::GLNull::useProgram
+#define glValidateProgram               cocos2d::GLNull::validateProgram
+#define glVertexAttrib1f                cocos2d::GLNull::vertexAttrib1f
+#define glVertexAttrib1fv               cocos2d::GLNull::vertexAttrib1fv
+#define glVertexAttrib2f                cocos2d::GLNull::vertexAttrib2f
+#define glVertexAttrib2fv               cocos2d::GLNull::vertexAttrib2fv
+#define glVertexAttrib3f                cocos2d::GLNull::vertexAttrib3f
+#define glVertexAttrib3fv               cocos2d::GLNull::vertexAttrib3fv
+#define glVertexAttrib4f                cocos2d::GLNull::vertexAttrib4f
+#define glVertexAttrib4fv               cocos2d::GLNull::vertexAttrib4fv
+#define glVertexAttribDivisor           cocos2d::GLNull::vertexAttribDivisor
+#define glVertexAttribDivisorARB        cocos2d::GLNull::vertexAttribDivisor
+#define glVertexAttribDivisorEXT        cocos2d::GLNull::vertexAttribDivisor
+#define glVertexAttribPointer           cocos2d::GLNull::vertexAttribPointer
+#define glViewport                      cocos2d::GLNull::viewport
+
+/// @endcond
+#endif // __PLATFORM_CCGLNULL_H__
@@ -0,0 +1,128 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/CCGLViewNull.h"
+
+#include <chrono>
+
+#include "platform/CCGL.h"
+#include "base/CCDirector.h"
+#include "base/ccUTF8.h"
+#include "2d/CCScene.h"
+
+NS_CC_BEGIN
+
+GLViewNull* GLViewNull::create(const std::string& viewName, const Size& frameSize)
+{
+    auto ret = new (std::nothrow) GLViewNull();
+    if (ret && ret->initWithSize(viewName, frameSize))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+GLViewNull::GLViewNull()
+: _shouldClose(false)
+, _presentedFrames(0)
+{
+}
+
+GLViewNull::~GLViewNull()
+{
+}
+
+bool GLViewNull::initWithSize(const std::string& viewName, const Size& frameSize)
+{
+    setViewName(viewName);
+    setFrameSize(frameSize.width, frameSize.height);
+
+#if !CC_USE_NULL_GL
+    CCLOG("cocos2d: GLViewNull does not create a GL context, enable CC_USE_NULL_GL to render without one.");
+#endif
+    return true;
+}
+
+void GLViewNull::end()
+{
+    _shouldClose = true;
+    // Release self. Otherwise, GLViewNull could not be freed.
+    release();
+}
+
+void GLViewNull::swapBuffers()
+{
+    ++_presentedFrames;
+}
+
+std::string GLViewNull::runBenchmark(Scene* scene, const Size& frameSize, int frames)
+{
+    static const int WARM_UP_FRAMES = 10;
+
+    auto director = Director::getInstance();
+    CCASSERT(director->getOpenGLView() == nullptr, "The Director already has a view");
+    auto view = GLViewNull::create("GLViewNull", frameSize);
+    if (view == nullptr || scene == nullptr || frames <= 0)
+    {
+        return "GLViewNull: nothing to run\n";
+    }
+    view->setDesignResolutionSize(frameSize.width, frameSize.height, ResolutionPolicy::SHOW_ALL);
+    director->setOpenGLView(view);
+    director->runWithScene(scene);
+
+    for (int i = 0; i < WARM_UP_FRAMES; ++i)
+    {
+        director->mainLoop();
+    }
+
+#if CC_USE_NULL_GL
+    GLNull::resetStats();
+#endif
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        director->mainLoop();
+    }
+    auto end = std::chrono::steady_clock::now();
+    float milliseconds = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end - start).count();
+
+    std::string report = StringUtils::format("%d frames of %dx%d: %.3f ms per frame\n",
+                                             frames, (int)frameSize.width, (int)frameSize.height, milliseconds / frames);
+#if CC_USE_NULL_GL
+    const GLNull::Stats& stats = GLNull::getStats();
+    report += StringUtils::format("per frame: %.1f GL calls, %.1f draw calls, %.1f vertices, %.1f state changes, %.1f uniform updates\n",
+                                  stats.calls / (float)frames, stats.drawCalls / (float)frames, stats.drawnVertices / (float)frames,
+                                  stats.stateChanges / (float)frames, stats.uniformUpdates / (float)frames);
+    report += StringUtils::format("per frame: %.1f buffer uploads, %.1f texture uploads, %.1f KB uploaded\n",
+                                  stats.bufferUploads / (float)frames, stats.textureUploads / (float)frames,
+                                  stats.uploadedBytes / (1024.0f * frames));
+#else
+    report += "GL calls are not counted, CC_USE_NULL_GL is disabled\n";
+#endif
+    return report;
+}
+
+NS_CC_END
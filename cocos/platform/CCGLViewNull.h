@@ -0,0 +1,93 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_GLVIEW_NULL_H__
+#define __CC_GLVIEW_NULL_H__
+
+#include "platform/CCGLView.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * @brief A GLView without window nor GL context.
+ *
+ * Meant to be used with CC_USE_NULL_GL enabled: the Director can then run scenes offscreen,
+ * e.g. to benchmark the CPU cost of visiting and rendering a scene on a machine without GPU.
+ * Frames are "presented" by swapBuffers(), which only counts them.
+ */
+class CC_DLL GLViewNull : public GLView
+{
+public:
+    /** Creates an offscreen view whose frame has the given size in pixels. */
+    static GLViewNull* create(const std::string& viewName, const Size& frameSize);
+
+    virtual void end() override;
+    virtual bool isOpenGLReady() override { return true; }
+    virtual void swapBuffers() override;
+    virtual void setIMEKeyboardState(bool open) override {}
+    virtual bool windowShouldClose() override { return _shouldClose; }
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    virtual HWND getWin32Window() override { return nullptr; }
+#endif /* (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) */
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    virtual id getCocoaWindow() override { return nullptr; }
+#endif /* (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) */
+
+    /** Number of frames presented since the view was created. */
+    unsigned int getPresentedFrames() const { return _presentedFrames; }
+
+    /**
+     * Benchmark entry point: runs the scene on a new offscreen view and times the Director main loop.
+     * The Director must not have a view yet, call it e.g. from AppDelegate::applicationDidFinishLaunching()
+     * of a build made with CC_USE_GL_NULL=1 (see cocos/Android.mk), which enables CC_USE_NULL_GL.
+     * @param scene The scene given to Director::runWithScene().
+     * @param frameSize Size of the view in pixels, also used as design resolution.
+     * @param frames Number of timed frames, drawn after a few warm-up frames.
+     * @return A report with the CPU time per frame and, with CC_USE_NULL_GL, the GL calls per frame.
+     */
+    static std::string runBenchmark(Scene* scene, const Size& frameSize, int frames);
+
+protected:
+    GLViewNull();
+    virtual ~GLViewNull();
+
+    bool initWithSize(const std::string& viewName, const Size& frameSize);
+
+    bool _shouldClose;
+    unsigned int _presentedFrames;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_GLVIEW_NULL_H__
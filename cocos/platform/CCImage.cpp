@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "platform/CCImage.h"
 
 #include <string>
+#include <vector>
 #include <ctype.h>
 
 #include "base/CCData.h"
@@ -68,6 +69,7 @@ extern "C"
 #endif // CC_USE_JPEG
 
 #include "base/etc1.h"
+#include "base/etc2.h"
 
 }
 
@@ -82,6 +84,7 @@ extern "C"
 #include "platform/CCCommon.h"
 #include "platform/CCStdC.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCDecodedImageCache.h"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
@@ -281,6 +284,191 @@ namespace
 }
 //pvr structure end
 
+//////////////////////////////////////////////////////////////////////////
+//struct and data for ktx structure
+
+namespace
+{
+    static const unsigned char KTX_V1_IDENTIFIER[] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static const unsigned char KTX_V2_IDENTIFIER[] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    static const uint32_t KTX_ENDIANNESS = 0x04030201;
+    static const uint32_t KTX_ENDIANNESS_SWAPPED = 0x01020304;
+
+    // KHR_DF_FLAG_ALPHA_PREMULTIPLIED, in the flags byte of the basic data format descriptor
+    static const int KTX2_DFD_FLAGS_OFFSET = 15;
+    static const unsigned char KTX2_DFD_FLAG_ALPHA_PREMULTIPLIED = 1;
+
+    enum class KTXGLFormat : uint32_t
+    {
+        UNSIGNED_BYTE                   = 0x1401,
+        RGB                             = 0x1907,
+        RGBA                            = 0x1908,
+        ETC1_RGB8                       = 0x8D64,
+        COMPRESSED_RGB8_ETC2            = 0x9274,
+        COMPRESSED_SRGB8_ETC2           = 0x9275,
+        COMPRESSED_RGBA8_ETC2_EAC       = 0x9278,
+        COMPRESSED_SRGB8_ALPHA8_ETC2_EAC = 0x9279,
+        COMPRESSED_RGBA_ASTC_4x4        = 0x93B0,
+        COMPRESSED_RGBA_ASTC_5x5        = 0x93B2,
+        COMPRESSED_RGBA_ASTC_6x6        = 0x93B4,
+        COMPRESSED_RGBA_ASTC_8x8        = 0x93B7,
+        COMPRESSED_SRGB8_ALPHA8_ASTC_4x4 = 0x93D0,
+        COMPRESSED_SRGB8_ALPHA8_ASTC_5x5 = 0x93D2,
+        COMPRESSED_SRGB8_ALPHA8_ASTC_6x6 = 0x93D4,
+        COMPRESSED_SRGB8_ALPHA8_ASTC_8x8 = 0x93D7,
+    };
+
+    enum class KTXVkFormat : uint32_t
+    {
+        R8G8B8_UNORM                    = 23,
+        R8G8B8_SRGB                     = 29,
+        R8G8B8A8_UNORM                  = 37,
+        R8G8B8A8_SRGB                   = 43,
+        ETC2_R8G8B8_UNORM_BLOCK         = 147,
+        ETC2_R8G8B8_SRGB_BLOCK          = 148,
+        ETC2_R8G8B8A8_UNORM_BLOCK       = 151,
+        ETC2_R8G8B8A8_SRGB_BLOCK        = 152,
+        ASTC_4x4_UNORM_BLOCK            = 157,
+        ASTC_4x4_SRGB_BLOCK             = 158,
+        ASTC_5x5_UNORM_BLOCK            = 161,
+        ASTC_5x5_SRGB_BLOCK             = 162,
+        ASTC_6x6_UNORM_BLOCK            = 165,
+        ASTC_6x6_SRGB_BLOCK             = 166,
+        ASTC_8x8_UNORM_BLOCK            = 171,
+        ASTC_8x8_SRGB_BLOCK             = 172,
+    };
+
+    // sRGB variants are loaded as their linear counterparts, like every other image the engine loads
+    typedef const std::map<KTXGLFormat, Texture2D::PixelFormat> _ktx1_formathash;
+
+    static const _ktx1_formathash::value_type ktx1_formathash_value[] =
+    {
+        _ktx1_formathash::value_type(KTXGLFormat::RGB,                                Texture2D::PixelFormat::RGB888),
+        _ktx1_formathash::value_type(KTXGLFormat::RGBA,                               Texture2D::PixelFormat::RGBA8888),
+        _ktx1_formathash::value_type(KTXGLFormat::ETC1_RGB8,                          Texture2D::PixelFormat::ETC),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_RGB8_ETC2,               Texture2D::PixelFormat::ETC2_RGB),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_SRGB8_ETC2,              Texture2D::PixelFormat::ETC2_RGB),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_RGBA8_ETC2_EAC,          Texture2D::PixelFormat::ETC2_RGBA),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,   Texture2D::PixelFormat::ETC2_RGBA),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_RGBA_ASTC_4x4,           Texture2D::PixelFormat::ASTC_4x4),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_RGBA_ASTC_5x5,           Texture2D::PixelFormat::ASTC_5x5),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_RGBA_ASTC_6x6,           Texture2D::PixelFormat::ASTC_6x6),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_RGBA_ASTC_8x8,           Texture2D::PixelFormat::ASTC_8x8),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_SRGB8_ALPHA8_ASTC_4x4,   Texture2D::PixelFormat::ASTC_4x4),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_SRGB8_ALPHA8_ASTC_5x5,   Texture2D::PixelFormat::ASTC_5x5),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_SRGB8_ALPHA8_ASTC_6x6,   Texture2D::PixelFormat::ASTC_6x6),
+        _ktx1_formathash::value_type(KTXGLFormat::COMPRESSED_SRGB8_ALPHA8_ASTC_8x8,   Texture2D::PixelFormat::ASTC_8x8),
+    };
+
+    static const _ktx1_formathash ktx1_formathash(ktx1_formathash_value, ktx1_formathash_value + sizeof(ktx1_formathash_value) / sizeof(ktx1_formathash_value[0]));
+
+    typedef const std::map<KTXVkFormat, Texture2D::PixelFormat> _ktx2_formathash;
+
+    static const _ktx2_formathash::value_type ktx2_formathash_value[] =
+    {
+        _ktx2_formathash::value_type(KTXVkFormat::R8G8B8_UNORM,                Texture2D::PixelFormat::RGB888),
+        _ktx2_formathash::value_type(KTXVkFormat::R8G8B8_SRGB,                 Texture2D::PixelFormat::RGB888),
+        _ktx2_formathash::value_type(KTXVkFormat::R8G8B8A8_UNORM,              Texture2D::PixelFormat::RGBA8888),
+        _ktx2_formathash::value_type(KTXVkFormat::R8G8B8A8_SRGB,               Texture2D::PixelFormat::RGBA8888),
+        _ktx2_formathash::value_type(KTXVkFormat::ETC2_R8G8B8_UNORM_BLOCK,     Texture2D::PixelFormat::ETC2_RGB),
+        _ktx2_formathash::value_type(KTXVkFormat::ETC2_R8G8B8_SRGB_BLOCK,      Texture2D::PixelFormat::ETC2_RGB),
+        _ktx2_formathash::value_type(KTXVkFormat::ETC2_R8G8B8A8_UNORM_BLOCK,   Texture2D::PixelFormat::ETC2_RGBA),
+        _ktx2_formathash::value_type(KTXVkFormat::ETC2_R8G8B8A8_SRGB_BLOCK,    Texture2D::PixelFormat::ETC2_RGBA),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_4x4_UNORM_BLOCK,        Texture2D::PixelFormat::ASTC_4x4),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_4x4_SRGB_BLOCK,         Texture2D::PixelFormat::ASTC_4x4),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_5x5_UNORM_BLOCK,        Texture2D::PixelFormat::ASTC_5x5),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_5x5_SRGB_BLOCK,         Texture2D::PixelFormat::ASTC_5x5),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_6x6_UNORM_BLOCK,        Texture2D::PixelFormat::ASTC_6x6),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_6x6_SRGB_BLOCK,         Texture2D::PixelFormat::ASTC_6x6),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_8x8_UNORM_BLOCK,        Texture2D::PixelFormat::ASTC_8x8),
+        _ktx2_formathash::value_type(KTXVkFormat::ASTC_8x8_SRGB_BLOCK,         Texture2D::PixelFormat::ASTC_8x8),
+    };
+
+    static const _ktx2_formathash ktx2_formathash(ktx2_formathash_value, ktx2_formathash_value + sizeof(ktx2_formathash_value) / sizeof(ktx2_formathash_value[0]));
+
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t endianness;
+        uint32_t glType;
+        uint32_t glTypeSize;
+        uint32_t glFormat;
+        uint32_t glInternalFormat;
+        uint32_t glBaseInternalFormat;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t numberOfArrayElements;
+        uint32_t numberOfFaces;
+        uint32_t numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+    } KTXv1TexHeader;
+
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    } KTXv2TexHeader;
+
+    typedef struct
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    } KTXv2LevelIndex;
+
+    // the smallest valid size of one mip level, uncompressed levels must not have padded rows
+    static ssize_t getKTXLevelSize(Texture2D::PixelFormat format, int width, int height)
+    {
+        int block = 1;
+        int blockBytes = Texture2D::getPixelFormatInfoMap().at(format).bpp / 8;
+        switch (format)
+        {
+            case Texture2D::PixelFormat::ETC:
+            case Texture2D::PixelFormat::ETC2_RGB:
+                block = 4;
+                blockBytes = 8;
+                break;
+            case Texture2D::PixelFormat::ETC2_RGBA:
+            case Texture2D::PixelFormat::ASTC_4x4:
+                block = 4;
+                blockBytes = 16;
+                break;
+            case Texture2D::PixelFormat::ASTC_5x5:
+                block = 5;
+                blockBytes = 16;
+                break;
+            case Texture2D::PixelFormat::ASTC_6x6:
+                block = 6;
+                blockBytes = 16;
+                break;
+            case Texture2D::PixelFormat::ASTC_8x8:
+                block = 8;
+                blockBytes = 16;
+                break;
+            default:
+                break;
+        }
+        return static_cast<ssize_t>((width + block - 1) / block) * ((height + block - 1) / block) * blockBytes;
+    }
+}
+//ktx structure end
+
 namespace
 {
     typedef struct
@@ -324,6 +512,24 @@ Texture2D::PixelFormat getDevicePixelFormat(Texture2D::PixelFormat format)
                 return format;
             else
                 return Texture2D::PixelFormat::RGB888;
+        case Texture2D::PixelFormat::ETC2_RGB:
+            if(Configuration::getInstance()->supportsETC2())
+                return format;
+            else
+                return Texture2D::PixelFormat::RGB888;
+        case Texture2D::PixelFormat::ETC2_RGBA:
+            if(Configuration::getInstance()->supportsETC2())
+                return format;
+            else
+                return Texture2D::PixelFormat::RGBA8888;
+        case Texture2D::PixelFormat::ASTC_4x4:
+        case Texture2D::PixelFormat::ASTC_5x5:
+        case Texture2D::PixelFormat::ASTC_6x6:
+        case Texture2D::PixelFormat::ASTC_8x8:
+            if(Configuration::getInstance()->supportsASTC())
+                return format;
+            else
+                return Texture2D::PixelFormat::RGBA8888;
         default:
             return format;
     }
@@ -342,6 +548,7 @@ Image::Image()
 , _unpack(false)
 , _fileType(Format::UNKNOWN)
 , _renderFormat(Texture2D::PixelFormat::NONE)
+, _targetFormat(Texture2D::PixelFormat::NONE)
 , _numberOfMipmaps(0)
 , _hasPremultipliedAlpha(true)
 {
@@ -359,22 +566,76 @@ Image::~Image()
         CC_SAFE_FREE(_data);
 }
 
+namespace
+{
+    // Unwraps ccz and gzip buffers. The result is data itself when it isn't wrapped,
+    // otherwise a buffer the caller frees, or nullptr if it couldn't be inflated.
+    ssize_t unpackImageData(const unsigned char* data, ssize_t dataLen, unsigned char** outData)
+    {
+        if (ZipUtils::isCCZBuffer(data, dataLen))
+        {
+            return ZipUtils::inflateCCZBuffer(data, dataLen, outData);
+        }
+        else if (ZipUtils::isGZipBuffer(data, dataLen))
+        {
+            return ZipUtils::inflateMemory(const_cast<unsigned char*>(data), dataLen, outData);
+        }
+        *outData = const_cast<unsigned char*>(data);
+        return dataLen;
+    }
+}
+
 bool Image::initWithImageFile(const std::string& path)
+{
+    return initWithImageFile(path, Texture2D::PixelFormat::NONE);
+}
+
+bool Image::initWithImageFile(const std::string& path, Texture2D::PixelFormat format)
 {
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
+    _targetFormat = format;
+
+    DecodedImageCache* decodedImageCache = DecodedImageCache::getInstance();
+    if (decodedImageCache->loadImage(_filePath, format, this))
+    {
+        return true;
+    }
 
     Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
 
     if (!data.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        unsigned char* unpackedData = nullptr;
+        ssize_t unpackedLen = unpackImageData(data.getBytes(), data.getSize(), &unpackedData);
+        bool unpacked = unpackedData != data.getBytes();
+        if (unpacked)
+        {
+            // the packed file isn't needed any more, don't keep it alive during the decode
+            data.clear();
+        }
+
+        ret = initWithUnpackedImageData(unpackedData, unpackedLen);
+        if (unpacked)
+        {
+            free(unpackedData);
+        }
+
+        if (ret)
+        {
+            decodedImageCache->saveImage(_filePath, format, this);
+        }
     }
 
     return ret;
 }
 
 bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
+{
+    return initWithImageData(data, dataLen, Texture2D::PixelFormat::NONE);
+}
+
+bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format)
 {
     bool ret = false;
 
@@ -382,23 +643,30 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
     {
         CC_BREAK_IF(! data || dataLen <= 0);
 
-        unsigned char* unpackedData = nullptr;
-        ssize_t unpackedLen = 0;
+        _targetFormat = format;
 
         //detect and unzip the compress file
-        if (ZipUtils::isCCZBuffer(data, dataLen))
-        {
-            unpackedLen = ZipUtils::inflateCCZBuffer(data, dataLen, &unpackedData);
-        }
-        else if (ZipUtils::isGZipBuffer(data, dataLen))
-        {
-            unpackedLen = ZipUtils::inflateMemory(const_cast<unsigned char*>(data), dataLen, &unpackedData);
-        }
-        else
+        unsigned char* unpackedData = nullptr;
+        ssize_t unpackedLen = unpackImageData(data, dataLen, &unpackedData);
+
+        ret = initWithUnpackedImageData(unpackedData, unpackedLen);
+
+        if(unpackedData != data)
         {
-            unpackedData = const_cast<unsigned char*>(data);
-            unpackedLen = dataLen;
+            free(unpackedData);
         }
+    } while (0);
+
+    return ret;
+}
+
+bool Image::initWithUnpackedImageData(const unsigned char * unpackedData, ssize_t unpackedLen)
+{
+    bool ret = false;
+
+    do
+    {
+        CC_BREAK_IF(! unpackedData || unpackedLen <= 0);
 
         _fileType = detectFormat(unpackedData, unpackedLen);
 
@@ -422,10 +690,13 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ETC:
             ret = initWithETCData(unpackedData, unpackedLen);
             break;
+        case Format::KTX:
+            ret = initWithKTXData(unpackedData, unpackedLen);
+            break;
         default:
             {
                 // load and detect image format
-                tImageTGA* tgaData = tgaLoadBuffer(unpackedData, unpackedLen);
+                tImageTGA* tgaData = tgaLoadBuffer(const_cast<unsigned char*>(unpackedData), unpackedLen);
 
                 if (tgaData != nullptr && tgaData->status == TGA_OK)
                 {
@@ -440,11 +711,6 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
                 break;
             }
         }
-
-        if(unpackedData != data)
-        {
-            free(unpackedData);
-        }
     } while (0);
 
     return ret;
@@ -467,6 +733,17 @@ bool Image::isEtc(const unsigned char * data, ssize_t dataLen)
     return etc1_pkm_is_valid((etc1_byte*)data) ? true : false;
 }
 
+bool Image::isKtx(const unsigned char * data, ssize_t dataLen)
+{
+    if (dataLen <= static_cast<ssize_t>(sizeof(KTX_V1_IDENTIFIER)))
+    {
+        return false;
+    }
+
+    return memcmp(data, KTX_V1_IDENTIFIER, sizeof(KTX_V1_IDENTIFIER)) == 0
+        || memcmp(data, KTX_V2_IDENTIFIER, sizeof(KTX_V2_IDENTIFIER)) == 0;
+}
+
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -546,6 +823,10 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::ETC;
     }
+    else if (isKtx(data, dataLen))
+    {
+        return Format::KTX;
+    }
     else
     {
         return Format::UNKNOWN;
@@ -691,17 +972,39 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
         _height = cinfo.output_height;
         _hasPremultipliedAlpha = false;
 
-        _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        CC_BREAK_IF(! _data);
+        if (needsTargetFormatConversion())
+        {
+            /* decode each scan line into a single row buffer and convert it to the target format */
+            unsigned int rowStride = cinfo.output_width*cinfo.output_components;
+            JSAMPARRAY rowBuffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, rowStride, 1);
+            ssize_t targetRowBytes = (ssize_t)_width * Texture2D::getPixelFormatInfoMap().at(_targetFormat).bpp / 8;
+
+            _dataLen = targetRowBytes * _height;
+            _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+            CC_BREAK_IF(! _data);
 
-        /* now actually read the jpeg into the raw buffer */
-        /* read one scan line at a time */
-        while (cinfo.output_scanline < cinfo.output_height)
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                unsigned char* targetRow = _data + cinfo.output_scanline * targetRowBytes;
+                jpeg_read_scanlines(&cinfo, rowBuffer, 1);
+                Texture2D::convertDataToFormat(rowBuffer[0], rowStride, _renderFormat, _targetFormat, targetRow);
+            }
+            _renderFormat = _targetFormat;
+        }
+        else
         {
-            row_pointer[0] = _data + location;
-            location += cinfo.output_width*cinfo.output_components;
-            jpeg_read_scanlines(&cinfo, row_pointer, 1);
+            _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
+            _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+            CC_BREAK_IF(! _data);
+
+            /* now actually read the jpeg into the raw buffer */
+            /* read one scan line at a time */
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                row_pointer[0] = _data + location;
+                location += cinfo.output_width*cinfo.output_components;
+                jpeg_read_scanlines(&cinfo, row_pointer, 1);
+            }
         }
 
         /* When read image file with broken data, jpeg_finish_decompress() may cause error.
@@ -733,6 +1036,8 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
     png_byte        header[PNGSIGSIZE]   = {0};
     png_structp     png_ptr     =   0;
     png_infop       info_ptr    = 0;
+    // declared out of the setjmp scope, so that a libpng error doesn't skip its destructor
+    std::vector<png_byte> rowBuffer;
 
     do
     {
@@ -825,6 +1130,35 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
                 break;
         }
 
+        // decode straight to the target format, one row at a time, when rows aren't interlaced
+        if (needsTargetFormatConversion() && png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE)
+        {
+            png_size_t sourceRowBytes = png_get_rowbytes(png_ptr, info_ptr);
+            ssize_t targetRowBytes = (ssize_t)_width * Texture2D::getPixelFormatInfoMap().at(_targetFormat).bpp / 8;
+            bool premultiply = PNG_PREMULTIPLIED_ALPHA_ENABLED && color_type == PNG_COLOR_TYPE_RGB_ALPHA;
+
+            _dataLen = targetRowBytes * _height;
+            _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+            CC_BREAK_IF(! _data);
+
+            rowBuffer.resize(sourceRowBytes);
+            for (int i = 0; i < _height; ++i)
+            {
+                png_read_row(png_ptr, rowBuffer.data(), nullptr);
+                if (premultiply)
+                {
+                    Texture2D::convertRGBA8888ToPremultipliedAlpha(rowBuffer.data(), sourceRowBytes);
+                }
+                Texture2D::convertDataToFormat(rowBuffer.data(), sourceRowBytes, _renderFormat, _targetFormat, _data + i * targetRowBytes);
+            }
+            png_read_end(png_ptr, nullptr);
+
+            _renderFormat = _targetFormat;
+            _hasPremultipliedAlpha = premultiply;
+            ret = true;
+            break;
+        }
+
         // read png data
         png_size_t rowbytes;
         png_bytep* row_pointers = (png_bytep*)malloc( sizeof(png_bytep) * _height );
@@ -1483,6 +1817,284 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
     return false;
 }
 
+bool Image::initWithKTXData(const unsigned char * data, ssize_t dataLen)
+{
+    if (dataLen > static_cast<ssize_t>(sizeof(KTX_V2_IDENTIFIER)) && memcmp(data, KTX_V2_IDENTIFIER, sizeof(KTX_V2_IDENTIFIER)) == 0)
+    {
+        return initWithKTXv2Data(data, dataLen);
+    }
+    return initWithKTXv1Data(data, dataLen);
+}
+
+bool Image::initWithKTXv1Data(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTXv1TexHeader))
+    {
+        return false;
+    }
+
+    const KTXv1TexHeader *header = static_cast<const KTXv1TexHeader *>(static_cast<const void*>(data));
+
+    // the writer's endianness, usually little
+    bool swapped = header->endianness == KTX_ENDIANNESS_SWAPPED;
+    if (!swapped && header->endianness != KTX_ENDIANNESS)
+    {
+        CCLOG("cocos2d: WARNING: ktx file has an invalid endianness");
+        return false;
+    }
+    auto read = [swapped](uint32_t value) { return swapped ? CC_SWAP32(value) : value; };
+
+    int width = read(header->pixelWidth);
+    int height = read(header->pixelHeight);
+    if (width == 0 || height == 0 || read(header->pixelDepth) > 1 || read(header->numberOfArrayElements) > 0 || read(header->numberOfFaces) != 1)
+    {
+        CCLOG("cocos2d: WARNING: only 2D ktx textures are supported");
+        return false;
+    }
+
+    // glType is 0 for compressed data, uncompressed data is described by glFormat
+    uint32_t glType = read(header->glType);
+    KTXGLFormat glFormat = static_cast<KTXGLFormat>(glType == 0 ? read(header->glInternalFormat) : read(header->glFormat));
+    if ((glType != 0 && glType != static_cast<uint32_t>(KTXGLFormat::UNSIGNED_BYTE)) || ktx1_formathash.find(glFormat) == ktx1_formathash.end())
+    {
+        CCLOG("cocos2d: WARNING: Unsupported ktx format: glType 0x%04X, glFormat 0x%04X", glType, static_cast<uint32_t>(glFormat));
+        return false;
+    }
+
+    int numberOfLevels = MAX(static_cast<int>(read(header->numberOfMipmapLevels)), 1);
+    if (numberOfLevels > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: ktx file has too many mipmap levels: %d", numberOfLevels);
+        return false;
+    }
+
+    const unsigned char* levels[MIPMAP_MAX];
+    ssize_t lengths[MIPMAP_MAX];
+    ssize_t dataOffset = sizeof(KTXv1TexHeader) + read(header->bytesOfKeyValueData);
+
+    // each level is its imageSize followed by the data, padded to 4 bytes
+    for (int i = 0; i < numberOfLevels; ++i)
+    {
+        if (dataOffset + 4 > dataLen)
+        {
+            CCLOG("cocos2d: WARNING: ktx file is truncated");
+            return false;
+        }
+        uint32_t imageSize;
+        memcpy(&imageSize, data + dataOffset, sizeof(imageSize));
+        imageSize = read(imageSize);
+        dataOffset += 4;
+        if (static_cast<size_t>(dataOffset) + imageSize > static_cast<size_t>(dataLen))
+        {
+            CCLOG("cocos2d: WARNING: ktx file is truncated");
+            return false;
+        }
+        levels[i] = data + dataOffset;
+        lengths[i] = imageSize;
+        dataOffset += (imageSize + 3) & ~3;
+    }
+
+    // uncompressed rows are padded to 4 bytes, as with the default GL_UNPACK_ALIGNMENT
+    return initWithKTXLevels(ktx1_formathash.at(glFormat), width, height, levels, lengths, numberOfLevels, 4, false);
+}
+
+bool Image::initWithKTXv2Data(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTXv2TexHeader))
+    {
+        return false;
+    }
+
+    // KTX 2 is always little endian
+    const KTXv2TexHeader *header = static_cast<const KTXv2TexHeader *>(static_cast<const void*>(data));
+
+    int width = CC_SWAP_INT32_LITTLE_TO_HOST(header->pixelWidth);
+    int height = CC_SWAP_INT32_LITTLE_TO_HOST(header->pixelHeight);
+    if (width == 0 || height == 0 || CC_SWAP_INT32_LITTLE_TO_HOST(header->pixelDepth) > 1
+        || CC_SWAP_INT32_LITTLE_TO_HOST(header->layerCount) > 0 || CC_SWAP_INT32_LITTLE_TO_HOST(header->faceCount) != 1)
+    {
+        CCLOG("cocos2d: WARNING: only 2D ktx textures are supported");
+        return false;
+    }
+
+    if (header->supercompressionScheme != 0)
+    {
+        CCLOG("cocos2d: WARNING: supercompressed ktx2 files are not supported, scheme %u", CC_SWAP_INT32_LITTLE_TO_HOST(header->supercompressionScheme));
+        return false;
+    }
+
+    KTXVkFormat vkFormat = static_cast<KTXVkFormat>(CC_SWAP_INT32_LITTLE_TO_HOST(header->vkFormat));
+    if (ktx2_formathash.find(vkFormat) == ktx2_formathash.end())
+    {
+        CCLOG("cocos2d: WARNING: Unsupported ktx2 format: vkFormat %u", static_cast<uint32_t>(vkFormat));
+        return false;
+    }
+
+    // levelCount 0 asks the loader to generate the mipmaps, the file still holds the base level
+    int numberOfLevels = MAX(static_cast<int>(CC_SWAP_INT32_LITTLE_TO_HOST(header->levelCount)), 1);
+    if (numberOfLevels > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: ktx file has too many mipmap levels: %d", numberOfLevels);
+        return false;
+    }
+    if (sizeof(KTXv2TexHeader) + numberOfLevels * sizeof(KTXv2LevelIndex) > static_cast<size_t>(dataLen))
+    {
+        CCLOG("cocos2d: WARNING: ktx file is truncated");
+        return false;
+    }
+
+    const KTXv2LevelIndex* levelIndex = static_cast<const KTXv2LevelIndex*>(static_cast<const void*>(data + sizeof(KTXv2TexHeader)));
+    const unsigned char* levels[MIPMAP_MAX];
+    ssize_t lengths[MIPMAP_MAX];
+
+    // the index starts with the base level, whatever the order of the data in the file
+    for (int i = 0; i < numberOfLevels; ++i)
+    {
+        uint64_t offset = levelIndex[i].byteOffset;
+        uint64_t length = levelIndex[i].byteLength;
+        if (offset > static_cast<uint64_t>(dataLen) || length > static_cast<uint64_t>(dataLen) - offset)
+        {
+            CCLOG("cocos2d: WARNING: ktx file is truncated");
+            return false;
+        }
+        levels[i] = data + offset;
+        lengths[i] = static_cast<ssize_t>(length);
+    }
+
+    bool premultiplied = false;
+    uint32_t dfdOffset = CC_SWAP_INT32_LITTLE_TO_HOST(header->dfdByteOffset);
+    if (dfdOffset != 0 && CC_SWAP_INT32_LITTLE_TO_HOST(header->dfdByteLength) > KTX2_DFD_FLAGS_OFFSET
+        && dfdOffset + KTX2_DFD_FLAGS_OFFSET < static_cast<size_t>(dataLen))
+    {
+        premultiplied = (data[dfdOffset + KTX2_DFD_FLAGS_OFFSET] & KTX2_DFD_FLAG_ALPHA_PREMULTIPLIED) != 0;
+    }
+
+    return initWithKTXLevels(ktx2_formathash.at(vkFormat), width, height, levels, lengths, numberOfLevels, 1, premultiplied);
+}
+
+bool Image::initWithKTXLevels(Texture2D::PixelFormat format, int width, int height, const unsigned char* const* levels,
+                              const ssize_t* lengths, int numberOfLevels, int rowAlignment, bool premultiplied)
+{
+    // there is no ASTC software decoder, see initWithImageData()
+    if (format >= Texture2D::PixelFormat::ASTC_4x4 && format <= Texture2D::PixelFormat::ASTC_8x8 && !Configuration::getInstance()->supportsASTC())
+    {
+        CCLOGERROR("cocos2d: ERROR: ASTC ktx textures are not supported on this device and are not decoded by software");
+        return false;
+    }
+
+    // uncompressed levels are stored with rows padded to rowAlignment, and uploaded with tightly packed rows
+    const bool compressed = Texture2D::getPixelFormatInfoMap().at(format).compressed;
+    const int bytesPerPixel = Texture2D::getPixelFormatInfoMap().at(format).bpp / 8;
+    ssize_t tightLengths[MIPMAP_MAX];
+    int levelWidth = width;
+    int levelHeight = height;
+    for (int i = 0; i < numberOfLevels; ++i)
+    {
+        ssize_t expected = getKTXLevelSize(format, levelWidth, levelHeight);
+        tightLengths[i] = compressed ? lengths[i] : expected;
+        if (!compressed)
+        {
+            ssize_t rowLength = levelWidth * bytesPerPixel;
+            expected = ((rowLength + rowAlignment - 1) / rowAlignment * rowAlignment) * levelHeight;
+        }
+        if (lengths[i] < expected || (!compressed && lengths[i] != expected))
+        {
+            CCLOG("cocos2d: WARNING: ktx mipmap level %d has an invalid size", i);
+            return false;
+        }
+        levelWidth = MAX(levelWidth >> 1, 1);
+        levelHeight = MAX(levelHeight >> 1, 1);
+    }
+
+    _width = width;
+    _height = height;
+    _hasPremultipliedAlpha = premultiplied;
+
+    Texture2D::PixelFormat deviceFormat = getDevicePixelFormat(format);
+    if (deviceFormat == format)
+    {
+        // upload the whole mip chain as stored in the file
+        _renderFormat = format;
+        _dataLen = 0;
+        for (int i = 0; i < numberOfLevels; ++i)
+        {
+            _dataLen += tightLengths[i];
+        }
+        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+
+        ssize_t dataOffset = 0;
+        levelWidth = width;
+        levelHeight = height;
+        for (int i = 0; i < numberOfLevels; ++i)
+        {
+            if (tightLengths[i] == lengths[i])
+            {
+                memcpy(_data + dataOffset, levels[i], lengths[i]);
+            }
+            else
+            {
+                // drop the row padding
+                ssize_t rowLength = levelWidth * bytesPerPixel;
+                ssize_t paddedRowLength = lengths[i] / levelHeight;
+                for (int row = 0; row < levelHeight; ++row)
+                {
+                    memcpy(_data + dataOffset + row * rowLength, levels[i] + row * paddedRowLength, rowLength);
+                }
+            }
+            _mipmaps[i].address = _data + dataOffset;
+            _mipmaps[i].len = static_cast<int>(tightLengths[i]);
+            dataOffset += tightLengths[i];
+            levelWidth = MAX(levelWidth >> 1, 1);
+            levelHeight = MAX(levelHeight >> 1, 1);
+        }
+        _numberOfMipmaps = numberOfLevels;
+        return true;
+    }
+
+    // decode the base level only, the software path trades the mip chain for memory
+    int bytePerPixel = deviceFormat == Texture2D::PixelFormat::RGBA8888 ? 4 : 3;
+    unsigned int stride = width * bytePerPixel;
+    unsigned char* decoded = nullptr;
+    int result = -1;
+    switch (format)
+    {
+        case Texture2D::PixelFormat::ETC:
+            CCLOG("cocos2d: Hardware ETC1 decoder not present. Using software decoder");
+            decoded = new (std::nothrow) unsigned char[width * height * bytePerPixel];
+            result = decoded ? etc1_decode_image(levels[0], decoded, width, height, bytePerPixel, stride) : -1;
+            break;
+        case Texture2D::PixelFormat::ETC2_RGB:
+        case Texture2D::PixelFormat::ETC2_RGBA:
+            CCLOG("cocos2d: Hardware ETC2 decoder not present. Using software decoder");
+            decoded = new (std::nothrow) unsigned char[width * height * bytePerPixel];
+            result = decoded ? etc2_decode_image(levels[0], format == Texture2D::PixelFormat::ETC2_RGBA, decoded, width, height, bytePerPixel, stride) : -1;
+            break;
+        default:
+            CCLOG("cocos2d: WARNING: ktx textures of this format are not supported on this device");
+            return false;
+    }
+
+    if (result != 0)
+    {
+        CC_SAFE_DELETE_ARRAY(decoded);
+        return false;
+    }
+
+    _unpack = true;
+    _renderFormat = deviceFormat;
+    _numberOfMipmaps = 1;
+    _mipmaps[0].address = decoded;
+    _mipmaps[0].len = width * height * bytePerPixel;
+    _data = decoded;
+    _dataLen = _mipmaps[0].len;
+
+    if (bytePerPixel == 4 && !premultiplied)
+    {
+        premultipliedAlpha();
+    }
+    return true;
+}
+
 bool Image::initWithTGAData(tImageTGA* tgaData)
 {
     bool ret = false;
@@ -1906,16 +2518,19 @@ bool Image::saveImageToJPG(const std::string& filePath)
 #endif // CC_USE_JPEG
 }
 
+bool Image::needsTargetFormatConversion() const
+{
+    return _targetFormat != Texture2D::PixelFormat::NONE
+        && _targetFormat != Texture2D::PixelFormat::AUTO
+        && _targetFormat != _renderFormat
+        && Texture2D::convertDataToFormat(nullptr, 0, _renderFormat, _targetFormat, nullptr);
+}
+
 void Image::premultipliedAlpha()
 {
     if (PNG_PREMULTIPLIED_ALPHA_ENABLED && _renderFormat == Texture2D::PixelFormat::RGBA8888)
     {
-        unsigned int* fourBytes = (unsigned int*)_data;
-        for(int i = 0; i < _width * _height; i++)
-        {
-            unsigned char* p = _data + i * 4;
-            fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-        }
+        Texture2D::convertRGBA8888ToPremultipliedAlpha(_data, (ssize_t)_width * _height * 4);
 
         _hasPremultipliedAlpha = true;
     }
@@ -78,6 +78,8 @@ public:
         PVR,
         //! ETC
         ETC,
+        //! KTX (1 and 2). ASTC ones need Configuration::supportsASTC(), they have no software decoder.
+        KTX,
         //! S3TC
 //        S3TC,
         //! ATITC
@@ -112,16 +114,38 @@ public:
     */
     bool initWithImageFile(const std::string& path);
 
+    /**
+    @brief Load the image from the specified path, for a texture of the given pixel format.
+    PNG and JPEG files are decoded and converted to the format row by row, so that the image is never held
+    in both formats. Other files keep their decoded format. Texture2D::initWithImage() doesn't convert
+    the pixels again when it is given the same format.
+    @param path   the absolute file path.
+    @param format the pixel format of the texture, NONE or AUTO to keep the decoded format.
+    @return true if loaded correctly.
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageFile(const std::string& path, Texture2D::PixelFormat format);
+
     /**
     @brief Load image from stream buffer.
     @param data  stream buffer which holds the image data.
     @param dataLen  data length expressed in (number of) bytes.
     @return true if loaded correctly.
+    False for ASTC KTX files when Configuration::supportsASTC() is false: unlike ETC, ASTC is not decoded by software,
+    such files have to come with a fallback in another format.
     * @js NA
     * @lua NA
     */
     bool initWithImageData(const unsigned char * data, ssize_t dataLen);
 
+    /**
+    @brief Load image from stream buffer, for a texture of the given pixel format. See initWithImageFile(path, format).
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageData(const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format);
+
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, ssize_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
@@ -149,6 +173,7 @@ public:
     bool saveToFile(const std::string &filename, bool isToRGB = true);
 
 protected:
+    bool initWithUnpackedImageData(const unsigned char * data, ssize_t dataLen);
     bool initWithJpgData(const unsigned char *  data, ssize_t dataLen);
     bool initWithPngData(const unsigned char * data, ssize_t dataLen);
     bool initWithTiffData(const unsigned char * data, ssize_t dataLen);
@@ -157,6 +182,11 @@ protected:
     bool initWithPVRv2Data(const unsigned char * data, ssize_t dataLen);
     bool initWithPVRv3Data(const unsigned char * data, ssize_t dataLen);
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXv1Data(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXv2Data(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXLevels(Texture2D::PixelFormat format, int width, int height, const unsigned char* const* levels,
+                           const ssize_t* lengths, int numberOfLevels, int rowAlignment, bool premultiplied);
 
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
@@ -165,6 +195,8 @@ protected:
     bool saveImageToJPG(const std::string& filePath);
 
     void premultipliedAlpha();
+    // whether the decoders should convert the rows they decode in _renderFormat to _targetFormat
+    bool needsTargetFormatConversion() const;
 
 protected:
     /**
@@ -183,6 +215,8 @@ protected:
     bool _unpack;
     Format _fileType;
     Texture2D::PixelFormat _renderFormat;
+    // the format asked by initWithImageFile() or initWithImageData(), NONE to keep the decoded one
+    Texture2D::PixelFormat _targetFormat;
     MipmapInfo _mipmaps[MIPMAP_MAX];   // pointer to mipmap images
     int _numberOfMipmaps;
     // false if we can't auto detect the image is premultiplied or not.
@@ -198,6 +232,9 @@ protected:
     Image(Image&&) = delete;
     Image& operator=(Image&&) = delete;
 
+    // fills decoded images from its entries
+    friend class DecodedImageCache;
+
     /**
      * @js NA
      * @lua NA
@@ -211,6 +248,7 @@ protected:
     bool isWebp(const unsigned char * data, ssize_t dataLen);
     bool isPvr(const unsigned char * data, ssize_t dataLen);
     bool isEtc(const unsigned char * data, ssize_t dataLen);
+    bool isKtx(const unsigned char * data, ssize_t dataLen);
 };
 
 // end of platform group
@@ -0,0 +1,309 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCDynamicAtlas.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "platform/CCImage.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// every image gets a one pixel border, a copy of its edges
+static const int ATLAS_BORDER = 1;
+static const int ATLAS_BYTES_PER_PIXEL = 4;
+
+std::vector<DynamicAtlas*> DynamicAtlas::s_atlases;
+
+DynamicAtlas::DynamicAtlas(int pageSize, int maxTextureSize, int maxPageCount)
+: _pageSize(pageSize)
+, _maxTextureSize(std::min(maxTextureSize, pageSize - 2 * ATLAS_BORDER))
+, _maxPageCount(maxPageCount)
+{
+    s_atlases.push_back(this);
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    s_atlases.erase(std::find(s_atlases.begin(), s_atlases.end(), this));
+
+    // the packed textures and the sprite frames retain the pages they use, with their pixels
+    for (auto page : _pages)
+    {
+        page->texture->release();
+        delete page;
+    }
+}
+
+bool DynamicAtlas::addTexture(Texture2D* texture, Image* image)
+{
+    const int width = image->getWidth();
+    const int height = image->getHeight();
+    if (texture->_atlasTexture || width > _maxTextureSize || height > _maxTextureSize ||
+        image->isCompressed() || image->getRenderFormat() != Texture2D::PixelFormat::RGBA8888 ||
+        texture->getPixelFormat() != Texture2D::PixelFormat::RGBA8888 || texture->getPixelsWide() != width ||
+        texture->getPixelsHigh() != height || texture->isContain9PatchInfo())
+    {
+        return false;
+    }
+
+    const int paddedWidth = width + 2 * ATLAS_BORDER;
+    const int paddedHeight = height + 2 * ATLAS_BORDER;
+    const bool hasPremultipliedAlpha = texture->hasPremultipliedAlpha();
+
+    Page* page = nullptr;
+    int x = 0, y = 0;
+    for (auto candidate : _pages)
+    {
+        if (candidate->hasPremultipliedAlpha == hasPremultipliedAlpha &&
+            findPosition(candidate, _pageSize, paddedWidth, paddedHeight, &x, &y))
+        {
+            page = candidate;
+            break;
+        }
+    }
+    if (!page)
+    {
+        if ((int)_pages.size() >= _maxPageCount)
+        {
+            return false;
+        }
+        page = createPage(hasPremultipliedAlpha);
+        if (!page || !findPosition(page, _pageSize, paddedWidth, paddedHeight, &x, &y))
+        {
+            return false;
+        }
+    }
+
+    // copy the image with its edges repeated around it
+    const int rowSize = paddedWidth * ATLAS_BYTES_PER_PIXEL;
+    unsigned char* padded = (unsigned char*)malloc(rowSize * paddedHeight);
+    const unsigned char* src = image->getData();
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        const int srcRow = std::min(std::max(row - ATLAS_BORDER, 0), height - 1);
+        const unsigned char* srcLine = src + srcRow * width * ATLAS_BYTES_PER_PIXEL;
+        unsigned char* dstLine = padded + row * rowSize;
+        memcpy(dstLine, srcLine, ATLAS_BYTES_PER_PIXEL);
+        memcpy(dstLine + ATLAS_BYTES_PER_PIXEL, srcLine, width * ATLAS_BYTES_PER_PIXEL);
+        memcpy(dstLine + (paddedWidth - 1) * ATLAS_BYTES_PER_PIXEL, srcLine + (width - 1) * ATLAS_BYTES_PER_PIXEL, ATLAS_BYTES_PER_PIXEL);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    page->texture->updateWithData(padded, x, y, paddedWidth, paddedHeight);
+    if (page->pixels)
+    {
+        for (int row = 0; row < paddedHeight; ++row)
+        {
+            memcpy(page->pixels + ((y + row) * _pageSize + x) * ATLAS_BYTES_PER_PIXEL, padded + row * rowSize, rowSize);
+        }
+    }
+    free(padded);
+
+    addSkylineLevel(page, x, y, paddedWidth, paddedHeight);
+    page->textureCount++;
+
+    texture->_atlasTexture = page->texture;
+    texture->_atlasTexture->retain();
+    texture->_atlasRect.setRect(x + ATLAS_BORDER, y + ATLAS_BORDER, width, height);
+    return true;
+}
+
+void DynamicAtlas::removeTexture(Texture2D* texture)
+{
+    for (auto atlas : s_atlases)
+    {
+        for (auto page : atlas->_pages)
+        {
+            if (page->texture == texture->_atlasTexture)
+            {
+                if (--page->textureCount == 0)
+                {
+                    atlas->clearPage(page);
+                }
+                break;
+            }
+        }
+    }
+
+    CC_SAFE_RELEASE_NULL(texture->_atlasTexture);
+}
+
+int DynamicAtlas::getTextureCount() const
+{
+    int count = 0;
+    for (auto page : _pages)
+    {
+        count += page->textureCount;
+    }
+    return count;
+}
+
+DynamicAtlas::Page* DynamicAtlas::createPage(bool hasPremultipliedAlpha)
+{
+    const ssize_t dataLen = _pageSize * _pageSize * ATLAS_BYTES_PER_PIXEL;
+    unsigned char* pixels = nullptr;
+    Image* image = nullptr;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // The copy of the pixels is the buffer of an Image that VolatileTextureMgr releases with the texture:
+    // the packed textures and the sprite frames may keep the page after the atlas is gone.
+    unsigned char* blank = (unsigned char*)calloc(dataLen, 1);
+    image = new (std::nothrow) Image();
+    if (!blank || !image || !image->initWithRawData(blank, dataLen, _pageSize, _pageSize, 8, hasPremultipliedAlpha))
+    {
+        CCLOG("cocos2d: DynamicAtlas: couldn't create a %dx%d page", _pageSize, _pageSize);
+        CC_SAFE_RELEASE(image);
+        free(blank);
+        return nullptr;
+    }
+    free(blank);
+    pixels = image->getData();
+#endif
+
+    Texture2D* texture = new (std::nothrow) Texture2D();
+    if (!texture || !texture->initWithData(pixels, dataLen, Texture2D::PixelFormat::RGBA8888, _pageSize, _pageSize, Size(_pageSize, _pageSize)))
+    {
+        CCLOG("cocos2d: DynamicAtlas: couldn't create a %dx%d page", _pageSize, _pageSize);
+        CC_SAFE_RELEASE(texture);
+        CC_SAFE_RELEASE(image);
+        return nullptr;
+    }
+    texture->_hasPremultipliedAlpha = hasPremultipliedAlpha;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // The entry keeps the image, and restores the page from its buffer, which is kept up to date with all the
+    // packed images, in the page format.
+    VolatileTextureMgr::addImage(texture, image);
+    VolatileTextureMgr::addDataTexture(texture, pixels, (int)dataLen, Texture2D::PixelFormat::RGBA8888, Size(_pageSize, _pageSize));
+    image->release();
+#endif
+
+    Page* page = new (std::nothrow) Page();
+    page->texture = texture;
+    page->hasPremultipliedAlpha = hasPremultipliedAlpha;
+    page->pixels = pixels;
+    clearPage(page);
+    _pages.push_back(page);
+    return page;
+}
+
+void DynamicAtlas::clearPage(Page* page)
+{
+    // the old images stay in the texture until they are overwritten, nothing draws them anymore
+    SkylineSegment segment = {0, 0, _pageSize};
+    page->skyline.clear();
+    page->skyline.push_back(segment);
+    page->textureCount = 0;
+}
+
+bool DynamicAtlas::findPosition(const Page* page, int pageSize, int width, int height, int* x, int* y)
+{
+    // lowest position first, then leftmost
+    int bestY = pageSize;
+    int bestX = 0;
+    const auto& skyline = page->skyline;
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        const int left = skyline[i].x;
+        if (left + width > pageSize)
+        {
+            break;
+        }
+
+        // the image rests on the highest segment it spans
+        int top = 0;
+        int remaining = width;
+        for (size_t j = i; j < skyline.size() && remaining > 0; ++j)
+        {
+            top = std::max(top, skyline[j].y);
+            remaining -= skyline[j].width;
+        }
+
+        if (top + height <= pageSize && top < bestY)
+        {
+            bestY = top;
+            bestX = left;
+        }
+    }
+
+    if (bestY + height > pageSize)
+    {
+        return false;
+    }
+    *x = bestX;
+    *y = bestY;
+    return true;
+}
+
+void DynamicAtlas::addSkylineLevel(Page* page, int x, int y, int width, int height)
+{
+    auto& skyline = page->skyline;
+    SkylineSegment level = {x, y + height, width};
+
+    // replace the part of the skyline under the image by the new level
+    std::vector<SkylineSegment> result;
+    result.reserve(skyline.size() + 2);
+    for (const auto& segment : skyline)
+    {
+        const int right = segment.x + segment.width;
+        if (right <= x || segment.x >= x + width)
+        {
+            result.push_back(segment);
+            continue;
+        }
+        if (segment.x < x)
+        {
+            SkylineSegment leftPart = {segment.x, segment.y, x - segment.x};
+            result.push_back(leftPart);
+        }
+        if (segment.x <= x)
+        {
+            result.push_back(level);
+        }
+        if (right > x + width)
+        {
+            SkylineSegment rightPart = {x + width, segment.y, right - (x + width)};
+            result.push_back(rightPart);
+        }
+    }
+
+    // merge neighbours at the same height
+    skyline.clear();
+    for (const auto& segment : result)
+    {
+        if (!skyline.empty() && skyline.back().y == segment.y)
+        {
+            skyline.back().width += segment.width;
+        }
+        else
+        {
+            skyline.push_back(segment);
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,116 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_DYNAMIC_ATLAS_H__
+#define __CC_DYNAMIC_ATLAS_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Texture2D;
+class Image;
+
+/**
+ Packs small textures loaded by the TextureCache into shared pages, so sprites showing different small images can be
+ drawn in one batch. A packed texture still has its own GL texture for its other users; SpriteFrames created with it
+ are remapped to the page, see Texture2D::getAtlasTexture().
+ Only uncompressed RGBA8888 images without 9-patch info are packed, on pages of the same premultiplied alpha. The
+ pages are filled with a skyline packer, and each image is surrounded by a copy of its edge pixels so linear filtering
+ doesn't sample its neighbours. Space is not reused while a page holds any texture; a page whose textures were all
+ deleted is cleared and filled again.
+ */
+class CC_DLL DynamicAtlas
+{
+public:
+    /**
+     @param pageSize Width and height of the pages, in pixels.
+     @param maxTextureSize Images wider or higher than this, in pixels, are not packed.
+     @param maxPageCount Images are not packed anymore once that many pages are full.
+     */
+    DynamicAtlas(int pageSize = 1024, int maxTextureSize = 256, int maxPageCount = 4);
+    ~DynamicAtlas();
+
+    /** Packs the image the texture was created with. Returns false when it is not eligible or doesn't fit. */
+    bool addTexture(Texture2D* texture, Image* image);
+
+    /** Called when a packed texture is deleted, to free its space in the page. */
+    static void removeTexture(Texture2D* texture);
+
+    /** Returns the number of pages. */
+    int getPageCount() const { return (int)_pages.size(); }
+    /** Returns the number of textures packed in the pages. */
+    int getTextureCount() const;
+    /** Returns the width and height of the pages, in pixels. */
+    int getPageSize() const { return _pageSize; }
+    /** Returns the maximum width and height of a packed image, in pixels. */
+    int getMaxTextureSize() const { return _maxTextureSize; }
+
+protected:
+    // top edge of the packed area over [x, x + width)
+    struct SkylineSegment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+        bool hasPremultipliedAlpha;
+        std::vector<SkylineSegment> skyline;
+        int textureCount;
+        // copy of the pixels to restore the page when the GL context is lost, owned by the texture
+        unsigned char* pixels;
+    };
+
+    Page* createPage(bool hasPremultipliedAlpha);
+    void clearPage(Page* page);
+    static bool findPosition(const Page* page, int pageSize, int width, int height, int* x, int* y);
+    static void addSkylineLevel(Page* page, int x, int y, int width, int height);
+
+    int _pageSize;
+    int _maxTextureSize;
+    int _maxPageCount;
+    std::vector<Page*> _pages;
+
+    // every atlas, so deleted textures find their page
+    static std::vector<DynamicAtlas*> s_atlases;
+};
+
+NS_CC_END
+
+// end of _2d group
+/// @}
+
+#endif //__CC_DYNAMIC_ATLAS_H__
@@ -0,0 +1,142 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCFrameAllocator.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+const size_t FrameAllocator::DEFAULT_ALIGNMENT;
+const size_t FrameAllocator::MIN_BLOCK_SIZE;
+
+FrameAllocator::FrameAllocator()
+: _currentBlock(0)
+, _offset(0)
+, _destructors(nullptr)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_lastFrameStats, 0, sizeof(_lastFrameStats));
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    reset();
+    for (auto& block : _blocks)
+    {
+        free(block.data);
+    }
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment)
+{
+    CCASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+    while (true)
+    {
+        if (_currentBlock < _blocks.size())
+        {
+            const Block& block = _blocks[_currentBlock];
+            const uintptr_t address = (uintptr_t)(block.data + _offset);
+            const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+            if (_offset + padding + size <= block.size)
+            {
+                void* ret = block.data + _offset + padding;
+                _offset += padding + size;
+                _stats.allocations++;
+                _stats.bytes += size;
+                return ret;
+            }
+
+            // the rest of this block is wasted, the next one is tried
+            if (_currentBlock + 1 < _blocks.size())
+            {
+                _currentBlock++;
+                _offset = 0;
+                continue;
+            }
+        }
+
+        // grow geometrically, so a frame needs few blocks before reset() merges them
+        size_t blockSize = std::max(MIN_BLOCK_SIZE, size + alignment);
+        blockSize = std::max(blockSize, getCapacity());
+        addBlock(blockSize);
+        _currentBlock = _blocks.size() - 1;
+        _offset = 0;
+    }
+}
+
+void FrameAllocator::reset()
+{
+    for (auto destructor = _destructors; destructor; destructor = destructor->next)
+    {
+        destructor->destroy(destructor->object);
+    }
+    _destructors = nullptr;
+
+    // the stats are those of the frame, not of merging its blocks below
+    _lastFrameStats = _stats;
+
+    if (_blocks.size() > 1)
+    {
+        const size_t capacity = getCapacity();
+        for (auto& block : _blocks)
+        {
+            free(block.data);
+        }
+        _blocks.clear();
+        addBlock(capacity);
+    }
+
+    _currentBlock = 0;
+    _offset = 0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+size_t FrameAllocator::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block : _blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void FrameAllocator::addBlock(size_t size)
+{
+    Block block;
+    block.data = (unsigned char*)malloc(size);
+    block.size = size;
+    CCASSERT(block.data, "Out of memory");
+    _blocks.push_back(block);
+    _stats.heapAllocations++;
+}
+
+NS_CC_END
@@ -0,0 +1,141 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_FRAME_ALLOCATOR_H__
+#define __CC_FRAME_ALLOCATOR_H__
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ A bump allocator for render commands and vertex/index data that only live until the end of the frame.
+ The Renderer owns one, see Renderer::getFrameAllocator(), and resets it in Renderer::clean() once the frame is drawn.
+ Memory comes from blocks that are kept across frames. When a frame needed more than one block, reset() replaces
+ them with a single block big enough for the whole frame, so a frame that allocates as much as the previous one
+ doesn't allocate from the heap. Not thread safe, only use it from the thread that visits the scene.
+ */
+class CC_DLL FrameAllocator
+{
+public:
+    /** Allocation counters of one frame. */
+    struct Stats
+    {
+        /** Number of allocations. */
+        size_t allocations;
+        /** Number of bytes allocated, without padding. */
+        size_t bytes;
+        /** Number of blocks allocated from the heap. */
+        size_t heapAllocations;
+    };
+
+    FrameAllocator();
+    ~FrameAllocator();
+
+    /** Allocates uninitialized memory, valid until the next reset(). */
+    void* allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+
+    /** Allocates an uninitialized array, valid until the next reset(). Only for types without a destructor. */
+    template <class T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T) > DEFAULT_ALIGNMENT ? alignof(T) : DEFAULT_ALIGNMENT));
+    }
+
+    /** Constructs an object, whose destructor is called by the next reset(). */
+    template <class T, class... Args>
+    T* newObject(Args&&... args)
+    {
+        auto destructor = static_cast<Destructor*>(allocate(sizeof(Destructor)));
+        T* object = new (allocate(sizeof(T), alignof(T) > DEFAULT_ALIGNMENT ? alignof(T) : DEFAULT_ALIGNMENT)) T(std::forward<Args>(args)...);
+        destructor->destroy = &destroyObject<T>;
+        destructor->object = object;
+        destructor->next = _destructors;
+        _destructors = destructor;
+        return object;
+    }
+
+    /** Destroys the objects and releases all the memory allocated since the last reset. */
+    void reset();
+
+    /** Returns the counters of the frame before the last reset(). */
+    const Stats& getLastFrameStats() const { return _lastFrameStats; }
+    /** Returns the counters since the last reset(). */
+    const Stats& getStats() const { return _stats; }
+    /** Returns the size of the blocks kept across frames. */
+    size_t getCapacity() const;
+
+    static const size_t DEFAULT_ALIGNMENT = 16;
+    static const size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+protected:
+    struct Block
+    {
+        unsigned char* data;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+        Destructor* next;
+    };
+
+    template <class T>
+    static void destroyObject(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+
+    void addBlock(size_t size);
+
+    std::vector<Block> _blocks;
+    // the block allocations are made from, and the offset of its free memory
+    size_t _currentBlock;
+    size_t _offset;
+    // newest first, so objects are destroyed in reverse order
+    Destructor* _destructors;
+
+    Stats _stats;
+    Stats _lastFrameStats;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif //__CC_FRAME_ALLOCATOR_H__
@@ -78,6 +78,10 @@ public:
      */
     GLProgram * getGLProgram(const std::string &key);
 
+    /** returns the key of a cached GL program, or an empty string if it is not in the cache
+     */
+    std::string getGLProgramKey(const GLProgram* program) const;
+
     /** adds a GLProgram to the cache for a given name */
     void addGLProgram(GLProgram* program, const std::string &key);
 
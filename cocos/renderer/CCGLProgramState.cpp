@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCFrameAllocator.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
@@ -514,6 +515,48 @@ void GLProgramState::applyUniforms()
     }
 }
 
+ssize_t GLProgramState::copyUniformValues(FrameAllocator* allocator, UniformValue** values)
+{
+    updateUniformsAndAttributes();
+
+    // constructed in place and never destroyed: the callbacks are copied into objects the allocator destroys
+    auto copies = allocator->allocateArray<UniformValue>(_uniforms.size());
+    ssize_t count = 0;
+    for (auto& uniform : _uniforms)
+    {
+        auto copy = new (&copies[count++]) UniformValue(uniform.second._uniform, uniform.second._glprogram);
+        copy->_type = uniform.second._type;
+        copy->_value = uniform.second._value;
+        if (copy->_type == UniformValue::Type::CALLBACK_FN)
+        {
+            copy->_value.callback = allocator->newObject<std::function<void(GLProgram*, Uniform*)>>(*uniform.second._value.callback);
+        }
+        else if (copy->_type == UniformValue::Type::POINTER)
+        {
+            // the floatv, v2f, v3f and v4f members share the same layout
+            GLenum type = copy->_uniform->type;
+            size_t floatCount = (type == GL_FLOAT_VEC2 ? 2 : type == GL_FLOAT_VEC3 ? 3 : type == GL_FLOAT_VEC4 ? 4 : 1) * copy->_value.floatv.size;
+            float* pointer = allocator->allocateArray<float>(floatCount);
+            memcpy(pointer, uniform.second._value.floatv.pointer, sizeof(float) * floatCount);
+            copy->_value.floatv.pointer = pointer;
+        }
+    }
+    *values = copies;
+    return count;
+}
+
+void GLProgramState::apply(const Mat4& modelView, UniformValue* values, ssize_t count)
+{
+    applyGLProgram(modelView);
+
+    applyAttributes();
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        values[i].apply();
+    }
+}
+
 void GLProgramState::setGLProgram(GLProgram *glprogram)
 {
     CCASSERT(glprogram, "invalid GLProgram");
@@ -49,6 +49,7 @@ struct VertexAttrib;
 class EventListenerCustom;
 class EventCustom;
 class Node;
+class FrameAllocator;
 
 /**
  * Uniform Value, which is used to store to value send to openGL pipe line by glUniformXXX.
@@ -276,6 +277,23 @@ public:
      */
     void applyUniforms();
 
+    /**
+     Copies the user defined uniform values as they are now, with the arrays they point to and their callbacks,
+     into memory of the allocator. The copies are valid until the allocator is reset, see apply(modelView, values, count).
+     Used by the threaded Renderer, which draws a frame after the nodes may have changed the uniforms.
+     @param allocator The allocator the values are copied into.
+     @param values Set to the copied values.
+     @return The number of copied values.
+     */
+    ssize_t copyUniformValues(FrameAllocator* allocator, UniformValue** values);
+    /**
+     Apply GLProgram, attributes and the given uniform values instead of the user defined ones.
+     @param modelView The applied modelView matrix to shader.
+     @param values Uniform values copied by copyUniformValues().
+     @param count The number of values.
+     */
+    void apply(const Mat4& modelView, UniformValue* values, ssize_t count);
+
     /**@{
      Setter and Getter of the owner GLProgram binded in this program state.
      */
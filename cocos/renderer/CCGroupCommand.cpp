@@ -69,6 +69,7 @@ void GroupCommandManager::releaseGroupID(int groupID)
 {
     _groupMapping[groupID] = false;
     _unusedIDs.push_back(groupID);
+    Director::getInstance()->getRenderer()->setRenderQueueSortMode(groupID, RenderQueue::SortMode::DEFAULT);
 }
 
 GroupCommand::GroupCommand()
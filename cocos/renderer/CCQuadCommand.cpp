@@ -65,6 +65,7 @@ void QuadCommand::init(float globalOrder, GLuint textureID, GLProgramState* glPr
     triangles.indices = __indices;
     triangles.indexCount = (int)quadCount * 6;
     TrianglesCommand::init(globalOrder, textureID, glProgramState, blendType, triangles, mv, flags);
+    _isQuads = true;
 }
 
 void QuadCommand::reIndex(int indicesCount)
@@ -106,6 +107,7 @@ void QuadCommand::init(float globalOrder, Texture2D* texture, GLProgramState* gl
 {
     init(globalOrder, texture->getName(), glProgramState, blendType, quads, quadCount, mv, flags);
     _alphaTextureID = texture->getAlphaTextureName();
+    _texture = texture;
 }
 
 NS_CC_END
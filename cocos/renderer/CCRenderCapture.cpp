@@ -0,0 +1,403 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderCapture.h"
+
+#include <string.h>
+#include <unordered_map>
+
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "base/CCDirector.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const char CAPTURE_MAGIC[4] = { 'C', 'C', 'R', 'C' };
+
+    // record type of the end of a group, the other records use the RenderCommand::Type of their command
+    const uint8_t RECORD_GROUP_END = 0xFF;
+
+    // command flags
+    const uint8_t FLAG_3D = 1 << 0;
+    const uint8_t FLAG_TRANSPARENT = 1 << 1;
+    const uint8_t FLAG_SKIP_BATCHING = 1 << 2;
+    const uint8_t FLAG_STATIC = 1 << 3;
+
+    void writeBytes(std::vector<unsigned char>& data, const void* bytes, size_t size)
+    {
+        auto begin = static_cast<const unsigned char*>(bytes);
+        data.insert(data.end(), begin, begin + size);
+    }
+
+    template <typename T>
+    void write(std::vector<unsigned char>& data, const T& value)
+    {
+        writeBytes(data, &value, sizeof(value));
+    }
+
+    void writeString(std::vector<unsigned char>& data, const std::string& str)
+    {
+        write(data, (uint32_t)str.size());
+        writeBytes(data, str.data(), str.size());
+    }
+
+    class Reader
+    {
+    public:
+        Reader(const unsigned char* bytes, size_t size)
+        : _bytes(bytes)
+        , _size(size)
+        , _offset(0)
+        {}
+
+        bool readBytes(void* dst, size_t size)
+        {
+            if (size > _size - _offset)
+                return false;
+            memcpy(dst, _bytes + _offset, size);
+            _offset += size;
+            return true;
+        }
+
+        template <typename T>
+        bool read(T& value)
+        {
+            return readBytes(&value, sizeof(value));
+        }
+
+        bool readString(std::string& str)
+        {
+            uint32_t length = 0;
+            if (!read(length) || length > _size - _offset)
+                return false;
+            str.assign(reinterpret_cast<const char*>(_bytes + _offset), length);
+            _offset += length;
+            return true;
+        }
+
+        bool isAtEnd() const { return _offset == _size; }
+
+    private:
+        const unsigned char* _bytes;
+        size_t _size;
+        size_t _offset;
+    };
+}
+
+struct RenderCapture::CapturedTriangles
+{
+    TrianglesCommand command;
+    std::vector<V3F_C4B_T2F> verts;
+    std::vector<unsigned short> indices;
+};
+
+RenderCapture::RenderCapture()
+: _clearColor(Color4F::BLACK)
+, _isDepthTestFor2D(false)
+, _commandCount(0)
+{
+}
+
+RenderCapture::~RenderCapture()
+{
+    clear();
+}
+
+void RenderCapture::clear()
+{
+    _commandCount = 0;
+    _data.clear();
+    _programs.clear();
+    _textures.clear();
+
+    _commands.clear();
+    for (auto triangles : _triangles)
+        delete triangles;
+    _triangles.clear();
+    for (auto marker : _markers)
+        delete marker;
+    _markers.clear();
+}
+
+void RenderCapture::begin(const Color4F& clearColor, bool depthTestFor2D)
+{
+    clear();
+    _clearColor = clearColor;
+    _isDepthTestFor2D = depthTestFor2D;
+}
+
+void RenderCapture::recordCommand(RenderCommand* command)
+{
+    auto type = command->getType();
+
+    uint8_t flags = 0;
+    if (command->is3D())
+        flags |= FLAG_3D;
+    if (command->isTransparent())
+        flags |= FLAG_TRANSPARENT;
+    if (command->isSkipBatching())
+        flags |= FLAG_SKIP_BATCHING;
+
+    if (RenderCommand::Type::TRIANGLES_COMMAND == type)
+    {
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        if (cmd->isStatic())
+            flags |= FLAG_STATIC;
+
+        GLProgram* program = cmd->getGLProgramState()->getGLProgram();
+        GLuint programID = program->getProgram();
+        _programs[programID] = program;
+        _textures.insert(cmd->getTextureID());
+
+        const auto& triangles = cmd->getTriangles();
+        auto blend = cmd->getBlendType();
+
+        write(_data, (uint8_t)type);
+        write(_data, cmd->getGlobalOrder());
+        write(_data, flags);
+        write(_data, cmd->getMaterialID());
+        write(_data, (uint32_t)cmd->getTextureID());
+        write(_data, (uint32_t)programID);
+        write(_data, (uint32_t)blend.src);
+        write(_data, (uint32_t)blend.dst);
+        writeBytes(_data, cmd->getModelView().m, sizeof(cmd->getModelView().m));
+        write(_data, (uint32_t)triangles.vertCount);
+        write(_data, (uint32_t)triangles.indexCount);
+        writeBytes(_data, triangles.verts, sizeof(triangles.verts[0]) * triangles.vertCount);
+        writeBytes(_data, triangles.indices, sizeof(triangles.indices[0]) * triangles.indexCount);
+    }
+    else
+    {
+        write(_data, (uint8_t)type);
+        write(_data, command->getGlobalOrder());
+        write(_data, flags);
+    }
+    ++_commandCount;
+}
+
+void RenderCapture::recordGroupEnd()
+{
+    write(_data, RECORD_GROUP_END);
+    write(_data, 0.0f);
+    write(_data, (uint8_t)0);
+    ++_commandCount;
+}
+
+bool RenderCapture::save(const std::string& filePath) const
+{
+    std::vector<unsigned char> header;
+    writeBytes(header, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    write(header, (uint32_t)VERSION);
+    write(header, _clearColor.r);
+    write(header, _clearColor.g);
+    write(header, _clearColor.b);
+    write(header, _clearColor.a);
+    write(header, (uint8_t)_isDepthTestFor2D);
+
+    // programs are referenced by their GLProgramCache key, textures by the file they were loaded from
+    auto programCache = GLProgramCache::getInstance();
+    write(header, (uint32_t)_programs.size());
+    for (const auto& program : _programs)
+    {
+        write(header, (uint32_t)program.first);
+        writeString(header, programCache->getGLProgramKey(program.second));
+    }
+
+    std::unordered_map<GLuint, std::string> texturePaths;
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (const auto& texture : textureCache->getAllTextures())
+    {
+        if (_textures.find(texture->getName()) != _textures.end())
+            texturePaths[texture->getName()] = textureCache->getTextureFilePath(texture);
+    }
+    write(header, (uint32_t)_textures.size());
+    for (auto texture : _textures)
+    {
+        write(header, (uint32_t)texture);
+        writeString(header, texturePaths[texture]);
+    }
+
+    write(header, _commandCount);
+
+    Data data;
+    ssize_t size = header.size() + _data.size();
+    auto bytes = (unsigned char*)malloc(size);
+    memcpy(bytes, header.data(), header.size());
+    if (!_data.empty())
+        memcpy(bytes + header.size(), _data.data(), _data.size());
+    data.fastSet(bytes, size);
+
+    if (!FileUtils::getInstance()->writeDataToFile(data, filePath))
+    {
+        CCLOGERROR("RenderCapture: can't write %s", filePath.c_str());
+        return false;
+    }
+    CCLOG("RenderCapture: saved %u commands into %s", _commandCount, filePath.c_str());
+    return true;
+}
+
+bool RenderCapture::load(const std::string& filePath)
+{
+    clear();
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filePath);
+    if (data.isNull())
+    {
+        CCLOGERROR("RenderCapture: can't read %s", filePath.c_str());
+        return false;
+    }
+
+    Reader reader(data.getBytes(), data.getSize());
+    char magic[sizeof(CAPTURE_MAGIC)];
+    uint32_t version = 0;
+    uint8_t depthTestFor2D = 0;
+    if (!reader.readBytes(magic, sizeof(magic)) || memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0
+        || !reader.read(version) || version != VERSION)
+    {
+        CCLOGERROR("RenderCapture: %s is not a render capture of version %u", filePath.c_str(), VERSION);
+        return false;
+    }
+
+    bool valid = reader.read(_clearColor.r) && reader.read(_clearColor.g) && reader.read(_clearColor.b)
+        && reader.read(_clearColor.a) && reader.read(depthTestFor2D);
+    _isDepthTestFor2D = depthTestFor2D != 0;
+
+    // programs that can't be found in the GLProgramCache anymore are replaced by the default sprite program
+    auto programCache = GLProgramCache::getInstance();
+    std::unordered_map<uint32_t, GLProgramState*> programStates;
+    uint32_t count = 0;
+    valid = valid && reader.read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        uint32_t programID = 0;
+        std::string key;
+        valid = reader.read(programID) && reader.readString(key);
+
+        GLProgram* program = key.empty() ? nullptr : programCache->getGLProgram(key);
+        if (program == nullptr)
+        {
+            CCLOG("RenderCapture: GLProgram '%s' not found, using the default one", key.c_str());
+            program = programCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+        }
+        programStates[programID] = GLProgramState::getOrCreateWithGLProgram(program);
+    }
+
+    // textures still in the TextureCache are used, the recorded names are kept otherwise
+    auto textureCache = Director::getInstance()->getTextureCache();
+    std::unordered_map<uint32_t, GLuint> textureIDs;
+    valid = valid && reader.read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        uint32_t textureID = 0;
+        std::string path;
+        valid = reader.read(textureID) && reader.readString(path);
+
+        auto texture = path.empty() ? nullptr : textureCache->getTextureForKey(path);
+        textureIDs[textureID] = texture ? texture->getName() : textureID;
+    }
+
+    valid = valid && reader.read(count);
+    for (uint32_t i = 0; valid && i < count; ++i)
+    {
+        uint8_t type = 0;
+        float globalOrder = 0;
+        uint8_t flags = 0;
+        valid = reader.read(type) && reader.read(globalOrder) && reader.read(flags);
+        if (!valid)
+            break;
+
+        if ((uint8_t)RenderCommand::Type::TRIANGLES_COMMAND == type)
+        {
+            uint32_t materialID, textureID, programID, blendSrc, blendDst, vertCount, indexCount;
+            Mat4 mv;
+            valid = reader.read(materialID) && reader.read(textureID) && reader.read(programID)
+                && reader.read(blendSrc) && reader.read(blendDst) && reader.readBytes(mv.m, sizeof(mv.m))
+                && reader.read(vertCount) && reader.read(indexCount)
+                && programStates.count(programID) && textureIDs.count(textureID)
+                && vertCount <= data.getSize() && indexCount <= data.getSize() && indexCount % 3 == 0;
+            if (!valid)
+                break;
+
+            auto captured = new (std::nothrow) CapturedTriangles();
+            _triangles.push_back(captured);
+            captured->verts.resize(vertCount);
+            captured->indices.resize(indexCount);
+            valid = reader.readBytes(captured->verts.data(), sizeof(captured->verts[0]) * vertCount)
+                && reader.readBytes(captured->indices.data(), sizeof(captured->indices[0]) * indexCount);
+            for (size_t index = 0; valid && index < indexCount; ++index)
+                valid = captured->indices[index] < vertCount;
+            if (!valid)
+                break;
+
+            TrianglesCommand::Triangles triangles;
+            triangles.verts = captured->verts.data();
+            triangles.indices = captured->indices.data();
+            triangles.vertCount = vertCount;
+            triangles.indexCount = indexCount;
+
+            auto& cmd = captured->command;
+            cmd.init(globalOrder, textureIDs[textureID], programStates[programID], BlendFunc{ blendSrc, blendDst }, triangles, mv, 0);
+            // keep the recorded batching, even if the replayed programs have other uniforms
+            cmd._materialID = materialID;
+            cmd.setSkipBatching((flags & FLAG_SKIP_BATCHING) != 0);
+            cmd.setStatic((flags & FLAG_STATIC) != 0);
+            cmd.set3D((flags & FLAG_3D) != 0);
+            cmd.setTransparent((flags & FLAG_TRANSPARENT) != 0);
+            _commands.push_back(&cmd);
+        }
+        else if (RECORD_GROUP_END == type || type <= (uint8_t)RenderCommand::Type::PRIMITIVE_COMMAND)
+        {
+            // the callbacks of these commands can't be replayed, but they still flush the batched triangles
+            auto marker = new (std::nothrow) CustomCommand();
+            _markers.push_back(marker);
+            marker->init(globalOrder);
+            marker->set3D((flags & FLAG_3D) != 0);
+            marker->setTransparent((flags & FLAG_TRANSPARENT) != 0);
+            _commands.push_back(marker);
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    if (!valid || !reader.isAtEnd())
+    {
+        CCLOGERROR("RenderCapture: %s is corrupted", filePath.c_str());
+        clear();
+        return false;
+    }
+    _commandCount = count;
+    return true;
+}
+
+NS_CC_END
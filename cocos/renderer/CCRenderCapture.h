@@ -0,0 +1,119 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _CC_RENDER_CAPTURE_H__
+#define _CC_RENDER_CAPTURE_H__
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "base/ccTypes.h"
+#include "platform/CCGL.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class RenderCommand;
+class CustomCommand;
+class GLProgram;
+
+/**
+ A capture of the render commands processed by the Renderer during one frame.
+
+ The Renderer records its commands into a RenderCapture when Renderer::captureNextFrame() is called, and
+ Renderer::replayCapture() feeds a saved capture back through the renderer, for instance with GLViewNull
+ and CC_USE_NULL_GL to profile batching without a GPU.
+
+ A TrianglesCommand is saved with its material ID, texture, GLProgram key, blend function, model view matrix
+ and vertex and index data. The callbacks of the other commands can't be saved, they are only kept as markers
+ which flush the batched triangles when they are replayed, as they do when the frame is rendered.
+ The file holds the values in host byte order, it is not meant to be shared between platforms.
+ */
+class CC_DLL RenderCapture
+{
+public:
+    /**The version of the file format.*/
+    static const uint32_t VERSION = 1;
+
+    /**Constructor.*/
+    RenderCapture();
+    /**Destructor.*/
+    ~RenderCapture();
+
+    /** Starts a new capture, discarding the recorded or loaded commands.
+     @param clearColor The clear color of the renderer.
+     @param depthTestFor2D Whether the depth test is enabled for 2D commands.
+     */
+    void begin(const Color4F& clearColor, bool depthTestFor2D);
+    /** Records a command processed by the renderer. */
+    void recordCommand(RenderCommand* command);
+    /** Records the end of the render queue of the last recorded group command. */
+    void recordGroupEnd();
+    /** Saves the recorded commands into a file. Returns false if the file can't be written. */
+    bool save(const std::string& filePath) const;
+
+    /** Loads a capture saved with save(), rebuilding its commands. Returns false if the file is invalid. */
+    bool load(const std::string& filePath);
+    /** The commands rebuilt by load(), in the order they were processed. They are owned by the capture. */
+    const std::vector<RenderCommand*>& getCommands() const { return _commands; }
+
+    /** The number of recorded or loaded commands, group ends included. */
+    uint32_t getCommandCount() const { return _commandCount; }
+    /** The clear color of the renderer when the frame was captured. */
+    const Color4F& getClearColor() const { return _clearColor; }
+    /** Whether the depth test was enabled for 2D commands when the frame was captured. */
+    bool isDepthTestFor2D() const { return _isDepthTestFor2D; }
+
+protected:
+    void clear();
+
+    struct CapturedTriangles;
+
+    Color4F _clearColor;
+    bool _isDepthTestFor2D;
+    uint32_t _commandCount;
+
+    // recorded command records, and the GL objects they reference, resolved to names when saving
+    std::vector<unsigned char> _data;
+    std::map<GLuint, GLProgram*> _programs;
+    std::set<GLuint> _textures;
+
+    // commands rebuilt by load()
+    std::vector<RenderCommand*> _commands;
+    std::vector<CapturedTriangles*> _triangles;
+    std::vector<CustomCommand*> _markers;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif //_CC_RENDER_CAPTURE_H__
@@ -25,12 +25,16 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCPrimitiveCommand.h"
+#include "renderer/CCRenderCapture.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCFrameAllocator.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 
@@ -39,6 +43,8 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCProfiling.h"
+#include "math/MathUtil.h"
 #include "2d/CCScene.h"
 
 #include "editor-support/creator/CCCameraNode.h"
@@ -51,8 +57,26 @@ static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
     return a->getGlobalOrder() < b->getGlobalOrder();
 }
 
+// maps a float to an unsigned int which sorts in the same order
+static inline uint32_t sortableFloatBits(float f)
+{
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    // negative: flip all the bits, positive: flip the sign bit
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static bool compareSortKey(const std::pair<uint64_t, RenderCommand*>& a, const std::pair<uint64_t, RenderCommand*>& b)
+{
+    return a.first < b.first;
+}
+
+// below this size a comparison sort beats the radix passes
+static const size_t RADIX_SORT_MIN_SIZE = 64;
+
 // queue
 RenderQueue::RenderQueue()
+: _sortMode(SortMode::DEFAULT)
 {
 
 }
@@ -87,9 +111,107 @@ ssize_t RenderQueue::size() const
 
 void RenderQueue::sort()
 {
-    // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    switch (_sortMode)
+    {
+        case SortMode::RADIX:
+            radixSort(_commands[QUEUE_GROUP::GLOBALZ_NEG], false);
+            radixSort(_commands[QUEUE_GROUP::GLOBALZ_POS], false);
+            break;
+        case SortMode::RADIX_MATERIAL:
+            radixSort(_commands[QUEUE_GROUP::GLOBALZ_NEG], true);
+            radixSort(_commands[QUEUE_GROUP::GLOBALZ_ZERO], true);
+            radixSort(_commands[QUEUE_GROUP::GLOBALZ_POS], true);
+            break;
+        default:
+            // Don't sort _queue0, it already comes sorted
+            std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
+            std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+            break;
+    }
+}
+
+void RenderQueue::radixSort(std::vector<RenderCommand*>& commands, bool sortByMaterial)
+{
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    // key: globalZ in the high 32 bits, material ID in the low 32 bits.
+    // Commands that can't batch use MATERIAL_ID_DO_NOT_BATCH.
+    auto src = &_sortBuffers[0];
+    auto dst = &_sortBuffers[1];
+    src->resize(count);
+    dst->resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        RenderCommand* command = commands[i];
+        uint64_t key = (uint64_t)sortableFloatBits(command->getGlobalOrder()) << 32;
+        if (sortByMaterial && command->getType() == RenderCommand::Type::TRIANGLES_COMMAND && !command->isSkipBatching())
+        {
+            key |= static_cast<TrianglesCommand*>(command)->getMaterialID();
+        }
+        (*src)[i] = std::make_pair(key, command);
+    }
+
+    if (count < RADIX_SORT_MIN_SIZE)
+    {
+        // Insertion sort: stable, and unlike std::stable_sort it doesn't allocate a temporary buffer.
+        for (size_t i = 1; i < count; ++i)
+        {
+            const auto entry = (*src)[i];
+            size_t j = i;
+            for (; j > 0 && compareSortKey(entry, (*src)[j - 1]); --j)
+            {
+                (*src)[j] = (*src)[j - 1];
+            }
+            (*src)[j] = entry;
+        }
+    }
+    else
+    {
+        // LSD radix sort with 8 bits digits. Every pass is stable, so equal keys keep their submission order.
+        // The low 4 digits are all 0 when not sorting by material.
+        const int firstDigit = sortByMaterial ? 0 : 4;
+        uint32_t histograms[8][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t key = (*src)[i].first;
+            for (int digit = firstDigit; digit < 8; ++digit)
+            {
+                ++histograms[digit][(key >> (digit * 8)) & 0xff];
+            }
+        }
+
+        for (int digit = firstDigit; digit < 8; ++digit)
+        {
+            uint32_t* histogram = histograms[digit];
+            // skip digits which are the same for every key, e.g. the globalZ of GLOBALZ_ZERO
+            if (histogram[((*src)[0].first >> (digit * 8)) & 0xff] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                uint32_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto& entry = (*src)[i];
+                (*dst)[histogram[(entry.first >> (digit * 8)) & 0xff]++] = entry;
+            }
+            std::swap(src, dst);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = (*src)[i].second;
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -167,17 +289,134 @@ void RenderQueue::restoreRenderState()
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+// how many buckets the auto batching pass looks back for a matching material
+static const int AUTO_BATCH_MAX_LOOKBACK = 128;
+
+// the most vertices GL_UNSIGNED_SHORT indices, and the indices of a TrianglesCommand, can address
+static const int SHORT_INDEX_VERTEX_LIMIT = 65536;
+
+// points the position/color/texcoord attributes at the V3F_C4B_T2F buffer bound to GL_ARRAY_BUFFER, from its firstVertex
+static void pointVertexAttribs(int firstVertex)
+{
+    const size_t offset = sizeof(V3F_C4B_T2F) * firstVertex;
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
+// enables the position/color/texcoord attributes and points them, without a VAO: GL::enableVertexAttribs() unbinds it
+static void setVertexAttribPointers(int firstVertex = 0)
+{
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    pointVertexAttribs(firstVertex);
+}
+
+// number of batches drawBatchedTriangles issues for the commands, ignoring full buffers
+static ssize_t countTriangleBatches(const std::vector<RenderCommand*>& commands)
+{
+    ssize_t batches = 0;
+    bool prevBatchable = false;
+    uint32_t prevMaterialID = 0;
+    for (const auto& command : commands)
+    {
+        if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND)
+        {
+            prevBatchable = false;
+            continue;
+        }
+
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        const bool batchable = !cmd->isSkipBatching();
+        if (!batchable || !prevBatchable || cmd->getMaterialID() != prevMaterialID)
+            ++batches;
+
+        prevBatchable = batchable;
+        prevMaterialID = cmd->getMaterialID();
+    }
+    return batches;
+}
+
+struct Renderer::SplitTrianglesCommand
+{
+    TrianglesCommand cmd;
+    std::vector<V3F_C4B_T2F> verts;
+    std::vector<unsigned short> indices;
+    // vertex of the original command for each vertex of the piece
+    std::vector<unsigned short> sourceIndices;
+};
+
+struct Renderer::RenderFrame
+{
+    // recorded by render(): copies of the commands and of their local-space geometry
+    std::vector<TrianglesCommand> commands;
+    std::vector<V3F_C4B_T2F> verts;
+    std::vector<unsigned short> indices;
+    // uniform values of the recorded frame, reset when the frame is released
+    FrameAllocator allocator;
+
+    // prepared by the render thread: world-space vertices and batches, split in pieces that fit the batch buffers
+    struct Chunk
+    {
+        int firstVertex;
+        int vertexCount;
+        int firstIndex;
+        int indexCount;
+        int firstBatch;
+        int batchCount;
+    };
+    std::vector<V3F_C4B_T2F> worldVerts;
+    std::vector<unsigned char> batchIndices;
+    std::vector<TriBatchToDraw> batches;
+    std::vector<Chunk> chunks;
+};
+
 //
 // constructors, destructor, init
 //
 Renderer::Renderer()
-:_filledVertex(0)
+:_vboSize(0)
+,_indexVBOSize(0)
+,_requestedVBOSize(VBO_SIZE)
+,_indexType(GL_UNSIGNED_SHORT)
+,_indexSize(sizeof(GLushort))
+,_quadInstances(nullptr)
+,_filledQuadInstances(0)
+,_quadInstanceSourceProgram(nullptr)
+,_quadInstanceProgram(nullptr)
+,_quadInstanceProgramID(0)
+,_usedSplitCommands(0)
+,_filledVertex(0)
 ,_filledIndex(0)
 ,_glViewAssigned(false)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_batchesSavedByAutoBatching(0)
+,_culledCommands(0)
+,_culledVertices(0)
+,_isBufferStreamingEnabled(false)
+,_isAutoBatchingEnabled(false)
+,_isCullingEnabled(false)
+,_isQuadInstancingEnabled(false)
+,_staticGeometryGeneration(1)
+,_staticFilledVertex(0)
+,_staticFilledIndex(0)
+,_isStaticGeometryFull(false)
+,_buffersVAO(0)
+,_streamFrame(0)
+,_streamFrameNumber(0)
+,_streamVertexBase(0)
+,_streamIndexBase(0)
 ,_triBatchesToDraw(nullptr)
 ,_triBatchesToDrawCapacity(-1)
+,_capture(nullptr)
+,_recordFrameIndex(0)
+,_preparingFrame(nullptr)
+,_preparedFrame(nullptr)
+,_renderThread(nullptr)
+,_renderThreadQuit(false)
+,_isThreadedRenderingEnabled(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -196,22 +435,33 @@ Renderer::Renderer()
     // for the batched TriangleCommand
     _triBatchesToDrawCapacity = 500;
     _triBatchesToDraw = (TriBatchToDraw*) malloc(sizeof(_triBatchesToDraw[0]) * _triBatchesToDrawCapacity);
+
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+    memset(_streamBuffers, 0, sizeof(_streamBuffers));
+    _quadInstanceVBO[0] = _quadInstanceVBO[1] = 0;
+    _renderFrames[0] = _renderFrames[1] = nullptr;
+
+    allocateBatchBuffers();
 }
 
 Renderer::~Renderer()
 {
+    setThreadedRenderingEnabled(false);
+
     _renderGroups.clear();
     _groupCommandManager->release();
 
-    glDeleteBuffers(2, _buffersVBO);
+    deleteBuffers();
 
+    CC_SAFE_DELETE(_capture);
     free(_triBatchesToDraw);
+    free(_quadInstances);
 
-    if (Configuration::getInstance()->supportsShareableVAO())
+    for (auto split : _splitCommands)
     {
-        glDeleteVertexArrays(1, &_buffersVAO);
-        GL::bindVAO(0);
+        delete split;
     }
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_cacheTextureListener);
 #endif
@@ -228,13 +478,24 @@ void Renderer::initGLView()
     Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_cacheTextureListener, -1);
 #endif
 
-    setupBuffer();
-
     _glViewAssigned = true;
+
+    // 32-bit indices and instancing can only be checked now that the GL extensions are known
+    allocateBatchBuffers();
+    allocateQuadInstances();
+    setupBuffer();
 }
 
 void Renderer::setupBuffer()
 {
+    // the retained static buffers, the instance buffers and the streaming buffers are created again on first use
+    _staticBuffersVAO = 0;
+    _staticBuffersVBO[0] = _staticBuffersVBO[1] = 0;
+    resetStaticGeometry();
+    _quadInstanceVBO[0] = _quadInstanceVBO[1] = 0;
+    memset(_streamBuffers, 0, sizeof(_streamBuffers));
+    _streamFrame = 0;
+
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -245,6 +506,53 @@ void Renderer::setupBuffer()
     }
 }
 
+void Renderer::allocateBatchBuffers()
+{
+    int vboSize = _requestedVBOSize;
+    if (vboSize > SHORT_INDEX_VERTEX_LIMIT && !Configuration::getInstance()->supportsElementIndexUint())
+    {
+        if (_glViewAssigned)
+        {
+            CCLOG("cocos2d: Renderer: GL_UNSIGNED_INT indices are not supported, batch buffers are limited to %d vertices", SHORT_INDEX_VERTEX_LIMIT);
+        }
+        vboSize = SHORT_INDEX_VERTEX_LIMIT;
+    }
+
+    const bool useIntIndices = vboSize > SHORT_INDEX_VERTEX_LIMIT;
+    if (vboSize == _vboSize && useIntIndices == (_indexType == GL_UNSIGNED_INT))
+        return;
+
+    _vboSize = vboSize;
+    _indexVBOSize = vboSize * 6 / 4;
+    _indexType = useIntIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    _indexSize = useIntIndices ? sizeof(GLuint) : sizeof(GLushort);
+
+    // the content is uploaded as is when the buffers are created
+    _verts.assign(_vboSize, V3F_C4B_T2F());
+    _indices.assign(_indexSize * _indexVBOSize, 0);
+}
+
+void Renderer::setBatchBufferSize(int vertexCount)
+{
+    CCASSERT(!_isRendering, "Cannot change the batch buffer size while rendering");
+    CCASSERT(vertexCount >= 4, "Invalid batch buffer size");
+
+    // the frame being prepared was batched for the current buffers
+    releaseRenderFrame(waitForRenderFrame());
+
+    _requestedVBOSize = vertexCount;
+    if (_glViewAssigned)
+    {
+        deleteBuffers();
+        allocateBatchBuffers();
+        setupBuffer();
+    }
+    else
+    {
+        allocateBatchBuffers();
+    }
+}
+
 void Renderer::setupVBOAndVAO()
 {
     //generate vbo and vao for trianglesCommand
@@ -254,7 +562,7 @@ void Renderer::setupVBOAndVAO()
     glGenBuffers(2, &_buffersVBO[0]);
 
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _vboSize, _verts.data(), GL_DYNAMIC_DRAW);
 
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -269,7 +577,7 @@ void Renderer::setupVBOAndVAO()
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * _indexVBOSize, _indices.data(), GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
@@ -292,19 +600,283 @@ void Renderer::setupVBO()
 //    mapBuffers();
 }
 
+void Renderer::deleteBuffers()
+{
+    if (_staticBuffersVBO[0])
+    {
+        glDeleteBuffers(2, _staticBuffersVBO);
+        _staticBuffersVBO[0] = _staticBuffersVBO[1] = 0;
+    }
+    if (_staticBuffersVAO)
+    {
+        glDeleteVertexArrays(1, &_staticBuffersVAO);
+        _staticBuffersVAO = 0;
+    }
+    if (_quadInstanceVBO[0])
+    {
+        glDeleteBuffers(2, _quadInstanceVBO);
+        _quadInstanceVBO[0] = _quadInstanceVBO[1] = 0;
+    }
+    deleteStreamBuffers();
+
+    if (_buffersVBO[0])
+    {
+        glDeleteBuffers(2, _buffersVBO);
+        _buffersVBO[0] = _buffersVBO[1] = 0;
+    }
+    if (_buffersVAO)
+    {
+        glDeleteVertexArrays(1, &_buffersVAO);
+        _buffersVAO = 0;
+        GL::bindVAO(0);
+    }
+}
+
+void Renderer::deleteStreamBuffers()
+{
+    for (auto& buffer : _streamBuffers)
+    {
+        if (buffer.vbo[0])
+        {
+            glDeleteBuffers(2, buffer.vbo);
+        }
+        if (buffer.vao)
+        {
+            glDeleteVertexArrays(1, &buffer.vao);
+        }
+    }
+    memset(_streamBuffers, 0, sizeof(_streamBuffers));
+    _streamFrame = 0;
+}
+
+Renderer::StreamBuffer& Renderer::appendStreamBuffer(int vertexCount, int indexCount)
+{
+    // Each frame appends to a pair of its own, written again VBO_RING_SIZE frames later.
+    // Several renders within the same frame (render textures, captures) keep appending to the same pair.
+    const unsigned int frameNumber = Director::getInstance()->getTotalFrames();
+    if (frameNumber != _streamFrameNumber)
+    {
+        _streamFrameNumber = frameNumber;
+        _streamFrame = (_streamFrame + 1) % VBO_RING_SIZE;
+        _streamBuffers[_streamFrame].vertexOffset = 0;
+        _streamBuffers[_streamFrame].indexOffset = 0;
+    }
+
+    auto& buffer = _streamBuffers[_streamFrame];
+    if (!buffer.vbo[0])
+    {
+        glGenBuffers(2, buffer.vbo);
+        if (Configuration::getInstance()->supportsShareableVAO())
+        {
+            // the attributes are pointed at each flush by uploadTriangles()
+            glGenVertexArrays(1, &buffer.vao);
+            GL::bindVAO(buffer.vao);
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+        }
+    }
+
+    // Avoid changing the element buffer for whatever VAO might be bound.
+    GL::bindVAO(0);
+    if (buffer.vertexOffset + vertexCount > buffer.vertexCapacity || buffer.indexOffset + indexCount > buffer.indexCapacity)
+    {
+        // Full, or not allocated yet: orphan the storage, the draw calls already issued keep reading the former one.
+        buffer.vertexCapacity = std::max(vertexCount, std::max(buffer.vertexCapacity, _vboSize));
+        buffer.indexCapacity = std::max(indexCount, std::max(buffer.indexCapacity, _indexVBOSize));
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo[0]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * buffer.vertexCapacity, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.vbo[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * buffer.indexCapacity, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        buffer.vertexOffset = 0;
+        buffer.indexOffset = 0;
+    }
+
+    _streamVertexBase = buffer.vertexOffset;
+    _streamIndexBase = buffer.indexOffset;
+    buffer.vertexOffset += vertexCount;
+    buffer.indexOffset += indexCount;
+    return buffer;
+}
+
+void Renderer::setupStaticBuffers()
+{
+    auto conf = Configuration::getInstance();
+    if (conf->supportsShareableVAO())
+    {
+        glGenVertexArrays(1, &_staticBuffersVAO);
+    }
+    GL::bindVAO(_staticBuffersVAO);
+
+    glGenBuffers(2, &_staticBuffersVBO[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _staticBuffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _vboSize, nullptr, GL_STATIC_DRAW);
+    if (conf->supportsShareableVAO())
+    {
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _staticBuffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * _indexVBOSize, nullptr, GL_STATIC_DRAW);
+
+    // Must unbind the VAO before changing the element buffer.
+    GL::bindVAO(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::resetStaticGeometry()
+{
+    // commands retained with an older generation upload their geometry again
+    _staticGeometryGeneration++;
+    _staticFilledVertex = 0;
+    _staticFilledIndex = 0;
+    _isStaticGeometryFull = false;
+    _staticFreeRegions.clear();
+}
+
+bool Renderer::fillStaticGeometry(TrianglesCommand* cmd)
+{
+    auto& geometry = cmd->_staticGeometry;
+    const bool isRetained = geometry.generation == _staticGeometryGeneration;
+    if (isRetained && geometry.geometryVersion == cmd->_geometryVersion && geometry.transformVersion == cmd->_transformVersion)
+        return true;
+
+    const int vertexCount = (int)cmd->getVertexCount();
+    const int indexCount = (int)cmd->getIndexCount();
+    if (!isRetained || vertexCount > geometry.vertexCount || indexCount > geometry.indexCount)
+    {
+        // the geometry no longer fits where it was retained, hand that region over to other commands
+        if (isRetained)
+        {
+            _staticFreeRegions.push_back({ geometry.vertexOffset, geometry.indexOffset, geometry.vertexCount, geometry.indexCount });
+            geometry.generation = 0;
+        }
+
+        auto region = std::find_if(_staticFreeRegions.begin(), _staticFreeRegions.end(), [=](const StaticRegion& free) {
+            return free.vertexCount >= vertexCount && free.indexCount >= indexCount;
+        });
+        if (region != _staticFreeRegions.end())
+        {
+            geometry.vertexOffset = region->vertexOffset;
+            geometry.indexOffset = region->indexOffset;
+            geometry.vertexCount = region->vertexCount;
+            geometry.indexCount = region->indexCount;
+            *region = _staticFreeRegions.back();
+            _staticFreeRegions.pop_back();
+        }
+        else if (_staticFilledVertex + vertexCount <= _vboSize && _staticFilledIndex + indexCount <= _indexVBOSize)
+        {
+            geometry.vertexOffset = _staticFilledVertex;
+            geometry.indexOffset = _staticFilledIndex;
+            geometry.vertexCount = vertexCount;
+            geometry.indexCount = indexCount;
+            _staticFilledVertex += vertexCount;
+            _staticFilledIndex += indexCount;
+        }
+        else
+        {
+            // Regions still referenced by this frame can't be reused, so draw it as a dynamic
+            // command and start over at the beginning of the next frame.
+            _isStaticGeometryFull = true;
+            return false;
+        }
+    }
+
+    if (!_staticBuffersVBO[0])
+    {
+        setupStaticBuffers();
+    }
+
+    _staticVerts.resize(vertexCount);
+    _staticIndices.resize(_indexSize * indexCount);
+    MathUtil::transformVertices(cmd->getModelView().m, cmd->getVertices(), _staticVerts.data(), vertexCount);
+    rebaseIndices(cmd->getIndices(), _staticIndices.data(), indexCount, geometry.vertexOffset);
+
+    // Avoid changing the element buffer for whatever VAO might be bound.
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, _staticBuffersVBO[0]);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * geometry.vertexOffset, sizeof(_verts[0]) * vertexCount, _staticVerts.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _staticBuffersVBO[1]);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * geometry.indexOffset, _indexSize * indexCount, _staticIndices.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    geometry.generation = _staticGeometryGeneration;
+    geometry.geometryVersion = cmd->_geometryVersion;
+    geometry.transformVersion = cmd->_transformVersion;
+    return true;
+}
+
+void Renderer::bindTrianglesBuffers(bool useStaticBuffers)
+{
+    auto conf = Configuration::getInstance();
+    if (useStaticBuffers && conf->supportsShareableVAO())
+    {
+        GL::bindVAO(_staticBuffersVAO);
+    }
+    else if (!useStaticBuffers && _isBufferStreamingEnabled)
+    {
+        // the VAO points at the vertices of the last upload already
+        const auto& buffer = _streamBuffers[_streamFrame];
+        GL::bindVAO(buffer.vao);
+        if (!buffer.vao)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo[0]);
+            setVertexAttribPointers(_streamVertexBase);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.vbo[1]);
+        }
+    }
+    else if (!useStaticBuffers && conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    {
+        GL::bindVAO(_buffersVAO);
+    }
+    else
+    {
+        const GLuint* buffers = useStaticBuffers ? _staticBuffersVBO : _buffersVBO;
+        GL::bindVAO(0);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+        setVertexAttribPointers();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    }
+}
+
+void Renderer::setBufferStreamingEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change buffer streaming while rendering");
+    if (_isBufferStreamingEnabled == enabled)
+        return;
+
+    _isBufferStreamingEnabled = enabled;
+    if (_glViewAssigned)
+    {
+        deleteBuffers();
+        setupBuffer();
+    }
+}
+
 void Renderer::mapBuffers()
 {
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
-    
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _vboSize, _verts.data(), GL_DYNAMIC_DRAW);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * _indexVBOSize, _indices.data(), GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -345,6 +917,12 @@ int Renderer::createRenderQueue()
     return (int)_renderGroups.size() - 1;
 }
 
+void Renderer::setRenderQueueSortMode(int renderQueueID, RenderQueue::SortMode mode)
+{
+    CCASSERT(renderQueueID >= 0 && renderQueueID < (int)_renderGroups.size(), "Invalid render queue");
+    _renderGroups[renderQueueID].setSortMode(mode);
+}
+
 void Renderer::processRenderCommand(RenderCommand* command)
 {
     CCASSERT(command, "Renderer::processRenderCommand:command should not null");
@@ -353,23 +931,31 @@ void Renderer::processRenderCommand(RenderCommand* command)
         return;
     }
     
+    if (_capture)
+    {
+        _capture->recordCommand(command);
+    }
+
     auto commandType = command->getType();
     if( RenderCommand::Type::TRIANGLES_COMMAND == commandType)
     {
         auto cmd = static_cast<TrianglesCommand*>(command);
-        
-        // flush own queue when buffer is full
-        if(_filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
+
+        // off-screen commands are dropped before their vertices are transformed
+        if (_isCullingEnabled && cullTrianglesCommand(cmd))
+        {
+            return;
+        }
+
+        // commands that can't fit in the batch buffers are drawn in pieces
+        if (cmd->getVertexCount() > _vboSize || cmd->getIndexCount() > _indexVBOSize)
+        {
+            splitTrianglesCommand(cmd);
+        }
+        else
         {
-            CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
-            CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
-            drawBatchedTriangles();
+            queueTrianglesCommand(cmd);
         }
-        
-        // queue it
-        _queuedTriangleCommands.push_back(cmd);
-        _filledIndex += cmd->getIndexCount();
-        _filledVertex += cmd->getVertexCount();
     }
     else if(RenderCommand::Type::GROUP_COMMAND == commandType)
     {
@@ -378,6 +964,10 @@ void Renderer::processRenderCommand(RenderCommand* command)
         CCGL_DEBUG_PUSH_GROUP_MARKER("RENDERER_GROUP_COMMAND");
         visitRenderQueue(_renderGroups[renderQueueID]);
         CCGL_DEBUG_POP_GROUP_MARKER();
+        if (_capture)
+        {
+            _capture->recordGroupEnd();
+        }
     }
     else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
     {
@@ -406,25 +996,118 @@ void Renderer::processRenderCommand(RenderCommand* command)
     }
 }
 
-void Renderer::visitRenderQueue(RenderQueue& queue)
+void Renderer::queueTrianglesCommand(TrianglesCommand* cmd)
 {
-    queue.saveRenderState();
+    if (_quadInstances && queueQuadInstances(cmd))
+    {
+        return;
+    }
+    // the instanced quads queued before are drawn first
+    drawQuadInstances();
 
-    //
-    //Process Global-Z < 0 Objects
-    //
-    const auto& zNegQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG);
-    if (zNegQueue.size() > 0)
+    // flush own queue when buffer is full
+    if(_filledVertex + cmd->getVertexCount() > _vboSize || _filledIndex + cmd->getIndexCount() > _indexVBOSize)
     {
-        if(_isDepthTestFor2D)
+        drawBatchedTriangles();
+    }
+
+    // queue it
+    _queuedTriangleCommands.push_back(cmd);
+    _filledIndex += cmd->getIndexCount();
+    _filledVertex += cmd->getVertexCount();
+}
+
+void Renderer::splitTrianglesCommand(TrianglesCommand* cmd)
+{
+    const int maxVertices = std::min(_vboSize, SHORT_INDEX_VERTEX_LIMIT);
+    const int maxIndices = _indexVBOSize - _indexVBOSize % 3;
+    const auto& triangles = cmd->getTriangles();
+
+    if (_splitVertexRemap.empty())
+    {
+        _splitVertexRemap.resize(SHORT_INDEX_VERTEX_LIMIT, -1);
+    }
+
+    // the pieces share the material, model view and flags of the command, so they batch together
+    auto queueSplit = [this, cmd](SplitTrianglesCommand* split) {
+        for (auto index : split->sourceIndices)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            _splitVertexRemap[index] = -1;
         }
-        else
+
+        TrianglesCommand::Triangles piece;
+        piece.verts = split->verts.data();
+        piece.indices = split->indices.data();
+        piece.vertCount = (int)split->verts.size();
+        piece.indexCount = (int)split->indices.size();
+        split->cmd = *cmd;
+        split->cmd._triangles = piece;
+        split->cmd._isStatic = false;
+        queueTrianglesCommand(&split->cmd);
+    };
+
+    // Walk the triangles and start a new piece whenever the next one might not fit.
+    // Every piece gets its own copy of the vertices it references, so its indices are local.
+    SplitTrianglesCommand* split = nullptr;
+    for (int i = 0; i + 3 <= triangles.indexCount; i += 3)
+    {
+        if (split && ((int)split->verts.size() + 3 > maxVertices || (int)split->indices.size() + 3 > maxIndices))
         {
-            glDisable(GL_DEPTH_TEST);
+            queueSplit(split);
+            split = nullptr;
+        }
+
+        if (!split)
+        {
+            if (_usedSplitCommands == _splitCommands.size())
+            {
+                _splitCommands.push_back(new (std::nothrow) SplitTrianglesCommand());
+            }
+            split = _splitCommands[_usedSplitCommands++];
+            split->verts.clear();
+            split->indices.clear();
+            split->sourceIndices.clear();
+        }
+
+        for (int j = 0; j < 3; ++j)
+        {
+            const unsigned short index = triangles.indices[i + j];
+            int& local = _splitVertexRemap[index];
+            if (local < 0)
+            {
+                local = (int)split->verts.size();
+                split->verts.push_back(triangles.verts[index]);
+                split->sourceIndices.push_back(index);
+            }
+            split->indices.push_back((unsigned short)local);
+        }
+    }
+
+    if (split)
+    {
+        queueSplit(split);
+    }
+}
+
+void Renderer::visitRenderQueue(RenderQueue& queue)
+{
+    queue.saveRenderState();
+
+    //
+    //Process Global-Z < 0 Objects
+    //
+    const auto& zNegQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG);
+    if (zNegQueue.size() > 0)
+    {
+        if(_isDepthTestFor2D)
+        {
+            glEnable(GL_DEPTH_TEST);
+            glDepthMask(true);
+            glEnable(GL_BLEND);
+        }
+        else
+        {
+            glDisable(GL_DEPTH_TEST);
             glDepthMask(false);
             glEnable(GL_BLEND);
         }
@@ -477,6 +1160,10 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     //
     //Process Global-Z = 0 Queue
     //
+    if (_isAutoBatchingEnabled)
+    {
+        autoBatchCommands(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO));
+    }
     const auto& zZeroQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO);
     if (zZeroQueue.size() > 0)
     {
@@ -531,6 +1218,111 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     queue.restoreRenderState();
 }
 
+void Renderer::autoBatchCommands(std::vector<RenderCommand*>& commands)
+{
+    const size_t count = commands.size();
+    if (count < 3)
+        return;
+
+    ssize_t batchesBefore = countTriangleBatches(commands);
+
+    // 1: put every command in a bucket. A command joins the latest bucket with its material,
+    // unless it overlaps a bucket drawn after that one; barriers are never crossed.
+    _autoBatchBuckets.clear();
+    _autoBatchBucketIDs.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        RenderCommand* command = commands[i];
+
+        AutoBatchBucket bucket;
+        bucket.isBarrier = true;
+        bucket.commandCount = 1;
+
+        if (command->getType() == RenderCommand::Type::TRIANGLES_COMMAND && !command->isSkipBatching() && !command->is3D())
+        {
+            auto cmd = static_cast<TrianglesCommand*>(command);
+            const float* m = cmd->getModelView().m;
+
+            // only 2D transforms keep non overlapping view space bounds apart on screen
+            if (cmd->getVertexCount() > 0 && m[2] == 0 && m[3] == 0 && m[6] == 0 && m[7] == 0)
+            {
+                Vec3 boundsMin, boundsMax;
+                cmd->getWorldBounds(&boundsMin, &boundsMax);
+
+                if (boundsMin.z == boundsMax.z)
+                {
+                    bucket.minX = boundsMin.x;
+                    bucket.maxX = boundsMax.x;
+                    bucket.minY = boundsMin.y;
+                    bucket.maxY = boundsMax.y;
+                    bucket.z = boundsMin.z;
+                    bucket.materialID = cmd->getMaterialID();
+                    bucket.isBarrier = false;
+                }
+            }
+        }
+
+        int target = -1;
+        if (!bucket.isBarrier)
+        {
+            const int last = (int)_autoBatchBuckets.size() - 1;
+            for (int b = last; b >= 0 && b > last - AUTO_BATCH_MAX_LOOKBACK; --b)
+            {
+                const auto& other = _autoBatchBuckets[b];
+                if (other.isBarrier)
+                    break;
+                if (other.materialID == bucket.materialID && other.z == bucket.z)
+                {
+                    target = b;
+                    break;
+                }
+                // touching counts as overlapping, to stay on the safe side of rounding
+                if (other.z != bucket.z ||
+                    (bucket.minX <= other.maxX && other.minX <= bucket.maxX && bucket.minY <= other.maxY && other.minY <= bucket.maxY))
+                    break;
+            }
+        }
+
+        if (target >= 0)
+        {
+            auto& other = _autoBatchBuckets[target];
+            other.minX = std::min(other.minX, bucket.minX);
+            other.maxX = std::max(other.maxX, bucket.maxX);
+            other.minY = std::min(other.minY, bucket.minY);
+            other.maxY = std::max(other.maxY, bucket.maxY);
+            other.commandCount++;
+        }
+        else
+        {
+            target = (int)_autoBatchBuckets.size();
+            _autoBatchBuckets.push_back(bucket);
+        }
+        _autoBatchBucketIDs[i] = target;
+    }
+
+    if (_autoBatchBuckets.size() == count)
+        return;
+
+    // 2: stable counting sort of the commands by bucket
+    int offset = 0;
+    for (auto& bucket : _autoBatchBuckets)
+    {
+        int bucketSize = bucket.commandCount;
+        bucket.commandCount = offset;
+        offset += bucketSize;
+    }
+
+    _autoBatchCommands.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        _autoBatchCommands[_autoBatchBuckets[_autoBatchBucketIDs[i]].commandCount++] = commands[i];
+    }
+    commands.swap(_autoBatchCommands);
+
+    _batchesSavedByAutoBatching += batchesBefore - countTriangleBatches(commands);
+}
+
 void Renderer::render()
 {
     //Uncomment this once everything is rendered by new renderer
@@ -539,20 +1331,456 @@ void Renderer::render()
     //TODO: setup MVP
     _isRendering = true;
 
+    if (_isStaticGeometryFull)
+    {
+        resetStaticGeometry();
+    }
+
     if (_glViewAssigned)
     {
+        if (!_captureFilePath.empty())
+        {
+            _capture = new (std::nothrow) RenderCapture();
+            _capture->begin(_clearColor, _isDepthTestFor2D);
+        }
+
         //Process render commands
         //1. Sort render commands based on ID
         for (auto &renderqueue : _renderGroups)
         {
             renderqueue.sort();
         }
-        visitRenderQueue(_renderGroups[0]);
+        if (_isThreadedRenderingEnabled && !_capture)
+        {
+            renderThreaded();
+        }
+        else
+        {
+            releaseRenderFrame(waitForRenderFrame());
+            visitRenderQueue(_renderGroups[0]);
+        }
+
+        if (_capture)
+        {
+            _capture->save(_captureFilePath);
+            CC_SAFE_DELETE(_capture);
+            _captureFilePath.clear();
+        }
     }
     clean();
     _isRendering = false;
 }
 
+void Renderer::captureNextFrame(const std::string& filePath)
+{
+    _captureFilePath = filePath;
+}
+
+bool Renderer::replayCapture(const std::string& filePath)
+{
+    CCASSERT(!_isRendering, "Cannot replay a capture while rendering");
+    if (!_glViewAssigned)
+    {
+        return false;
+    }
+
+    RenderCapture capture;
+    if (!capture.load(filePath))
+    {
+        return false;
+    }
+
+    _isRendering = true;
+
+    // same state as the Global-Z queues of visitRenderQueue()
+    bool isDepthTestFor2D = _isDepthTestFor2D;
+    _isDepthTestFor2D = capture.isDepthTestFor2D();
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    if (_isDepthTestFor2D)
+    {
+        glEnable(GL_DEPTH_TEST);
+        glDepthMask(true);
+    }
+    else
+    {
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(false);
+    }
+
+    for (auto command : capture.getCommands())
+    {
+        processRenderCommand(command);
+    }
+    flush();
+
+    _isDepthTestFor2D = isDepthTestFor2D;
+    _usedSplitCommands = 0;
+    _isRendering = false;
+    return true;
+}
+
+void Renderer::setThreadedRenderingEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change threaded rendering while rendering");
+    if (enabled == _isThreadedRenderingEnabled)
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            _renderFrames[i] = new (std::nothrow) RenderFrame();
+        }
+        _recordFrameIndex = 0;
+        _renderThreadQuit = false;
+        _renderThread = new (std::nothrow) std::thread(&Renderer::renderThreadLoop, this);
+    }
+    else
+    {
+        // the last recorded frame is never drawn
+        releaseRenderFrame(waitForRenderFrame());
+
+        {
+            std::lock_guard<std::mutex> lock(_renderThreadMutex);
+            _renderThreadQuit = true;
+        }
+        _renderThreadCondition.notify_all();
+        _renderThread->join();
+        CC_SAFE_DELETE(_renderThread);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            CC_SAFE_DELETE(_renderFrames[i]);
+        }
+    }
+    _isThreadedRenderingEnabled = enabled;
+}
+
+void Renderer::renderThreaded()
+{
+    if (!isRenderQueueDeferrable(_renderGroups[0]))
+    {
+        // Commands drawing by themselves have to run now, so this frame is drawn at once like without threading.
+        // It is drawn over the previous frame, which is dropped instead of being drawn first.
+        releaseRenderFrame(waitForRenderFrame());
+        visitRenderQueue(_renderGroups[0]);
+        return;
+    }
+
+    auto frame = _renderFrames[_recordFrameIndex];
+    recordRenderQueue(_renderGroups[0], frame);
+
+    // the previous frame has to be ready before it is drawn, or before its buffers are used again
+    auto previousFrame = waitForRenderFrame();
+    if (previousFrame == nullptr)
+    {
+        // First threaded frame, or the previous one was drawn at once: there is nothing to draw yet,
+        // so this frame is prepared and drawn now instead of presenting a blank frame.
+        // It is kept as the prepared frame and drawn again by the next render(), which starts the pipeline.
+        prepareRenderFrame(frame);
+        drawRenderFrame(frame);
+        {
+            std::lock_guard<std::mutex> lock(_renderThreadMutex);
+            _preparedFrame = frame;
+        }
+        _recordFrameIndex = 1 - _recordFrameIndex;
+        return;
+    }
+
+    drawRenderFrame(previousFrame);
+
+    {
+        std::lock_guard<std::mutex> lock(_renderThreadMutex);
+        _preparingFrame = frame;
+    }
+    _renderThreadCondition.notify_all();
+    _recordFrameIndex = 1 - _recordFrameIndex;
+
+    releaseRenderFrame(previousFrame);
+}
+
+bool Renderer::isRenderQueueDeferrable(RenderQueue& queue)
+{
+    // 3D commands need the GL state changes of visitRenderQueue() between the sub queues
+    if (queue.getSubQueueSize(RenderQueue::QUEUE_GROUP::OPAQUE_3D) > 0 ||
+        queue.getSubQueueSize(RenderQueue::QUEUE_GROUP::TRANSPARENT_3D) > 0)
+    {
+        return false;
+    }
+
+    static const RenderQueue::QUEUE_GROUP groups[] = {
+        RenderQueue::QUEUE_GROUP::GLOBALZ_NEG,
+        RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO,
+        RenderQueue::QUEUE_GROUP::GLOBALZ_POS
+    };
+    for (auto group : groups)
+    {
+        for (auto command : queue.getSubQueue(group))
+        {
+            auto commandType = command->getType();
+            if (RenderCommand::Type::TRIANGLES_COMMAND == commandType)
+            {
+                auto cmd = static_cast<TrianglesCommand*>(command);
+                if (cmd->getVertexCount() > _vboSize || cmd->getIndexCount() > _indexVBOSize)
+                {
+                    return false;
+                }
+            }
+            else if (RenderCommand::Type::GROUP_COMMAND == commandType)
+            {
+                int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
+                if (!isRenderQueueDeferrable(_renderGroups[renderQueueID]))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                // custom, batch and primitive commands draw by themselves
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Renderer::recordRenderQueue(RenderQueue& queue, RenderFrame* frame)
+{
+    if (_isAutoBatchingEnabled)
+    {
+        autoBatchCommands(queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO));
+    }
+
+    // the Global-Z queues share the same GL state, so their commands form a single stream
+    static const RenderQueue::QUEUE_GROUP groups[] = {
+        RenderQueue::QUEUE_GROUP::GLOBALZ_NEG,
+        RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO,
+        RenderQueue::QUEUE_GROUP::GLOBALZ_POS
+    };
+    // the uniforms are copied once for consecutive commands sharing a program state
+    GLProgramState* lastGLProgramState = nullptr;
+    UniformValue* uniformValues = nullptr;
+    ssize_t uniformValueCount = 0;
+    for (auto group : groups)
+    {
+        for (auto command : queue.getSubQueue(group))
+        {
+            if (RenderCommand::Type::GROUP_COMMAND == command->getType())
+            {
+                int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
+                recordRenderQueue(_renderGroups[renderQueueID], frame);
+                lastGLProgramState = nullptr;
+                continue;
+            }
+
+            // only TrianglesCommands are left, see isRenderQueueDeferrable()
+            auto cmd = static_cast<TrianglesCommand*>(command);
+            if (_isCullingEnabled && cullTrianglesCommand(cmd))
+            {
+                continue;
+            }
+
+            // the geometry is copied as it is now, the nodes may change it while the frame is prepared
+            frame->commands.push_back(*cmd);
+            auto& copy = frame->commands.back();
+            copy._isStatic = false;
+            copy._triangles.verts = nullptr;
+            copy._triangles.indices = nullptr;
+            frame->verts.insert(frame->verts.end(), cmd->getVertices(), cmd->getVertices() + cmd->getVertexCount());
+            frame->indices.insert(frame->indices.end(), cmd->getIndices(), cmd->getIndices() + cmd->getIndexCount());
+
+            // the uniforms are applied when the frame is drawn, so draw it with the values they have now
+            auto glProgramState = cmd->_glProgramState;
+            if (glProgramState->getUniformCount() > 0)
+            {
+                if (glProgramState != lastGLProgramState)
+                {
+                    uniformValueCount = glProgramState->copyUniformValues(&frame->allocator, &uniformValues);
+                    lastGLProgramState = glProgramState;
+                }
+                copy._uniformValues = uniformValues;
+                copy._uniformValueCount = uniformValueCount;
+            }
+            copy._glProgramState->retain();
+            // the texture is bound by name when the frame is drawn, keep it alive until then
+            if (copy._texture)
+            {
+                copy._texture->retain();
+            }
+        }
+    }
+
+    if (&queue == &_renderGroups[0])
+    {
+        // the snapshots don't move anymore, point the commands at them
+        size_t vertexOffset = 0;
+        size_t indexOffset = 0;
+        for (auto& cmd : frame->commands)
+        {
+            cmd._triangles.verts = frame->verts.data() + vertexOffset;
+            cmd._triangles.indices = frame->indices.data() + indexOffset;
+            vertexOffset += cmd._triangles.vertCount;
+            indexOffset += cmd._triangles.indexCount;
+        }
+    }
+}
+
+void Renderer::prepareRenderFrame(RenderFrame* frame)
+{
+    // runs on the render thread: no GL calls and no retain/release here
+    frame->worldVerts.resize(frame->verts.size());
+    frame->batchIndices.resize(frame->indices.size() * _indexSize);
+    frame->batches.clear();
+    frame->chunks.clear();
+
+    RenderFrame::Chunk chunk = {0, 0, 0, 0, 0, 0};
+    uint32_t prevMaterialID = (uint32_t)-1;
+    for (auto& cmd : frame->commands)
+    {
+        const int vertexCount = (int)cmd.getVertexCount();
+        const int indexCount = (int)cmd.getIndexCount();
+
+        // each chunk is uploaded on its own, so it has to fit the batch buffers
+        if (chunk.vertexCount + vertexCount > _vboSize || chunk.indexCount + indexCount > _indexVBOSize)
+        {
+            chunk.batchCount = (int)frame->batches.size() - chunk.firstBatch;
+            frame->chunks.push_back(chunk);
+            chunk.firstVertex += chunk.vertexCount;
+            chunk.firstIndex += chunk.indexCount;
+            chunk.firstBatch = (int)frame->batches.size();
+            chunk.vertexCount = 0;
+            chunk.indexCount = 0;
+            prevMaterialID = (uint32_t)-1;
+        }
+
+        // same as phase 1 of drawBatchedTriangles(), with indices relative to the chunk
+        MathUtil::transformVertices(cmd.getModelView().m, cmd.getVertices(), &frame->worldVerts[chunk.firstVertex + chunk.vertexCount], vertexCount);
+        rebaseIndices(cmd.getIndices(), &frame->batchIndices[_indexSize * (chunk.firstIndex + chunk.indexCount)], indexCount, chunk.vertexCount);
+
+        auto currentMaterialID = cmd.getMaterialID();
+        if (!cmd.isSkipBatching() && frame->batches.size() > (size_t)chunk.firstBatch && prevMaterialID == currentMaterialID)
+        {
+            auto& batch = frame->batches.back();
+            batch.indicesToDraw += indexCount;
+            batch.cmd = &cmd;
+        }
+        else
+        {
+            TriBatchToDraw batch;
+            batch.cmd = &cmd;
+            batch.indicesToDraw = indexCount;
+            batch.offset = chunk.indexCount;
+            batch.isStatic = false;
+            frame->batches.push_back(batch);
+
+            // is this a single batch ? Prevent creating a batch group then
+            if (cmd.isSkipBatching())
+                currentMaterialID = -1;
+        }
+        prevMaterialID = currentMaterialID;
+
+        chunk.vertexCount += vertexCount;
+        chunk.indexCount += indexCount;
+    }
+
+    if (chunk.vertexCount > 0)
+    {
+        chunk.batchCount = (int)frame->batches.size() - chunk.firstBatch;
+        frame->chunks.push_back(chunk);
+    }
+}
+
+void Renderer::drawRenderFrame(RenderFrame* frame)
+{
+    CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_THREADED_FRAME");
+
+    RenderQueue renderState;
+    renderState.saveRenderState();
+
+    // same state as the Global-Z queues of visitRenderQueue()
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    if (_isDepthTestFor2D)
+    {
+        glEnable(GL_DEPTH_TEST);
+        glDepthMask(true);
+    }
+    else
+    {
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(false);
+    }
+
+    for (const auto& chunk : frame->chunks)
+    {
+        uploadTriangles(&frame->worldVerts[chunk.firstVertex], chunk.vertexCount,
+                        &frame->batchIndices[_indexSize * chunk.firstIndex], chunk.indexCount);
+        drawTriangleBatches(&frame->batches[chunk.firstBatch], chunk.batchCount);
+    }
+
+    renderState.restoreRenderState();
+}
+
+void Renderer::releaseRenderFrame(RenderFrame* frame)
+{
+    if (frame == nullptr)
+    {
+        return;
+    }
+
+    for (auto& cmd : frame->commands)
+    {
+        cmd._glProgramState->release();
+        CC_SAFE_RELEASE(cmd._texture);
+    }
+    frame->allocator.reset();
+    // the capacity is kept for the next frame
+    frame->commands.clear();
+    frame->verts.clear();
+    frame->indices.clear();
+    frame->batches.clear();
+    frame->chunks.clear();
+}
+
+Renderer::RenderFrame* Renderer::waitForRenderFrame()
+{
+    std::unique_lock<std::mutex> lock(_renderThreadMutex);
+    _renderThreadCondition.wait(lock, [this]() { return _preparingFrame == nullptr; });
+
+    auto frame = _preparedFrame;
+    _preparedFrame = nullptr;
+    return frame;
+}
+
+void Renderer::renderThreadLoop()
+{
+    while (true)
+    {
+        RenderFrame* frame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_renderThreadMutex);
+            _renderThreadCondition.wait(lock, [this]() { return _renderThreadQuit || _preparingFrame != nullptr; });
+            if (_preparingFrame == nullptr)
+            {
+                break;
+            }
+            frame = _preparingFrame;
+        }
+
+        prepareRenderFrame(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(_renderThreadMutex);
+            _preparedFrame = frame;
+            _preparingFrame = nullptr;
+        }
+        _renderThreadCondition.notify_all();
+    }
+}
+
 void Renderer::clean()
 {
     // Clear render group
@@ -570,6 +1798,12 @@ void Renderer::clean()
     _queuedTriangleCommands.clear();
     _filledVertex = 0;
     _filledIndex = 0;
+    _usedSplitCommands = 0;
+    _quadInstanceBatches.clear();
+    _filledQuadInstances = 0;
+
+    // the commands allocated for this frame are not referenced anymore
+    _frameAllocator.reset();
 }
 
 void Renderer::clear()
@@ -602,26 +1836,28 @@ void Renderer::setDepthTest(bool enable)
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
-
     // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
-    {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
-    }
+    MathUtil::transformVertices(cmd->getModelView().m, cmd->getVertices(), &_verts[_filledVertex], cmd->getVertexCount());
 
     // fill index
-    const unsigned short* indices = cmd->getIndices();
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
-    {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
-    }
+    rebaseIndices(cmd->getIndices(), &_indices[_indexSize * _filledIndex], cmd->getIndexCount(), _filledVertex);
 
     _filledVertex += cmd->getVertexCount();
     _filledIndex += cmd->getIndexCount();
 }
 
+void Renderer::rebaseIndices(const unsigned short* src, void* dst, size_t count, unsigned int offset) const
+{
+    if (_indexType == GL_UNSIGNED_INT)
+    {
+        MathUtil::transformIndices(src, (GLuint*)dst, count, offset);
+    }
+    else
+    {
+        MathUtil::transformIndices(src, (GLushort*)dst, count, (unsigned short)offset);
+    }
+}
+
 void Renderer::drawBatchedTriangles()
 {
     if(_queuedTriangleCommands.empty())
@@ -633,13 +1869,15 @@ void Renderer::drawBatchedTriangles()
     _filledIndex = 0;
 
     /************** 1: Setup up vertices/indices *************/
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryRenderer, "Renderer - fillVerticesAndIndices");
 
     _triBatchesToDraw[0].offset = 0;
     _triBatchesToDraw[0].indicesToDraw = 0;
     _triBatchesToDraw[0].cmd = nullptr;
+    _triBatchesToDraw[0].isStatic = false;
 
     int batchesTotal = 0;
-    int prevMaterialID = -1;
+    uint32_t prevMaterialID = (uint32_t)-1;
     bool firstCommand = true;
 
     for(auto it = std::begin(_queuedTriangleCommands); it != std::end(_queuedTriangleCommands); ++it)
@@ -648,25 +1886,34 @@ void Renderer::drawBatchedTriangles()
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd);
+        // static commands are drawn from the retained buffers, the others from this flush
+        const bool isStatic = cmd->isStatic() && fillStaticGeometry(cmd);
+        const GLuint offset = isStatic ? cmd->_staticGeometry.indexOffset : _filledIndex;
+        if (!isStatic)
+        {
+            fillVerticesAndIndices(cmd);
+        }
 
         // in the same batch ?
-        if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
+        auto& batch = _triBatchesToDraw[batchesTotal];
+        if (batchable && !firstCommand && prevMaterialID == currentMaterialID &&
+            batch.isStatic == isStatic && batch.offset + batch.indicesToDraw == offset)
         {
-            CC_ASSERT(firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID() && "argh... error in logic");
-            _triBatchesToDraw[batchesTotal].indicesToDraw += cmd->getIndexCount();
-            _triBatchesToDraw[batchesTotal].cmd = cmd;
+            CC_ASSERT(batch.cmd->getMaterialID() == cmd->getMaterialID() && "argh... error in logic");
+            batch.indicesToDraw += cmd->getIndexCount();
+            batch.cmd = cmd;
         }
         else
         {
             // is this the first one?
             if (!firstCommand) {
                 batchesTotal++;
-                _triBatchesToDraw[batchesTotal].offset = _triBatchesToDraw[batchesTotal-1].offset + _triBatchesToDraw[batchesTotal-1].indicesToDraw;
             }
 
             _triBatchesToDraw[batchesTotal].cmd = cmd;
             _triBatchesToDraw[batchesTotal].indicesToDraw = (int) cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].offset = offset;
+            _triBatchesToDraw[batchesTotal].isStatic = isStatic;
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
@@ -683,10 +1930,49 @@ void Renderer::drawBatchedTriangles()
         firstCommand = false;
     }
     batchesTotal++;
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryRenderer, "Renderer - fillVerticesAndIndices");
 
     /************** 2: Copy vertices/indices to GL objects *************/
+    uploadTriangles(_verts.data(), _filledVertex, _indices.data(), _filledIndex);
+
+    /************** 3: Draw *************/
+    drawTriangleBatches(_triBatchesToDraw, batchesTotal);
+
+    _queuedTriangleCommands.clear();
+    _filledVertex = 0;
+    _filledIndex = 0;
+}
+
+void Renderer::uploadTriangles(const V3F_C4B_T2F* verts, int vertexCount, const unsigned char* indices, int indexCount)
+{
     auto conf = Configuration::getInstance();
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    if (vertexCount == 0)
+    {
+        // every command is drawn from the retained static buffers
+    }
+    else if (_isBufferStreamingEnabled)
+    {
+        // Append after what the earlier flushes of the frame wrote, which their draw calls may still read.
+        const auto& buffer = appendStreamBuffer(vertexCount, indexCount);
+        GL::bindVAO(buffer.vao);
+
+        // the indices of the flush start from 0, point the attributes at its first vertex instead of rebasing them
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo[0]);
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(verts[0]) * _streamVertexBase, sizeof(verts[0]) * vertexCount, verts);
+        if (conf->supportsShareableVAO())
+        {
+            pointVertexAttribs(_streamVertexBase);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        else
+        {
+            setVertexAttribPointers(_streamVertexBase);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.vbo[1]);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * _streamIndexBase, _indexSize * indexCount, indices);
+    }
+    else if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
@@ -703,15 +1989,15 @@ void Renderer::drawBatchedTriangles()
         // FIXME: in order to work as fast as possible, it must "and the exact same size and usage hints it had before."
         //  source: https://www.opengl.org/wiki/Buffer_Object_Streaming#Explicit_multiple_buffering
         // so most probably we won't have any benefit of using it
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, nullptr, GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(verts[0]) * vertexCount, nullptr, GL_STATIC_DRAW);
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _verts, sizeof(_verts[0])* _filledVertex);
+        memcpy(buf, verts, sizeof(verts[0])* vertexCount);
         glUnmapBuffer(GL_ARRAY_BUFFER);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * indexCount, indices, GL_STATIC_DRAW);
     }
     else
     {
@@ -719,7 +2005,7 @@ void Renderer::drawBatchedTriangles()
 #define kQuadSize sizeof(_verts[0])
         glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(verts[0]) * vertexCount , verts, GL_DYNAMIC_DRAW);
 
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
@@ -733,17 +2019,28 @@ void Renderer::drawBatchedTriangles()
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexSize * indexCount, indices, GL_STATIC_DRAW);
     }
+}
 
-    /************** 3: Draw *************/
-    for (int i=0; i<batchesTotal; ++i)
+void Renderer::drawTriangleBatches(const TriBatchToDraw* batches, int batchCount)
+{
+    bool staticBuffersBound = false;
+    for (int i=0; i<batchCount; ++i)
     {
-        CC_ASSERT(_triBatchesToDraw[i].cmd && "Invalid batch");
-        _triBatchesToDraw[i].cmd->useMaterial();
-        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (_triBatchesToDraw[i].offset*sizeof(_indices[0])) );
+        const auto& batch = batches[i];
+        CC_ASSERT(batch.cmd && "Invalid batch");
+        if (batch.isStatic != staticBuffersBound)
+        {
+            bindTrianglesBuffers(batch.isStatic);
+            staticBuffersBound = batch.isStatic;
+        }
+        batch.cmd->useMaterial();
+        // streamed indices start where the flush was appended
+        size_t offset = batch.offset + (!batch.isStatic && _isBufferStreamingEnabled ? _streamIndexBase : 0);
+        glDrawElements(GL_TRIANGLES, (GLsizei) batch.indicesToDraw, _indexType, (GLvoid*) (uintptr_t) (offset * _indexSize) );
         _drawnBatches++;
-        _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
+        _drawnVertices += batch.indicesToDraw;
     }
 
     /************** 4: Cleanup *************/
@@ -757,10 +2054,209 @@ void Renderer::drawBatchedTriangles()
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+}
 
-    _queuedTriangleCommands.clear();
-    _filledVertex = 0;
-    _filledIndex = 0;
+void Renderer::setQuadInstancingEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change quad instancing while rendering");
+    _isQuadInstancingEnabled = enabled;
+    if (_glViewAssigned)
+    {
+        allocateQuadInstances();
+    }
+}
+
+void Renderer::allocateQuadInstances()
+{
+    bool useInstancing = _isQuadInstancingEnabled;
+    if (useInstancing && !Configuration::getInstance()->supportsInstancedArrays())
+    {
+        CCLOG("cocos2d: Renderer: instanced arrays are not supported, quads are drawn as triangles");
+        useInstancing = false;
+    }
+
+    if (useInstancing && !_quadInstances)
+    {
+        _quadInstances = (QuadInstance*) malloc(sizeof(_quadInstances[0]) * INSTANCE_VBO_SIZE);
+        auto cache = GLProgramCache::getInstance();
+        _quadInstanceSourceProgram = cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+        _quadInstanceProgram = cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED);
+    }
+    else if (!useInstancing && _quadInstances)
+    {
+        free(_quadInstances);
+        _quadInstances = nullptr;
+    }
+}
+
+void Renderer::setupQuadInstanceBuffers()
+{
+    // corners of the unit quad, drawn as a triangle strip
+    static const GLfloat corners[] = { 0, 0,  1, 0,  0, 1,  1, 1 };
+
+    glGenBuffers(2, &_quadInstanceVBO[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _quadInstanceVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+// whether a + b - c == d, within rounding errors
+static inline bool isParallelogram(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d)
+{
+    const float epsilon = 1e-4f * (1.0f + fabsf(c.x) + fabsf(c.y) + fabsf(c.z));
+    return fabsf(a.x + b.x - c.x - d.x) <= epsilon
+        && fabsf(a.y + b.y - c.y - d.y) <= epsilon
+        && fabsf(a.z + b.z - c.z - d.z) <= epsilon;
+}
+
+static inline bool isParallelogram(const Tex2F& a, const Tex2F& b, const Tex2F& c, const Tex2F& d)
+{
+    const float epsilon = 1e-5f;
+    return fabsf(a.u + b.u - c.u - d.u) <= epsilon
+        && fabsf(a.v + b.v - c.v - d.v) <= epsilon;
+}
+
+bool Renderer::queueQuadInstances(TrianglesCommand* cmd)
+{
+    // The instanced program only gets the built-in uniforms, so the GLProgramState must not carry any other.
+    const int quadCount = (int)cmd->getVertexCount() / 4;
+    if (!cmd->_isQuads || cmd->isStatic() || cmd->isSkipBatching() || quadCount > INSTANCE_VBO_SIZE
+        || cmd->getIndexCount() != quadCount * 6 || cmd->_glProgram != _quadInstanceSourceProgram
+        || cmd->getGLProgramState()->getUniformCount() != 0)
+    {
+        return false;
+    }
+
+    if (_filledQuadInstances + quadCount > INSTANCE_VBO_SIZE)
+    {
+        drawQuadInstances();
+    }
+
+    // Written past the queued instances, they only count once every quad can be drawn this way.
+    const Mat4& mv = cmd->getModelView();
+    const V3F_C4B_T2F* verts = cmd->getVertices();
+    QuadInstance* instance = _quadInstances + _filledQuadInstances;
+    for (int i = 0; i < quadCount; ++i, verts += 4, ++instance)
+    {
+        // vertices of a quad: top left, bottom left, top right, bottom right
+        const auto& tl = verts[0];
+        const auto& bl = verts[1];
+        const auto& tr = verts[2];
+        const auto& br = verts[3];
+        if (!isParallelogram(tl.vertices, br.vertices, bl.vertices, tr.vertices)
+            || !isParallelogram(tl.texCoords, br.texCoords, bl.texCoords, tr.texCoords)
+            || bl.colors != tl.colors || bl.colors != tr.colors || bl.colors != br.colors)
+        {
+            return false;
+        }
+
+        mv.transformPoint(bl.vertices, &instance->origin);
+        mv.transformVector(br.vertices - bl.vertices, &instance->axisX);
+        mv.transformVector(tl.vertices - bl.vertices, &instance->axisY);
+        instance->texCoord = bl.texCoords;
+        instance->texAxisX.u = br.texCoords.u - bl.texCoords.u;
+        instance->texAxisX.v = br.texCoords.v - bl.texCoords.v;
+        instance->texAxisY.u = tl.texCoords.u - bl.texCoords.u;
+        instance->texAxisY.v = tl.texCoords.v - bl.texCoords.v;
+        instance->color = bl.colors;
+    }
+
+    // the batched triangles queued before are drawn first
+    drawBatchedTriangles();
+
+    if (!_quadInstanceBatches.empty() && _quadInstanceBatches.back().cmd->getMaterialID() == cmd->getMaterialID())
+    {
+        _quadInstanceBatches.back().count += quadCount;
+    }
+    else
+    {
+        _quadInstanceBatches.push_back({cmd, _filledQuadInstances, quadCount});
+    }
+    _filledQuadInstances += quadCount;
+    return true;
+}
+
+void Renderer::drawQuadInstances()
+{
+    if (_quadInstanceBatches.empty())
+        return;
+
+    CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_INSTANCED_QUADS");
+
+    if (!_quadInstanceVBO[0])
+    {
+        setupQuadInstanceBuffers();
+    }
+
+    auto program = _quadInstanceProgram;
+    if (program->getProgram() != _quadInstanceProgramID)
+    {
+        // the program is linked again when the GL context is recreated
+        _quadInstanceProgramID = program->getProgram();
+        _quadInstanceAttribs[0] = program->getAttribLocation("a_instanceOrigin");
+        _quadInstanceAttribs[1] = program->getAttribLocation("a_instanceAxisX");
+        _quadInstanceAttribs[2] = program->getAttribLocation("a_instanceAxisY");
+        _quadInstanceAttribs[3] = program->getAttribLocation("a_instanceTexCoord");
+        _quadInstanceAttribs[4] = program->getAttribLocation("a_instanceTexAxes");
+        CCASSERT(*std::min_element(_quadInstanceAttribs, _quadInstanceAttribs + 5) >= 0, "Invalid instanced quads program");
+    }
+    static const GLint attribSizes[5] = { 3, 3, 3, 2, 4 };
+    static const size_t attribOffsets[5] = {
+        offsetof(QuadInstance, origin), offsetof(QuadInstance, axisX), offsetof(QuadInstance, axisY),
+        offsetof(QuadInstance, texCoord), offsetof(QuadInstance, texAxisX) };
+
+    uint32_t attribFlags = GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_COLOR;
+    for (auto location : _quadInstanceAttribs)
+    {
+        attribFlags |= 1 << location;
+    }
+    GL::enableVertexAttribs(attribFlags);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _quadInstanceVBO[0]);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*) 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _quadInstanceVBO[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadInstances[0]) * _filledQuadInstances, _quadInstances, GL_DYNAMIC_DRAW);
+
+    GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_COLOR, 1);
+    for (auto location : _quadInstanceAttribs)
+    {
+        GL::vertexAttribDivisor(location, 1);
+    }
+
+    for (const auto& batch : _quadInstanceBatches)
+    {
+        // there is no base instance in OpenGL ES 2.0, the instance attributes point at the batch instead
+        const size_t offset = sizeof(QuadInstance) * batch.offset;
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(QuadInstance), (GLvoid*) (offset + offsetof(QuadInstance, color)));
+        for (int i = 0; i < 5; ++i)
+        {
+            glVertexAttribPointer(_quadInstanceAttribs[i], attribSizes[i], GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (GLvoid*) (offset + attribOffsets[i]));
+        }
+
+        GL::bindTexture2D(batch.cmd->getTextureID());
+        GL::blendFunc(batch.cmd->getBlendType().src, batch.cmd->getBlendType().dst);
+        program->use();
+        program->setUniformsForBuiltins(batch.cmd->getModelView());
+
+        GL::drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.count);
+        _drawnBatches++;
+        _drawnVertices += batch.count * 6;
+    }
+
+    // the other paths expect every attribute to advance per vertex
+    GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_COLOR, 0);
+    for (auto location : _quadInstanceAttribs)
+    {
+        GL::vertexAttribDivisor(location, 0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _quadInstanceBatches.clear();
+    _filledQuadInstances = 0;
 }
 
 void Renderer::flush()
@@ -775,9 +2271,45 @@ void Renderer::flush2D()
 
 void Renderer::flushTriangles()
 {
+    // only one of them has queued commands
+    drawQuadInstances();
     drawBatchedTriangles();
 }
 
+bool Renderer::cullTrianglesCommand(TrianglesCommand* cmd)
+{
+    Vec3 boundsMin, boundsMax;
+    cmd->getWorldBounds(&boundsMin, &boundsMax);
+
+    // The projection includes whatever the custom commands drawn so far pushed, like a camera or a RenderTexture.
+    // The box is outside when all of its corners are beyond the same side of the clip volume.
+    const Mat4& projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    int outsideLeft = 0, outsideRight = 0, outsideBottom = 0, outsideTop = 0;
+    for (int c = 0; c < 8; ++c)
+    {
+        Vec4 corner((c & 1) ? boundsMax.x : boundsMin.x, (c & 2) ? boundsMax.y : boundsMin.y, (c & 4) ? boundsMax.z : boundsMin.z, 1);
+        Vec4 clip;
+        projection.transformVector(corner, &clip);
+        if (clip.w <= 0)
+        {
+            // behind the eye, keep it to stay on the safe side
+            return false;
+        }
+        outsideLeft += clip.x < -clip.w;
+        outsideRight += clip.x > clip.w;
+        outsideBottom += clip.y < -clip.w;
+        outsideTop += clip.y > clip.w;
+    }
+
+    if (outsideLeft == 8 || outsideRight == 8 || outsideBottom == 8 || outsideTop == 8)
+    {
+        _culledCommands++;
+        _culledVertices += cmd->getVertexCount();
+        return true;
+    }
+    return false;
+}
+
 // helpers
 bool Renderer::checkVisibility(const Mat4& transform, const Size& size)
 {
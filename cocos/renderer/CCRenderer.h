@@ -28,9 +28,14 @@
 
 #include <vector>
 #include <stack>
+#include <utility>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
+#include "renderer/CCFrameAllocator.h"
 #include "renderer/CCGLProgram.h"
 #include "platform/CCGL.h"
 
@@ -86,6 +91,21 @@ public:
         QUEUE_COUNT = 5,
     };
 
+    /**
+    How the render commands of a queue are sorted before rendering.
+    */
+    enum class SortMode
+    {
+        /**std::sort by globalZ of the GLOBALZ_NEG and GLOBALZ_POS queues. GLOBALZ_ZERO keeps scene order.*/
+        DEFAULT,
+        /**Stable radix sort by globalZ of the GLOBALZ_NEG and GLOBALZ_POS queues. Same order as DEFAULT, in linear time.*/
+        RADIX,
+        /**Stable radix sort of the GLOBALZ_NEG, GLOBALZ_ZERO and GLOBALZ_POS queues by globalZ, then material ID,
+         then submission order. Commands with the same globalZ are grouped by material so they batch; only use it
+         when commands sharing a globalZ may be drawn in any order, e.g. they don't overlap.*/
+        RADIX_MATERIAL,
+    };
+
 public:
     /**Constructor.*/
     RenderQueue();
@@ -95,6 +115,10 @@ public:
     ssize_t size() const;
     /**Sort the render commands.*/
     void sort();
+    /**Set how the render commands are sorted. DEFAULT by default.*/
+    inline void setSortMode(SortMode mode) { _sortMode = mode; }
+    /**Get how the render commands are sorted.*/
+    inline SortMode getSortMode() const { return _sortMode; }
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
     /**Clear all rendered commands.*/
@@ -112,9 +136,17 @@ public:
     void restoreRenderState();
 
 protected:
+    /**Radix sort a sub queue by 64 bits keys, see SortMode.*/
+    void radixSort(std::vector<RenderCommand*>& commands, bool sortByMaterial);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
 
+    /**Sort mode of the queue.*/
+    SortMode _sortMode;
+    /**Scratch (key, command) buffers of the radix sort, kept to avoid per frame allocations.*/
+    std::vector<std::pair<uint64_t, RenderCommand*>> _sortBuffers[2];
+
     /**Cull state.*/
     bool _isCullEnabled;
     /**Depth test enable state.*/
@@ -131,6 +163,7 @@ struct RenderStackElement
 };
 
 class GroupCommandManager;
+class RenderCapture;
 
 /* Class responsible for the rendering in.
 
@@ -139,10 +172,14 @@ Whenever possible prefer to use `TrianglesCommand` objects since the renderer wi
 class CC_DLL Renderer
 {
 public:
-    /**The max number of vertices in a vertex buffer object.*/
+    /**The default number of vertices in a vertex buffer object, see setBatchBufferSize().*/
     static const int VBO_SIZE = 65536;
-    /**The max number of indices in a index buffer.*/
+    /**The default number of indices in a index buffer.*/
     static const int INDEX_VBO_SIZE = VBO_SIZE * 6 / 4;
+    /**The number of quads the instance buffer holds, see setQuadInstancingEnabled().*/
+    static const int INSTANCE_VBO_SIZE = VBO_SIZE / 4;
+    /**The number of streaming buffer pairs, written by consecutive frames in turn, see setBufferStreamingEnabled().*/
+    static const int VBO_RING_SIZE = 3;
     /**The rendercommands which can be batched will be saved into a list, this is the reserved size of this list.*/
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
@@ -170,6 +207,10 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Sets how the commands of a render queue are sorted. Queue 0 is the default render queue,
+     group commands use `GroupCommand::getRenderQueueID()`. The mode of a group queue is reset when its ID is released. */
+    void setRenderQueueSortMode(int renderQueueID, RenderQueue::SortMode mode);
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -189,8 +230,15 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of batches the auto batching pass saved in the last frame.
+     getDrawnBatches() + getBatchesSavedByAutoBatching() is the number of batches without it */
+    ssize_t getBatchesSavedByAutoBatching() const { return _batchesSavedByAutoBatching; }
+    /* returns the number of TrianglesCommands culled in the last frame */
+    ssize_t getCulledCommands() const { return _culledCommands; }
+    /* returns the number of vertices of the TrianglesCommands culled in the last frame */
+    ssize_t getCulledVertices() const { return _culledVertices; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _batchesSavedByAutoBatching = _culledCommands = _culledVertices = 0; }
 
     /**
      * Enable/Disable depth test
@@ -199,9 +247,108 @@ public:
      */
     void setDepthTest(bool enable);
 
+    /**
+     * Enable/Disable buffer streaming for batched triangles.
+     * When enabled, the flushes of a frame append their vertices and indices with glBufferSubData after the ones
+     * the previous flushes wrote, instead of re-specifying a single buffer, so that they don't write into what an earlier
+     * draw call may still read. Consecutive frames write into VBO_RING_SIZE buffer pairs in turn, each one sized for a
+     * full batch (see setBatchBufferSize()). When a flush doesn't fit in what is left, the pair is orphaned with
+     * glBufferData and written again from its start.
+     * There are no fences: a pair is written again VBO_RING_SIZE frames later whether or not the GPU is done with it.
+     * It is disabled by default because some drivers copy the whole buffer on partial updates (issue #15652).
+     */
+    void setBufferStreamingEnabled(bool enabled);
+    /** Whether or not buffer streaming is enabled. */
+    bool isBufferStreamingEnabled() const { return _isBufferStreamingEnabled; }
+
+    /**
+     * Sets the number of vertices of the buffers TrianglesCommands are batched into, VBO_SIZE by default.
+     * The index buffers hold 1.5 times as many indices. Sizes above 65536 vertices are drawn with 32-bit indices,
+     * and are clamped to 65536 when GL_UNSIGNED_INT indices are not supported (see Configuration::supportsElementIndexUint()).
+     * A TrianglesCommand bigger than the buffers is split into several commands, which are still batched.
+     */
+    void setBatchBufferSize(int vertexCount);
+    /** The number of vertices of the batch buffers. */
+    int getBatchBufferSize() const { return _vboSize; }
+    /** The type of the indices of the batched triangles: GL_UNSIGNED_SHORT or GL_UNSIGNED_INT. */
+    GLenum getBatchIndexType() const { return _indexType; }
+
+    /**
+     * Enable/Disable auto batching of the Global-Z = 0 queue.
+     * When enabled, a TrianglesCommand may be moved back next to an earlier command with the same material ID,
+     * as long as it doesn't overlap anything drawn in between, so the rendered image stays the same.
+     * Only commands with 2D transforms are moved; any other command is never crossed.
+     * Disabled by default.
+     */
+    void setAutoBatchingEnabled(bool enabled) { _isAutoBatchingEnabled = enabled; }
+    /** Whether or not auto batching is enabled. */
+    bool isAutoBatchingEnabled() const { return _isAutoBatchingEnabled; }
+
+    /**
+     * Enable/Disable culling of TrianglesCommands.
+     * When enabled, a TrianglesCommand whose world bounding box is outside of the current projection is dropped
+     * before its vertices are transformed and copied, see TrianglesCommand::setWorldBounds().
+     * Commands with shaders that move the vertices may be culled wrongly.
+     * Disabled by default.
+     */
+    void setCullingEnabled(bool enabled) { _isCullingEnabled = enabled; }
+    /** Whether or not culling is enabled. */
+    bool isCullingEnabled() const { return _isCullingEnabled; }
+
+    /**
+     * Enable/Disable instanced drawing of quads.
+     * When enabled and Configuration::supportsInstancedArrays() is true, each quad of a QuadCommand, or of a
+     * TrianglesCommand holding one quad indexed the same way like the one of a Sprite, using the
+     * SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP program is uploaded as one instance (world space corner and edges,
+     * texture coordinates and color) instead of 4 transformed vertices and 6 indices, and the consecutive quads
+     * of a material are drawn with a single instanced call.
+     * Commands with custom uniforms, static geometry, gradients or quads that aren't parallelograms are drawn as triangles.
+     * Disabled by default.
+     */
+    void setQuadInstancingEnabled(bool enabled);
+    /** Whether or not instanced drawing of quads is enabled. */
+    bool isQuadInstancingEnabled() const { return _isQuadInstancingEnabled; }
+
+    /**
+     * Enable/Disable threaded rendering.
+     * When enabled, render() records the frame into one of two frame snapshots, holding copies of its TrianglesCommands
+     * and of their vertices and indices. A render thread transforms and batches the snapshot while the next frame is
+     * updated and visited, and the next render() uploads and draws it, so frames are displayed one frame late.
+     * When there is no previous snapshot, on the first threaded frame or after a frame rendered at once, the recorded
+     * frame is transformed and drawn at once too. The GL calls stay on the thread that owns the GL context.
+     * The user uniform values of the GLProgramStates are copied with the frame, uniform callbacks run when it is drawn.
+     * A frame with other commands, 3D commands or commands bigger than the batch buffers is detected before anything is
+     * recorded and rendered at once, as without threading. It covers the snapshot of the previous frame, which is dropped.
+     * Static geometry and quad instancing are not used for snapshots. The Texture2D given to the recorded commands are
+     * retained until the snapshot is released; textures given only by their GL name must not be deleted before it is drawn.
+     * Disabled by default.
+     */
+    void setThreadedRenderingEnabled(bool enabled);
+    /** Whether or not threaded rendering is enabled. */
+    bool isThreadedRenderingEnabled() const { return _isThreadedRenderingEnabled; }
+
+    /**
+     * Records the render commands of the next rendered frame into a file, see RenderCapture.
+     * @param filePath The full path of the file.
+     */
+    void captureNextFrame(const std::string& filePath);
+    /**
+     * Loads a file saved by captureNextFrame() and processes its commands, as they were processed in the captured frame.
+     * It must be called outside of render(). Used with GLViewNull and CC_USE_NULL_GL, it measures the renderer alone.
+     * @param filePath The path of the file.
+     * @return false if the file can't be loaded.
+     */
+    bool replayCapture(const std::string& filePath);
+
     //This will not be used outside.
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
+    /**
+     Returns the allocator for render commands and vertex/index data that are only needed for this frame.
+     It is reset by clean() after the frame is drawn; its counters show whether a frame allocated from the heap.
+     */
+    inline FrameAllocator* getFrameAllocator() { return &_frameAllocator; }
+
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
@@ -209,10 +356,22 @@ protected:
 
     //Setup VBO or VAO based on OpenGL extensions
     void setupBuffer();
+    void allocateBatchBuffers();
     void setupVBOAndVAO();
     void setupVBO();
+    void deleteBuffers();
+    void setupStaticBuffers();
+    void resetStaticGeometry();
+    bool fillStaticGeometry(TrianglesCommand* cmd);
+    void bindTrianglesBuffers(bool useStaticBuffers);
     void mapBuffers();
     void drawBatchedTriangles();
+    void uploadTriangles(const V3F_C4B_T2F* verts, int vertexCount, const unsigned char* indices, int indexCount);
+    void deleteStreamBuffers();
+    void allocateQuadInstances();
+    void setupQuadInstanceBuffers();
+    bool queueQuadInstances(TrianglesCommand* cmd);
+    void drawQuadInstances();
 
     //Draw the previews queued triangles and flush previous context
     void flush();
@@ -222,9 +381,25 @@ protected:
     void flushTriangles();
 
     void processRenderCommand(RenderCommand* command);
+    void queueTrianglesCommand(TrianglesCommand* cmd);
+    void splitTrianglesCommand(TrianglesCommand* cmd);
     void visitRenderQueue(RenderQueue& queue);
 
+    void autoBatchCommands(std::vector<RenderCommand*>& commands);
+    bool cullTrianglesCommand(TrianglesCommand* cmd);
+
+    struct RenderFrame;
+    void renderThreaded();
+    bool isRenderQueueDeferrable(RenderQueue& queue);
+    void recordRenderQueue(RenderQueue& queue, RenderFrame* frame);
+    void prepareRenderFrame(RenderFrame* frame);
+    void drawRenderFrame(RenderFrame* frame);
+    void releaseRenderFrame(RenderFrame* frame);
+    RenderFrame* waitForRenderFrame();
+    void renderThreadLoop();
+
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
+    void rebaseIndices(const unsigned short* src, void* dst, size_t count, unsigned int offset) const;
 
 
     /* clear color set outside be used in setGLDefaultValues() */
@@ -237,17 +412,48 @@ protected:
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
     //for TrianglesCommand
-    V3F_C4B_T2F _verts[VBO_SIZE];
-    GLushort _indices[INDEX_VBO_SIZE];
+    std::vector<V3F_C4B_T2F> _verts;
+    // GLushort or GLuint indices, depending on _indexType
+    std::vector<unsigned char> _indices;
+    // size of the batch buffers, in vertices and indices
+    int _vboSize;
+    int _indexVBOSize;
+    // size asked with setBatchBufferSize(), it can only be validated once GL is available
+    int _requestedVBOSize;
+    GLenum _indexType;
+    GLsizei _indexSize;
     GLuint _buffersVAO;
     GLuint _buffersVBO[2]; //0: vertex  1: indices
 
+    // A vertex/index buffer pair the flushes of a frame append to when buffer streaming is enabled.
+    struct StreamBuffer
+    {
+        GLuint vao;
+        GLuint vbo[2];
+        int vertexCapacity;
+        int indexCapacity;
+        // where the next flush is written
+        int vertexOffset;
+        int indexOffset;
+    };
+    // makes room for a flush in the pair of the current frame, and sets _streamVertexBase and _streamIndexBase
+    StreamBuffer& appendStreamBuffer(int vertexCount, int indexCount);
+    StreamBuffer _streamBuffers[VBO_RING_SIZE];
+    // the pair of the current frame and the Director frame it was taken for
+    int _streamFrame;
+    unsigned int _streamFrameNumber;
+    // where the last flush was written in the pair of the current frame: its indices start from 0 at _streamVertexBase
+    int _streamVertexBase;
+    int _streamIndexBase;
+
     // Internal structure that has the information for the batches
     struct TriBatchToDraw {
         TrianglesCommand* cmd;  // needed for the Material
-        GLushort indicesToDraw;
-        GLushort offset;
+        GLuint indicesToDraw;
+        GLuint offset;
+        bool isStatic;          // drawn from the retained static buffers
     };
+    void drawTriangleBatches(const TriBatchToDraw* batches, int batchCount);
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity;
     // the TriBatches
@@ -256,18 +462,115 @@ protected:
     int _filledVertex;
     int _filledIndex;
 
+    // Internal structure used by the auto batching pass: a run of commands drawn together
+    struct AutoBatchBucket {
+        uint32_t materialID;
+        bool isBarrier;         // can't be moved across: not a 2D batchable TrianglesCommand
+        float z;                // view space z shared by the commands
+        float minX, minY, maxX, maxY; // view space bounds of the commands
+        int commandCount;
+    };
+    std::vector<AutoBatchBucket> _autoBatchBuckets;
+    // bucket of every command, then scratch copy of the commands
+    std::vector<int> _autoBatchBucketIDs;
+    std::vector<RenderCommand*> _autoBatchCommands;
+
+    // retained geometry of static TrianglesCommands, see TrianglesCommand::setStatic()
+    GLuint _staticBuffersVAO;
+    GLuint _staticBuffersVBO[2]; //0: vertex  1: indices
+    // bumped whenever the retained buffers are reset, which invalidates every retained command
+    unsigned int _staticGeometryGeneration;
+    int _staticFilledVertex;
+    int _staticFilledIndex;
+    bool _isStaticGeometryFull;
+    // regions left by commands whose geometry outgrew them
+    struct StaticRegion
+    {
+        int vertexOffset;
+        int indexOffset;
+        int vertexCount;
+        int indexCount;
+    };
+    std::vector<StaticRegion> _staticFreeRegions;
+    std::vector<V3F_C4B_T2F> _staticVerts;
+    std::vector<unsigned char> _staticIndices;
+
+    // instanced quads: the quad is origin + x * axisX + y * axisY in world space, for x and y in [0, 1]
+    struct QuadInstance {
+        Vec3 origin;
+        Vec3 axisX;
+        Vec3 axisY;
+        Tex2F texCoord;
+        Tex2F texAxisX;
+        Tex2F texAxisY;
+        Color4B color;
+    };
+    // consecutive instances drawn with the material of cmd
+    struct QuadInstanceBatch {
+        TrianglesCommand* cmd;
+        int offset;
+        int count;
+    };
+    // null unless instancing is enabled and supported
+    QuadInstance* _quadInstances;
+    int _filledQuadInstances;
+    std::vector<QuadInstanceBatch> _quadInstanceBatches;
+    GLuint _quadInstanceVBO[2]; //0: unit quad corners  1: instances
+    // program of the instanced commands, and the one drawing them
+    GLProgram* _quadInstanceSourceProgram;
+    GLProgram* _quadInstanceProgram;
+    // GL program the attribute locations were queried from
+    GLuint _quadInstanceProgramID;
+    GLint _quadInstanceAttribs[5];
+
+    // pieces of the TrianglesCommands that don't fit in the batch buffers, reused every frame
+    struct SplitTrianglesCommand;
+    std::vector<SplitTrianglesCommand*> _splitCommands;
+    size_t _usedSplitCommands;
+    // vertex of the original command -> vertex of the current piece, -1 if not in it
+    std::vector<int> _splitVertexRemap;
+
     bool _glViewAssigned;
 
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _batchesSavedByAutoBatching;
+    ssize_t _culledCommands;
+    ssize_t _culledVertices;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
 
     bool _isDepthTestFor2D;
 
+    bool _isBufferStreamingEnabled;
+
+    bool _isAutoBatchingEnabled;
+
+    bool _isCullingEnabled;
+
+    bool _isQuadInstancingEnabled;
+
+    // threaded rendering: a frame is recorded by render(), prepared by the render thread, and drawn by the next render()
+    RenderFrame* _renderFrames[2];
+    int _recordFrameIndex;
+    // frame handed to the render thread, and the one it finished, guarded by _renderThreadMutex
+    RenderFrame* _preparingFrame;
+    RenderFrame* _preparedFrame;
+    std::thread* _renderThread;
+    std::mutex _renderThreadMutex;
+    std::condition_variable _renderThreadCondition;
+    bool _renderThreadQuit;
+    bool _isThreadedRenderingEnabled;
+
     GroupCommandManager* _groupCommandManager;
 
+    FrameAllocator _frameAllocator;
+
+    // frame being captured, and the file it is saved into
+    RenderCapture* _capture;
+    std::string _captureFilePath;
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
 #endif
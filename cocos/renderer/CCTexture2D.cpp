@@ -47,12 +47,51 @@ THE SOFTWARE.
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "renderer/CCDynamicAtlas.h"
+#include "math/MathUtil.h"
+#include "base/etc2.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "renderer/CCTextureCache.h"
 #endif
 
 #include <unordered_set>
+#include <chrono>
+#include <atomic>
+
+// the same NEON selection as MathUtil: always used on arm64 and iOS, checked at runtime on Android armv7
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    #if defined (__arm64__) || defined (__aarch64__) || (defined (__ARM_NEON__) && CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+    #define USE_NEON_CONVERTERS
+    #define INCLUDE_NEON_CONVERTERS
+    #elif defined (__ARM_NEON__)
+    #define INCLUDE_NEON_CONVERTERS
+    #endif
+#elif defined (__SSE2__)
+    #define INCLUDE_SSE_CONVERTERS
+#endif
+
+#if defined (INCLUDE_NEON_CONVERTERS)
+#include "renderer/CCTexture2DNeon.inl"
+#define SIMD_PIXEL_CONVERTER PixelConverterNeon
+#elif defined (INCLUDE_SSE_CONVERTERS)
+#include "renderer/CCTexture2DSSE.inl"
+#define SIMD_PIXEL_CONVERTER PixelConverterSSE
+#endif
+
+// ETC2 and ASTC are core in GLES 3.x and may be missing from older GL headers
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_5x5_KHR
+#define GL_COMPRESSED_RGBA_ASTC_5x5_KHR 0x93B2
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_6x6_KHR
+#define GL_COMPRESSED_RGBA_ASTC_6x6_KHR 0x93B4
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+#define GL_COMPRESSED_RGBA_ASTC_8x8_KHR 0x93B7
+#endif
 
 NS_CC_BEGIN
 
@@ -107,6 +146,15 @@ namespace {
         PixelFormatInfoMapValue(Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA, Texture2D::PixelFormatInfo(GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD,
             0xFFFFFFFF, 0xFFFFFFFF, 8, true, false)),
 #endif
+
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGB, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGB8_ETC2, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, false)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGBA, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA8_ETC2_EAC, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+
+        // ASTC blocks are always 128 bits, bpp is rounded down for the bigger footprints
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_4x4, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_5x5, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_5x5_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 5, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_6x6, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_6x6_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 3, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_8x8, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_8x8_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 2, true, true)),
     };
 }
 
@@ -120,6 +168,28 @@ const Texture2D::PixelFormatInfoMap Texture2D::_pixelFormatInfoTables(TexturePix
 // Default is: RGBA8888 (32-bit textures)
 static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat::DEFAULT;
 
+// turned off by benchmarkPixelFormatConversions() to time the scalar code,
+// while the TextureCache loading threads may be converting images
+static std::atomic<bool> s_simdConvertersEnabled(true);
+
+static bool isSIMDConverterAvailable()
+{
+#if defined (USE_NEON_CONVERTERS) || defined (INCLUDE_SSE_CONVERTERS)
+    return s_simdConvertersEnabled;
+#elif defined (INCLUDE_NEON_CONVERTERS)
+    return s_simdConvertersEnabled && MathUtil::isNeon32Enabled();
+#else
+    return false;
+#endif
+}
+
+// converts the leading pixels with the SIMD code when available, and returns their number
+#ifdef SIMD_PIXEL_CONVERTER
+#define SIMD_CONVERT(func, ...) (isSIMDConverterAvailable() ? SIMD_PIXEL_CONVERTER::func(__VA_ARGS__) : 0)
+#else
+#define SIMD_CONVERT(func, ...) 0
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 //convertor function
 
@@ -148,7 +218,9 @@ void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0; i < dataLen; ++i)
+    ssize_t done = SIMD_CONVERT(convertI8ToRGBA8888, data, dataLen, outData);
+    outData += done * 4;
+    for (ssize_t i = done; i < dataLen; ++i)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -160,7 +232,9 @@ void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t done = SIMD_CONVERT(convertAI88ToRGBA8888, data, dataLen / 2, outData);
+    outData += done * 4;
+    for (ssize_t i = done * 2, l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -277,7 +351,9 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = SIMD_CONVERT(convertRGB888ToRGBA8888, data, dataLen / 3, outData);
+    outData += done * 4;
+    for (ssize_t i = done * 3, l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -289,7 +365,9 @@ void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t done = SIMD_CONVERT(convertRGBA8888ToRGB888, data, dataLen / 4, outData);
+    outData += done * 3;
+    for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -300,8 +378,9 @@ void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = SIMD_CONVERT(convertRGB888ToRGB565, data, dataLen / 3, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 3, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -312,8 +391,9 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t done = SIMD_CONVERT(convertRGBA8888ToRGB565, data, dataLen / 4, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -351,7 +431,9 @@ void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
+    ssize_t done = SIMD_CONVERT(convertRGBA8888ToA8, data, dataLen / 4, outData);
+    outData += done;
+    for (ssize_t i = done * 4, l = dataLen -3; i < l; i += 4)
     {
         *outData++ = data[i + 3]; //A
     }
@@ -381,8 +463,9 @@ void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = SIMD_CONVERT(convertRGB888ToRGBA4444, data, dataLen / 3, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 3, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = ((data[i] & 0x00F0) << 8           //R
                     | (data[i + 1] & 0x00F0) << 4     //G
@@ -394,8 +477,9 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t done = SIMD_CONVERT(convertRGBA8888ToRGBA4444, data, dataLen / 4, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i + 1] & 0x00F0) << 4         //G
@@ -407,8 +491,9 @@ void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dat
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t done = SIMD_CONVERT(convertRGB888ToRGB5A1, data, dataLen / 3, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 3, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -420,8 +505,9 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    ssize_t done = SIMD_CONVERT(convertRGBA8888ToRGB5A1, data, dataLen / 4, outData);
+    unsigned short* out16 = (unsigned short*)outData + done;
+    for (ssize_t i = done * 4, l = dataLen - 2; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -429,6 +515,16 @@ void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataL
             |  (data[i + 3] & 0x0080) >> 7;   //A
     }
 }
+void Texture2D::convertRGBA8888ToPremultipliedAlpha(unsigned char* data, ssize_t dataLen)
+{
+    ssize_t done = SIMD_CONVERT(premultiplyAlpha, data, dataLen / 4);
+    unsigned int* fourBytes = (unsigned int*)data;
+    for (ssize_t i = done, l = dataLen / 4; i < l; ++i)
+    {
+        unsigned char* p = data + i * 4;
+        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+    }
+}
 // converter function end
 //////////////////////////////////////////////////////////////////////////
 static std::unordered_set<Texture2D*> s_allGLTexture2D;
@@ -456,6 +552,7 @@ Texture2D::Texture2D()
 , _ninePatchInfo(nullptr)
 , _valid(true)
 , _alphaTexture(nullptr)
+, _atlasTexture(nullptr)
 {
     s_allGLTexture2D.insert(this);
     _antialiasEnabled = Director::getInstance()->getOpenGLView()->isAntiAliasEnabled();
@@ -470,6 +567,11 @@ Texture2D::~Texture2D()
     VolatileTextureMgr::removeTexture(this);
 #endif
 
+    if (_atlasTexture)
+    {
+        DynamicAtlas::removeTexture(this);
+    }
+
     CCLOGINFO("deallocing Texture2D: %p - id=%u", this, _name);
     CC_SAFE_RELEASE(_shaderProgram);
 
@@ -566,6 +668,27 @@ bool Texture2D::hasPremultipliedAlpha() const
     return _hasPremultipliedAlpha;
 }
 
+// the largest alignment that tightly packed rows satisfy
+static void setUnpackAlignment(unsigned int bytesPerRow)
+{
+    if(bytesPerRow % 8 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+    }
+    else if(bytesPerRow % 4 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    else if(bytesPerRow % 2 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    }
+    else
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+}
+
 bool Texture2D::initWithData(const void *data, ssize_t dataLen, Texture2D::PixelFormat pixelFormat, int pixelsWide, int pixelsHigh, const Size& contentSize)
 {
     CCASSERT(dataLen>0 && pixelsWide>0 && pixelsHigh>0, "Invalid size");
@@ -599,35 +722,20 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     const PixelFormatInfo& info = _pixelFormatInfoTables.at(pixelFormat);
 
     if (info.compressed && !Configuration::getInstance()->supportsPVRTC()
-                        && !Configuration::getInstance()->supportsETC())
+                        && !Configuration::getInstance()->supportsETC()
+                        && !Configuration::getInstance()->supportsETC2()
+                        && !Configuration::getInstance()->supportsASTC())
 //                        && !Configuration::getInstance()->supportsS3TC()
 //                        && !Configuration::getInstance()->supportsATITC())
     {
-        CCLOG("cocos2d: WARNING: PVRTC/ETC images are not supported");
+        CCLOG("cocos2d: WARNING: PVRTC/ETC/ASTC images are not supported");
         return false;
     }
 
     //Set the row align only when mipmapsNum == 1 and the data is uncompressed
     if (mipmapsNum == 1 && !info.compressed)
     {
-        unsigned int bytesPerRow = pixelsWide * info.bpp / 8;
-
-        if(bytesPerRow % 8 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
-        }
-        else if(bytesPerRow % 4 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-        }
-        else if(bytesPerRow % 2 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-        }
-        else
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        }
+        setUnpackAlignment(pixelsWide * info.bpp / 8);
     }else
     {
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -736,6 +844,22 @@ bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int widt
     return false;
 }
 
+bool Texture2D::updateWithRows(const void *data, int firstRow, int rowCount)
+{
+    const PixelFormatInfo& info = _pixelFormatInfoTables.at(_pixelFormat);
+    if (_name == 0 || info.compressed)
+    {
+        return false;
+    }
+
+    unsigned int bytesPerRow = _pixelsWide * info.bpp / 8;
+    setUnpackAlignment(bytesPerRow);
+    GL::bindTexture2D(_name);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, _pixelsWide, rowCount, info.format, info.type,
+                    (const unsigned char*)data + (size_t)firstRow * bytesPerRow);
+    return true;
+}
+
 std::string Texture2D::getDescription() const
 {
     return StringUtils::format("<Texture2D | Name = %u | Dimensions = %ld x %ld | Coordinates = (%.2f, %.2f)>", _name, (long)_pixelsWide, (long)_pixelsHigh, _maxS, _maxT);
@@ -1078,6 +1202,69 @@ Texture2D::PixelFormat Texture2D::convertDataToFormat(const unsigned char* data,
     }
 }
 
+bool Texture2D::convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char* outData)
+{
+    typedef void (*Converter)(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    struct Conversion
+    {
+        PixelFormat originFormat;
+        PixelFormat format;
+        Converter convert;
+    };
+    // the same conversions as convertDataToFormat() above
+    static const Conversion conversions[] = {
+        { PixelFormat::I8, PixelFormat::RGBA8888, convertI8ToRGBA8888 },
+        { PixelFormat::I8, PixelFormat::RGB888, convertI8ToRGB888 },
+        { PixelFormat::I8, PixelFormat::RGB565, convertI8ToRGB565 },
+        { PixelFormat::I8, PixelFormat::AI88, convertI8ToAI88 },
+        { PixelFormat::I8, PixelFormat::RGBA4444, convertI8ToRGBA4444 },
+        { PixelFormat::I8, PixelFormat::RGB5A1, convertI8ToRGB5A1 },
+        { PixelFormat::AI88, PixelFormat::RGBA8888, convertAI88ToRGBA8888 },
+        { PixelFormat::AI88, PixelFormat::RGB888, convertAI88ToRGB888 },
+        { PixelFormat::AI88, PixelFormat::RGB565, convertAI88ToRGB565 },
+        { PixelFormat::AI88, PixelFormat::A8, convertAI88ToA8 },
+        { PixelFormat::AI88, PixelFormat::I8, convertAI88ToI8 },
+        { PixelFormat::AI88, PixelFormat::RGBA4444, convertAI88ToRGBA4444 },
+        { PixelFormat::AI88, PixelFormat::RGB5A1, convertAI88ToRGB5A1 },
+        { PixelFormat::RGB888, PixelFormat::RGBA8888, convertRGB888ToRGBA8888 },
+        { PixelFormat::RGB888, PixelFormat::RGB565, convertRGB888ToRGB565 },
+        { PixelFormat::RGB888, PixelFormat::A8, convertRGB888ToA8 },
+        { PixelFormat::RGB888, PixelFormat::I8, convertRGB888ToI8 },
+        { PixelFormat::RGB888, PixelFormat::AI88, convertRGB888ToAI88 },
+        { PixelFormat::RGB888, PixelFormat::RGBA4444, convertRGB888ToRGBA4444 },
+        { PixelFormat::RGB888, PixelFormat::RGB5A1, convertRGB888ToRGB5A1 },
+        { PixelFormat::RGBA8888, PixelFormat::RGB888, convertRGBA8888ToRGB888 },
+        { PixelFormat::RGBA8888, PixelFormat::RGB565, convertRGBA8888ToRGB565 },
+        { PixelFormat::RGBA8888, PixelFormat::A8, convertRGBA8888ToA8 },
+        { PixelFormat::RGBA8888, PixelFormat::I8, convertRGBA8888ToI8 },
+        { PixelFormat::RGBA8888, PixelFormat::AI88, convertRGBA8888ToAI88 },
+        { PixelFormat::RGBA8888, PixelFormat::RGBA4444, convertRGBA8888ToRGBA4444 },
+        { PixelFormat::RGBA8888, PixelFormat::RGB5A1, convertRGBA8888ToRGB5A1 },
+    };
+
+    if (format == originFormat)
+    {
+        if (outData != nullptr)
+        {
+            memcpy(outData, data, dataLen);
+        }
+        return true;
+    }
+
+    for (const auto& conversion : conversions)
+    {
+        if (conversion.originFormat == originFormat && conversion.format == format)
+        {
+            if (outData != nullptr)
+            {
+                conversion.convert(data, dataLen, outData);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 // implementation Texture2D (Text)
 bool Texture2D::initWithString(const std::string& text, const std::string& fontName, float fontSize, const Size& dimensions/* = Size(0, 0)*/, TextHAlignment hAlignment/* =  TextHAlignment::CENTER */, TextVAlignment vAlignment/* =  TextVAlignment::TOP */, bool enableWrap /* = false */, int overflow /* = 0 */)
 {
@@ -1366,6 +1553,27 @@ const char* Texture2D::getStringForFormat() const
         case Texture2D::PixelFormat::PVRTC2:
             return  "PVRTC2";
 
+        case Texture2D::PixelFormat::ETC:
+            return  "ETC";
+
+        case Texture2D::PixelFormat::ETC2_RGB:
+            return  "ETC2_RGB";
+
+        case Texture2D::PixelFormat::ETC2_RGBA:
+            return  "ETC2_RGBA";
+
+        case Texture2D::PixelFormat::ASTC_4x4:
+            return  "ASTC_4x4";
+
+        case Texture2D::PixelFormat::ASTC_5x5:
+            return  "ASTC_5x5";
+
+        case Texture2D::PixelFormat::ASTC_6x6:
+            return  "ASTC_6x6";
+
+        case Texture2D::PixelFormat::ASTC_8x8:
+            return  "ASTC_8x8";
+
         default:
             CCASSERT(false , "unrecognized pixel format");
             CCLOG("stringForFormat: %ld, cannot give useful result", (long)_pixelFormat);
@@ -1405,11 +1613,152 @@ unsigned int Texture2D::getBitsPerPixelForFormat() const
     return this->getBitsPerPixelForFormat(_pixelFormat);
 }
 
+size_t Texture2D::getGPUMemorySize() const
+{
+    auto info = _pixelFormatInfoTables.find(_pixelFormat);
+    if (_name == 0 || info == _pixelFormatInfoTables.end())
+    {
+        return 0;
+    }
+
+    const size_t bpp = info->second.bpp;
+    size_t width = _pixelsWide;
+    size_t height = _pixelsHigh;
+    size_t bytes = 0;
+    while (true)
+    {
+        if (!info->second.compressed)
+        {
+            bytes += width * height * bpp / 8;
+        }
+        else if (_pixelFormat == PixelFormat::PVRTC2 || _pixelFormat == PixelFormat::PVRTC2A)
+        {
+            // 8x4 blocks, at least 2x2 of them
+            bytes += std::max(width, (size_t)16) * std::max(height, (size_t)8) * bpp / 8;
+        }
+        else if (_pixelFormat == PixelFormat::PVRTC4 || _pixelFormat == PixelFormat::PVRTC4A)
+        {
+            // 4x4 blocks, at least 2x2 of them
+            bytes += std::max(width, (size_t)8) * std::max(height, (size_t)8) * bpp / 8;
+        }
+        else if (_pixelFormat >= PixelFormat::ASTC_4x4 && _pixelFormat <= PixelFormat::ASTC_8x8)
+        {
+            // 16 bytes per block, whatever the footprint
+            static const size_t astcBlocks[] = { 4, 5, 6, 8 };
+            const size_t block = astcBlocks[(int)_pixelFormat - (int)PixelFormat::ASTC_4x4];
+            bytes += ((width + block - 1) / block) * ((height + block - 1) / block) * 16;
+        }
+        else
+        {
+            // ETC, ETC2, S3TC and ATITC use 4x4 blocks
+            bytes += ((width + 3) / 4) * ((height + 3) / 4) * 16 * bpp / 8;
+        }
+
+        if (!_hasMipmaps || (width == 1 && height == 1))
+        {
+            break;
+        }
+        width = std::max(width / 2, (size_t)1);
+        height = std::max(height / 2, (size_t)1);
+    }
+    return bytes;
+}
+
 const Texture2D::PixelFormatInfoMap& Texture2D::getPixelFormatInfoMap()
 {
     return _pixelFormatInfoTables;
 }
 
+std::string Texture2D::benchmarkPixelFormatConversions(int width, int height)
+{
+    struct FormatName
+    {
+        PixelFormat format;
+        const char* name;
+        int bytesPerPixel;
+    };
+    static const FormatName origins[] = {
+        { PixelFormat::I8, "I8", 1 },
+        { PixelFormat::AI88, "AI88", 2 },
+        { PixelFormat::RGB888, "RGB888", 3 },
+        { PixelFormat::RGBA8888, "RGBA8888", 4 },
+    };
+    static const FormatName targets[] = {
+        { PixelFormat::RGBA8888, "RGBA8888", 4 },
+        { PixelFormat::RGB888, "RGB888", 3 },
+        { PixelFormat::RGB565, "RGB565", 2 },
+        { PixelFormat::RGBA4444, "RGBA4444", 2 },
+        { PixelFormat::RGB5A1, "RGB5A1", 2 },
+        { PixelFormat::AI88, "AI88", 2 },
+        { PixelFormat::A8, "A8", 1 },
+        { PixelFormat::I8, "I8", 1 },
+    };
+
+    const ssize_t pixels = (ssize_t)width * height;
+    unsigned char* data = (unsigned char*)malloc(pixels * 4);
+    unsigned char* copy = (unsigned char*)malloc(pixels * 4);
+    for (ssize_t i = 0; i < pixels * 4; ++i)
+    {
+        data[i] = (unsigned char)(rand() & 0xFF);
+    }
+
+    std::string report = StringUtils::format("Pixel format conversions of %d x %d pixels, scalar / SIMD:\n", width, height);
+    const bool simdEnabled = s_simdConvertersEnabled.load();
+    for (const auto& origin : origins)
+    {
+        for (const auto& target : targets)
+        {
+            if (origin.format == target.format
+                || (origin.format == PixelFormat::I8 && target.format == PixelFormat::A8)
+                || (origin.format == PixelFormat::RGBA8888 && target.format == PixelFormat::RGBA8888))
+            {
+                continue;
+            }
+
+            unsigned char* outData[2] = { nullptr, nullptr };
+            ssize_t outDataLen[2] = { 0, 0 };
+            float milliseconds[2];
+            for (int simd = 0; simd < 2; ++simd)
+            {
+                s_simdConvertersEnabled = (simd == 1);
+                auto start = std::chrono::steady_clock::now();
+                convertDataToFormat(data, pixels * origin.bytesPerPixel, origin.format, target.format, &outData[simd], &outDataLen[simd]);
+                milliseconds[simd] = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            bool same = outDataLen[0] == outDataLen[1] && memcmp(outData[0], outData[1], outDataLen[0]) == 0;
+            report += StringUtils::format("%8s -> %-8s %7.2f / %7.2f ms%s\n", origin.name, target.name,
+                                          milliseconds[0], milliseconds[1], same ? "" : "  MISMATCH");
+            for (int simd = 0; simd < 2; ++simd)
+            {
+                if (outData[simd] != data)
+                {
+                    free(outData[simd]);
+                }
+            }
+        }
+    }
+
+    float milliseconds[2];
+    unsigned char* premultiplied = (unsigned char*)malloc(pixels * 4);
+    for (int simd = 0; simd < 2; ++simd)
+    {
+        s_simdConvertersEnabled = (simd == 1);
+        memcpy(simd == 0 ? premultiplied : copy, data, pixels * 4);
+        auto start = std::chrono::steady_clock::now();
+        convertRGBA8888ToPremultipliedAlpha(simd == 0 ? premultiplied : copy, pixels * 4);
+        milliseconds[simd] = std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(std::chrono::steady_clock::now() - start).count();
+    }
+    bool same = memcmp(premultiplied, copy, pixels * 4) == 0;
+    report += StringUtils::format("%8s premultiply %7.2f / %7.2f ms%s\n", "RGBA8888", milliseconds[0], milliseconds[1], same ? "" : "  MISMATCH");
+
+    s_simdConvertersEnabled = simdEnabled;
+    free(premultiplied);
+    free(copy);
+    free(data);
+    return report;
+}
+
 void Texture2D::addSpriteFrameCapInset(SpriteFrame* spritframe, const Rect& capInsets)
 {
     if(nullptr == _ninePatchInfo)
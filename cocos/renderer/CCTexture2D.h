@@ -114,6 +114,18 @@ public:
         ATC_EXPLICIT_ALPHA,
         //! ATITC-compressed texture: ATC_INTERPOLATED_ALPHA
         ATC_INTERPOLATED_ALPHA,
+        //! ETC2-compressed texture: ETC2_RGB
+        ETC2_RGB,
+        //! ETC2-compressed texture: ETC2_RGBA (has alpha channel)
+        ETC2_RGBA,
+        //! ASTC-compressed texture: ASTC_4x4
+        ASTC_4x4,
+        //! ASTC-compressed texture: ASTC_5x5
+        ASTC_5x5,
+        //! ASTC-compressed texture: ASTC_6x6
+        ASTC_6x6,
+        //! ASTC-compressed texture: ASTC_8x8
+        ASTC_8x8,
         //! Default texture format: AUTO
         DEFAULT = AUTO,
 
@@ -232,6 +244,14 @@ public:
      @param height Specifies the height of the texture subimage.
      */
     bool updateWithData(const void *data,int offsetX,int offsetY,int width,int height);
+
+    /** Update whole rows of an uncompressed texture, to upload it in parts.
+
+     @param data Specifies a pointer to the data of all the rows of the texture, tightly packed, in the texture pixel format.
+     @param firstRow Specifies the first row to update.
+     @param rowCount Specifies the number of rows to update.
+     */
+    bool updateWithRows(const void *data, int firstRow, int rowCount);
     /**
     Drawing extensions to make it easy to draw basic quads using a Texture2D object.
     These functions require GL_TEXTURE_2D and both GL_VERTEX_ARRAY and GL_TEXTURE_COORD_ARRAY client states to be enabled.
@@ -337,6 +357,11 @@ public:
      */
     unsigned int getBitsPerPixelForFormat(Texture2D::PixelFormat format) const;
 
+    /** Returns an estimate of the GPU memory used by the texture, in bytes.
+     * It accounts for the mipmap levels and for the block sizes of the compressed formats.
+     */
+    size_t getGPUMemorySize() const;
+
     /** Get content size. */
     const Size& getContentSizeInPixels();
 
@@ -385,10 +410,31 @@ public:
     void setAlphaTexture(Texture2D* alphaTexture);
 
     GLuint getAlphaTextureName() const;
+
+    /** Get the dynamic atlas page this texture is also packed into, or nullptr. See TextureCache::setDynamicAtlasEnabled(). */
+    Texture2D* getAtlasTexture() const { return _atlasTexture; }
+    /** Get the rect of this texture in its dynamic atlas page, in pixels. */
+    const Rect& getAtlasRectInPixels() const { return _atlasRect; }
 public:
     /** Get pixel info map, the key-value pairs is PixelFormat and PixelFormatInfo.*/
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
 
+    /** Premultiplies the color of RGBA8888 pixels by their alpha, in place. Uses SSE2 or NEON when available. */
+    static void convertRGBA8888ToPremultipliedAlpha(unsigned char* data, ssize_t dataLen);
+
+    /**
+    Convert the pixels into a buffer of the caller, large enough for the converted pixels, e.g. to convert an image row by row.
+    It returns false and leaves outData untouched if there is no conversion from originFormat to format,
+    pass a null outData to only check whether there is one.
+    */
+    static bool convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char* outData);
+
+    /** Times convertDataToFormat() for every pair of formats it converts, and the alpha premultiplication,
+     * with the scalar and the SIMD converters, and checks they give the same pixels.
+     * Returns one line per conversion. Used by the console command "texture bench".
+     */
+    static std::string benchmarkPixelFormatConversions(int width, int height);
+
 private:
     // noncopyable
     Texture2D(const Texture2D&) = delete;
@@ -533,11 +579,16 @@ protected:
     friend class SpriteFrameCache;
     friend class TextureCache;
     friend class ui::Scale9Sprite;
+    friend class DynamicAtlas;
 
     bool _valid;
     std::string _filePath;
 
     Texture2D* _alphaTexture;
+
+    /** dynamic atlas page holding a copy of the texture, and where */
+    Texture2D* _atlasTexture;
+    Rect _atlasRect;
 };
 
 
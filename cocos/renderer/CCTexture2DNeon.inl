@@ -0,0 +1,198 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <arm_neon.h>
+
+NS_CC_BEGIN
+
+/** NEON versions of Texture2D pixel format converters, bit-exact with the scalar ones.
+ * Each function converts the leading pixels it processes in whole blocks and returns their number,
+ * the caller converts the remaining ones with the scalar code.
+ */
+class PixelConverterNeon
+{
+public:
+    static ssize_t convertI8ToRGBA8888(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x4_t out;
+            out.val[0] = out.val[1] = out.val[2] = vld1_u8(data + i);
+            out.val[3] = vdup_n_u8(0xFF);
+            vst4_u8(outData + i * 4, out);
+        }
+        return i;
+    }
+
+    static ssize_t convertAI88ToRGBA8888(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x2_t in = vld2_u8(data + i * 2);
+            uint8x8x4_t out;
+            out.val[0] = out.val[1] = out.val[2] = in.val[0];
+            out.val[3] = in.val[1];
+            vst4_u8(outData + i * 4, out);
+        }
+        return i;
+    }
+
+    static ssize_t convertRGB888ToRGBA8888(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x3_t in = vld3_u8(data + i * 3);
+            uint8x8x4_t out;
+            out.val[0] = in.val[0];
+            out.val[1] = in.val[1];
+            out.val[2] = in.val[2];
+            out.val[3] = vdup_n_u8(0xFF);
+            vst4_u8(outData + i * 4, out);
+        }
+        return i;
+    }
+
+    static ssize_t convertRGBA8888ToRGB888(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x4_t in = vld4_u8(data + i * 4);
+            uint8x8x3_t out;
+            out.val[0] = in.val[0];
+            out.val[1] = in.val[1];
+            out.val[2] = in.val[2];
+            vst3_u8(outData + i * 3, out);
+        }
+        return i;
+    }
+
+    // the RGB888 converters behave as if alpha was 0xFF
+    static ssize_t convertRGB888ToRGB565(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertTo16<3, toRGB565>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGB888ToRGBA4444(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertTo16<3, toRGBA4444>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGB888ToRGB5A1(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertTo16<3, toRGB5A1>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertTo16<4, toRGB565>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertTo16<4, toRGBA4444>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertTo16<4, toRGB5A1>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            vst1_u8(outData + i, vld4_u8(data + i * 4).val[3]);
+        }
+        return i;
+    }
+
+    static ssize_t premultiplyAlpha(unsigned char* data, ssize_t pixels)
+    {
+        const uint16x8_t one = vdupq_n_u16(1);
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x4_t p = vld4_u8(data + i * 4);
+            uint16x8_t a = vaddw_u8(one, p.val[3]);
+            p.val[0] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[0]), a), 8);
+            p.val[1] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[1]), a), 8);
+            p.val[2] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[2]), a), 8);
+            vst4_u8(data + i * 4, p);
+        }
+        return i;
+    }
+
+private:
+    static inline uint16x8_t toRGB565(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+    {
+        uint16x8_t out = vshlq_n_u16(vmovl_u8(vand_u8(r, vdup_n_u8(0xF8))), 8);
+        out = vorrq_u16(out, vshlq_n_u16(vmovl_u8(vand_u8(g, vdup_n_u8(0xFC))), 3));
+        return vorrq_u16(out, vmovl_u8(vshr_n_u8(b, 3)));
+    }
+
+    static inline uint16x8_t toRGBA4444(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+    {
+        uint16x8_t out = vshlq_n_u16(vmovl_u8(vand_u8(r, vdup_n_u8(0xF0))), 8);
+        out = vorrq_u16(out, vshlq_n_u16(vmovl_u8(vand_u8(g, vdup_n_u8(0xF0))), 4));
+        out = vorrq_u16(out, vmovl_u8(vand_u8(b, vdup_n_u8(0xF0))));
+        return vorrq_u16(out, vmovl_u8(vshr_n_u8(a, 4)));
+    }
+
+    static inline uint16x8_t toRGB5A1(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+    {
+        uint16x8_t out = vshlq_n_u16(vmovl_u8(vand_u8(r, vdup_n_u8(0xF8))), 8);
+        out = vorrq_u16(out, vshlq_n_u16(vmovl_u8(vand_u8(g, vdup_n_u8(0xF8))), 3));
+        out = vorrq_u16(out, vmovl_u8(vshr_n_u8(vand_u8(b, vdup_n_u8(0xF8)), 2)));
+        return vorrq_u16(out, vmovl_u8(vshr_n_u8(a, 7)));
+    }
+
+    template <int BytesPerPixel, uint16x8_t (*Convert)(uint8x8_t, uint8x8_t, uint8x8_t, uint8x8_t)>
+    static ssize_t convertTo16(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint16x8_t out;
+            if (BytesPerPixel == 4)
+            {
+                uint8x8x4_t in = vld4_u8(data + i * 4);
+                out = Convert(in.val[0], in.val[1], in.val[2], in.val[3]);
+            }
+            else
+            {
+                uint8x8x3_t in = vld3_u8(data + i * 3);
+                out = Convert(in.val[0], in.val[1], in.val[2], vdup_n_u8(0xFF));
+            }
+            vst1q_u16((uint16_t*)(outData + i * 2), out);
+        }
+        return i;
+    }
+};
+
+NS_CC_END
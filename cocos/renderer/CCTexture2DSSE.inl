@@ -0,0 +1,182 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <emmintrin.h>
+
+NS_CC_BEGIN
+
+/** SSE2 versions of Texture2D pixel format converters, bit-exact with the scalar ones.
+ * Each function converts the leading pixels it processes in whole blocks and returns their number,
+ * the caller converts the remaining ones with the scalar code.
+ * SSE2 has no byte shuffle, so the 3 bytes per pixel formats are left to the scalar code.
+ */
+class PixelConverterSSE
+{
+public:
+    static ssize_t convertI8ToRGBA8888(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+        ssize_t i = 0;
+        for (; i + 16 <= pixels; i += 16)
+        {
+            __m128i in = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i lo = _mm_unpacklo_epi8(in, in);
+            __m128i hi = _mm_unpackhi_epi8(in, in);
+            __m128i* out = (__m128i*)(outData + i * 4);
+            _mm_storeu_si128(out, _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+            _mm_storeu_si128(out + 3, _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+        }
+        return i;
+    }
+
+    static ssize_t convertAI88ToRGBA8888(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        const __m128i keep = _mm_set1_epi32((int)0xFFFF00FF);
+        const __m128i intensity = _mm_set1_epi32(0xFF);
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            __m128i in = _mm_loadu_si128((const __m128i*)(data + i * 2));
+            // IAIA per pixel, then the second byte becomes I
+            __m128i lo = _mm_unpacklo_epi16(in, in);
+            __m128i hi = _mm_unpackhi_epi16(in, in);
+            lo = _mm_or_si128(_mm_and_si128(lo, keep), _mm_slli_epi32(_mm_and_si128(lo, intensity), 8));
+            hi = _mm_or_si128(_mm_and_si128(hi, keep), _mm_slli_epi32(_mm_and_si128(hi, intensity), 8));
+            __m128i* out = (__m128i*)(outData + i * 4);
+            _mm_storeu_si128(out, lo);
+            _mm_storeu_si128(out + 1, hi);
+        }
+        return i;
+    }
+
+    static ssize_t convertRGB888ToRGBA8888(const unsigned char*, ssize_t, unsigned char*) { return 0; }
+    static ssize_t convertRGB888ToRGB565(const unsigned char*, ssize_t, unsigned char*) { return 0; }
+    static ssize_t convertRGB888ToRGBA4444(const unsigned char*, ssize_t, unsigned char*) { return 0; }
+    static ssize_t convertRGB888ToRGB5A1(const unsigned char*, ssize_t, unsigned char*) { return 0; }
+    static ssize_t convertRGBA8888ToRGB888(const unsigned char*, ssize_t, unsigned char*) { return 0; }
+
+    static ssize_t convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertRGBA8888To16<toRGB565>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertRGBA8888To16<toRGBA4444>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        return convertRGBA8888To16<toRGB5A1>(data, pixels, outData);
+    }
+
+    static ssize_t convertRGBA8888ToA8(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 16 <= pixels; i += 16)
+        {
+            const __m128i* in = (const __m128i*)(data + i * 4);
+            __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(in), 24);
+            __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(in + 1), 24);
+            __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(in + 2), 24);
+            __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(in + 3), 24);
+            __m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+            _mm_storeu_si128((__m128i*)(outData + i), a);
+        }
+        return i;
+    }
+
+    static ssize_t premultiplyAlpha(unsigned char* data, ssize_t pixels)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+        ssize_t i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i* p = (__m128i*)(data + i * 4);
+            __m128i in = _mm_loadu_si128(p);
+            // 16 bits channels of 2 pixels, multiplied by their alpha + 1
+            __m128i lo = _mm_unpacklo_epi8(in, zero);
+            __m128i hi = _mm_unpackhi_epi8(in, zero);
+            __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            lo = _mm_srli_epi16(_mm_mullo_epi16(lo, _mm_add_epi16(alo, one)), 8);
+            hi = _mm_srli_epi16(_mm_mullo_epi16(hi, _mm_add_epi16(ahi, one)), 8);
+            __m128i out = _mm_packus_epi16(lo, hi);
+            out = _mm_or_si128(_mm_andnot_si128(alphaMask, out), _mm_and_si128(in, alphaMask));
+            _mm_storeu_si128(p, out);
+        }
+        return i;
+    }
+
+private:
+    // the 16 bits pixels are computed in the low half of 32 bits lanes, R in the lowest byte
+    static inline __m128i toRGB565(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x1F));
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+
+    static inline __m128i toRGBA4444(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0xF0));
+        __m128i a = _mm_srli_epi32(p, 28);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+
+    static inline __m128i toRGB5A1(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x3E));
+        __m128i a = _mm_srli_epi32(p, 31);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+
+    template <__m128i (*Convert)(__m128i)>
+    static ssize_t convertRGBA8888To16(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+    {
+        ssize_t i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            const __m128i* in = (const __m128i*)(data + i * 4);
+            __m128i lo = Convert(_mm_loadu_si128(in));
+            __m128i hi = Convert(_mm_loadu_si128(in + 1));
+            // packs saturates signed values, sign extending the low halves lets them through unchanged
+            lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+            hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+            _mm_storeu_si128((__m128i*)(outData + i * 2), _mm_packs_epi32(lo, hi));
+        }
+        return i;
+    }
+};
+
+NS_CC_END
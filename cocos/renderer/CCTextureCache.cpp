@@ -31,13 +31,17 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCConfiguration.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCDecodedImageCache.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
 
@@ -55,9 +59,15 @@ TextureCache* TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _loadingThreadCount(std::max(1, std::min(4, (int)std::thread::hardware_concurrency() - 1)))
 , _needQuit(false)
 , _asyncRefCount(0)
+, _dynamicAtlas(nullptr)
+, _memoryBudget(0)
+, _memoryUsage(0)
+, _useCounter(0)
+, _asyncUploadBytesPerFrame(0)
+, _asyncUploadMicrosecondsPerFrame(0)
 {
 }
 
@@ -68,7 +78,11 @@ TextureCache::~TextureCache()
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    for (auto thread : _loadingThreads)
+    {
+        delete thread;
+    }
+    CC_SAFE_DELETE(_dynamicAtlas);
 }
 
 void TextureCache::destroyInstance()
@@ -83,37 +97,67 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f)
+    AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f, int p)
     : filename(fn)
-    , callback(f)
     , image(new (std::nothrow) Image())
     , imageAlpha(new (std::nothrow) Image())
     , pixelFormat(Texture2D::getDefaultAlphaPixelFormat())
+    , priority(p)
+    , cancelled(false)
     , loadSuccess(false)
-    {}
+    , uploadData(nullptr)
+    , uploadDataLen(0)
+    , uploadFormat(Texture2D::PixelFormat::NONE)
+    , texture(nullptr)
+    , uploadedRows(0)
+    {
+        callbacks.push_back(f);
+    }
 
     ~AsyncStruct()
     {
+        if (uploadData != nullptr && uploadData != image->getData())
+        {
+            free(uploadData);
+        }
+        CC_SAFE_RELEASE(texture);
         CC_SAFE_RELEASE(image);
         CC_SAFE_RELEASE(imageAlpha);
     }
 
     std::string filename;
-    std::function<void(Texture2D*)> callback;
+    // one per addImageAsync() call for the file
+    std::vector<std::function<void(Texture2D*)>> callbacks;
     Image* image;
     Image* imageAlpha;
     Texture2D::PixelFormat pixelFormat;
+    // guarded by _requestMutex while the request is queued
+    int priority;
+    // set by the GL thread, checked by the loading thread before it reads and decodes the file
+    std::atomic<bool> cancelled;
     bool loadSuccess;
+    // the pixels converted to the texture format by the loading thread, unless the image is compressed or has mipmaps
+    unsigned char* uploadData;
+    ssize_t uploadDataLen;
+    Texture2D::PixelFormat uploadFormat;
+    // the texture being uploaded across frames, and its rows uploaded so far
+    Texture2D* texture;
+    int uploadedRows;
 };
 
+const char* TextureCache::EVENT_ASYNC_PROGRESS = "texture_cache_async_progress";
+
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - get the AsyncStruct with the highest priority from _requestQueue, load res and fill image data to AsyncStruct.image,
+   then add AsyncStruct to _responseQueue (one of the loading threads)
+ - convert the image data to the texture pixel format (the same loading thread)
+ - on schedule callback, move AsyncStruct from _responseQueue to _uploadQueue, upload the image to a texture within the
+   upload budget, big images in rows across frames, then call the callbacks and delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
+ - _requestQueue, and the priority of the queued AsyncStructs: locked by _requestMutex
  - _responseQueue: locked by _responseMutex
 
  the object's life time:
@@ -121,18 +165,23 @@ public:
  - image data: new in Load thread, delete in GL thread(by Image instance)
 
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct referenced in _asyncStructQueue, for unbind and cancel functions use.
+ - the loading threads finish in any order, so the responses don't follow the requests.
 
  How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
  - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
+ - If the image request is pending already, the callback is added to that request, which gets the higher priority,
+   so the file is decoded only once.
 
  Does process all response in addImageAsyncCallback consume more time?
  - Convert image to texture faster than load image from disk, so this isn't a problem.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    addImageAsync(path, callback, 0);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -144,6 +193,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        touchTexture(texture);
         if (callback) callback(texture);
         return;
     }
@@ -154,23 +204,43 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
+    // share the decode of a pending request for the same file
+    for (auto pending : _asyncStructQueue)
+    {
+        if (pending->filename == fullpath && !pending->cancelled)
+        {
+            pending->callbacks.push_back(callback);
+            std::unique_lock<std::mutex> ul(_requestMutex);
+            pending->priority = std::max(pending->priority, priority);
+            return;
+        }
+    }
+
     // lazy init
-    if (_loadingThread == nullptr)
+    if (_loadingThreads.empty())
     {
-        // create a new thread to load images
+        // create the threads to load images
         _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
+        for (int i = 0; i < _loadingThreadCount; ++i)
+        {
+            _loadingThreads.push_back(new (std::nothrow) std::thread(&TextureCache::loadImage, this));
+        }
     }
 
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this, 0, false);
+
+        // a new batch of requests, for the progress events
+        memset(&_asyncProgress, 0, sizeof(_asyncProgress));
+        _asyncProgressStartTime = std::chrono::steady_clock::now();
     }
 
     ++_asyncRefCount;
+    ++_asyncProgress.pendingCount;
 
     // generate async struct
-    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, callback);
+    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, callback, priority);
 
     // add async struct into queue
     _asyncStructQueue.push_back(data);
@@ -190,7 +260,7 @@ void TextureCache::unbindImageAsync(const std::string& filename)
     {
         if ((*it)->filename == fullpath)
         {
-            (*it)->callback = nullptr;
+            (*it)->callbacks.clear();
         }
     }
 }
@@ -204,38 +274,102 @@ void TextureCache::unbindAllImageAsync()
     }
     for (auto it = _asyncStructQueue.begin(); it != _asyncStructQueue.end(); ++it)
     {
-        (*it)->callback = nullptr;
+        (*it)->callbacks.clear();
+    }
+}
+
+void TextureCache::cancelImageAsync(const std::string& filename)
+{
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    for (auto asyncStruct : _asyncStructQueue)
+    {
+        if (asyncStruct->filename == fullpath)
+        {
+            asyncStruct->callbacks.clear();
+            asyncStruct->cancelled = true;
+        }
+    }
+}
+
+void TextureCache::cancelAllImageAsync()
+{
+    for (auto asyncStruct : _asyncStructQueue)
+    {
+        asyncStruct->callbacks.clear();
+        asyncStruct->cancelled = true;
     }
 }
 
+void TextureCache::setAsyncLoadingThreadCount(int count)
+{
+    CCASSERT(count > 0, "Invalid thread count");
+    if (!_loadingThreads.empty())
+    {
+        CCLOG("cocos2d: TextureCache: the loading threads are already running, their count can't be changed");
+        return;
+    }
+    _loadingThreadCount = count;
+}
+
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
-    while (!_needQuit)
+    while (true)
     {
         std::unique_lock<std::mutex> ul(_requestMutex);
-        // pop an AsyncStruct from request queue
-        if (_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
+        _sleepCondition.wait(ul, [this]() { return _needQuit || !_requestQueue.empty(); });
+        if (_needQuit)
         {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
+            break;
         }
 
-        if (nullptr == asyncStruct) {
-            if (_needQuit) {
-                break;
+        // pop the AsyncStruct with the highest priority, the oldest one among equals
+        auto best = _requestQueue.begin();
+        for (auto it = best + 1; it != _requestQueue.end(); ++it)
+        {
+            if ((*it)->priority > (*best)->priority)
+            {
+                best = it;
             }
-            _sleepCondition.wait(ul);
-            continue;
         }
+        asyncStruct = *best;
+        _requestQueue.erase(best);
         ul.unlock();
 
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image->initWithImageFile(asyncStruct->filename);
+        // load image, unless it was cancelled while queued or while the file was read
+        if (!asyncStruct->cancelled)
+        {
+            // PNG and JPEG files are decoded straight to the texture format, 9-patch images stay in RGBA8888 for their parser
+            Texture2D::PixelFormat decodeFormat = NinePatchImageParser::isNinePatchImage(asyncStruct->filename)
+                                                ? Texture2D::PixelFormat::NONE : asyncStruct->pixelFormat;
+            DecodedImageCache* decodedImageCache = DecodedImageCache::getInstance();
+            asyncStruct->loadSuccess = decodedImageCache->loadImage(asyncStruct->filename, decodeFormat, asyncStruct->image);
+            if (!asyncStruct->loadSuccess)
+            {
+                Data data = FileUtils::getInstance()->getDataFromFile(asyncStruct->filename);
+                if (!asyncStruct->cancelled && !data.isNull())
+                {
+                    asyncStruct->loadSuccess = asyncStruct->image->initWithImageData(data.getBytes(), data.getSize(), decodeFormat);
+                    if (asyncStruct->loadSuccess)
+                    {
+                        decodedImageCache->saveImage(asyncStruct->filename, decodeFormat, asyncStruct->image);
+                    }
+                }
+            }
+
+            // convert the pixels here, so that the GL thread only uploads them
+            Image* image = asyncStruct->image;
+            if (asyncStruct->loadSuccess && !image->isCompressed() && image->getNumberOfMipmaps() <= 1)
+            {
+                Texture2D::PixelFormat format = asyncStruct->pixelFormat;
+                if (format == Texture2D::PixelFormat::NONE || format == Texture2D::PixelFormat::AUTO)
+                {
+                    format = image->getRenderFormat();
+                }
+                asyncStruct->uploadFormat = Texture2D::convertDataToFormat(image->getData(), image->getDataLen(), image->getRenderFormat(),
+                                                                           format, &asyncStruct->uploadData, &asyncStruct->uploadDataLen);
+            }
+        }
 
         // push the asyncStruct to response queue
         _responseMutex.lock();
@@ -246,68 +380,87 @@ void TextureCache::loadImage()
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
-    Texture2D *texture = nullptr;
-    AsyncStruct *asyncStruct = nullptr;
-    while (true)
+    // the decoded images are uploaded in the order they were decoded
+    _responseMutex.lock();
+    _uploadQueue.insert(_uploadQueue.end(), _responseQueue.begin(), _responseQueue.end());
+    _responseQueue.clear();
+    _responseMutex.unlock();
+
+    size_t uploadedBytes = 0;
+    auto uploadStart = std::chrono::steady_clock::now();
+    bool hasProgress = false;
+    while (!_uploadQueue.empty())
     {
-        // pop an AsyncStruct from response queue
-        _responseMutex.lock();
-        if(_responseQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
+        AsyncStruct *asyncStruct = _uploadQueue.front();
+        if (!uploadAsyncImage(asyncStruct, &uploadedBytes, uploadStart))
         {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
-        }
-        _responseMutex.unlock();
-
-        if (nullptr == asyncStruct) {
+            // out of budget, go on next frame
             break;
         }
+        _uploadQueue.pop_front();
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
 
-        // check the image has been convert to texture or not
-        auto it = _textures.find(asyncStruct->filename);
-        if(it != _textures.end())
+        Texture2D *texture = nullptr;
+        if (asyncStruct->cancelled)
         {
-            texture = it->second;
+            // nothing to convert, the texture is not cached
+            _asyncProgress.cancelledCount++;
         }
         else
         {
-            // convert image to texture
-            if (asyncStruct->loadSuccess)
+            // check the image has been convert to texture or not
+            auto it = _textures.find(asyncStruct->filename);
+            if(it != _textures.end())
+            {
+                texture = it->second;
+                touchTexture(texture);
+            }
+            else if (asyncStruct->texture)
             {
                 Image* image = asyncStruct->image;
-                // generate texture in render thread
-                texture = new (std::nothrow) Texture2D();
+                texture = asyncStruct->texture;
+                asyncStruct->texture = nullptr;
 
-                texture->initWithImage(image, asyncStruct->pixelFormat);
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, asyncStruct->filename);
+                if (_dynamicAtlas)
+                {
+                    _dynamicAtlas->addTexture(texture, image);
+                }
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
                 VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
 #endif
-                // cache the texture. retain it, since it is added in the map
+                // cache the texture. the reference of the upload is the one of the map
                 _textures.insert( std::make_pair(asyncStruct->filename, texture) );
-                texture->retain();
 
+                texture->retain();
                 texture->autorelease();
-            } else {
-                texture = nullptr;
+                touchTexture(texture);
+                evictTextures(texture);
+            }
+
+            if (texture)
+            {
+                _asyncProgress.loadedCount++;
+                _asyncProgress.loadedBytes += asyncStruct->image->getDataLen();
+            }
+            else
+            {
+                _asyncProgress.failedCount++;
                 CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
             }
         }
+        _asyncProgress.pendingCount--;
+        hasProgress = true;
 
-        // call callback function
-        if (asyncStruct->callback)
+        // call callback functions, in the order of the addImageAsync() calls
+        for (const auto& callback : asyncStruct->callbacks)
         {
-            (asyncStruct->callback)(texture);
+            if (callback)
+            {
+                callback(texture);
+            }
         }
 
         // release the asyncStruct
@@ -315,12 +468,142 @@ void TextureCache::addImageAsyncCallBack(float dt)
         --_asyncRefCount;
     }
 
+    if (hasProgress)
+    {
+        _asyncProgress.seconds = std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - _asyncProgressStartTime).count();
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(EVENT_ASYNC_PROGRESS, &_asyncProgress);
+    }
+
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
     }
 }
 
+bool TextureCache::uploadAsyncImage(AsyncStruct* asyncStruct, size_t* uploadedBytes, const std::chrono::steady_clock::time_point& uploadStart)
+{
+    // nothing to upload when cancelled, failed, or loaded by addImage() meanwhile
+    if (asyncStruct->cancelled || !asyncStruct->loadSuccess || _textures.find(asyncStruct->filename) != _textures.end())
+    {
+        return true;
+    }
+
+    // something is uploaded every frame, however big
+    if (*uploadedBytes > 0)
+    {
+        if (_asyncUploadBytesPerFrame > 0 && *uploadedBytes >= _asyncUploadBytesPerFrame)
+        {
+            return false;
+        }
+        if (_asyncUploadMicrosecondsPerFrame > 0 &&
+            std::chrono::steady_clock::now() - uploadStart >= std::chrono::microseconds(_asyncUploadMicrosecondsPerFrame))
+        {
+            return false;
+        }
+    }
+
+    // a byte budget bounds the rows uploaded at once, a time budget is checked between rows of this many bytes
+    static const size_t TIME_BUDGET_CHUNK_BYTES = 256 * 1024;
+    size_t chunkBytes = (size_t)-1;
+    if (_asyncUploadBytesPerFrame > 0)
+    {
+        chunkBytes = _asyncUploadBytesPerFrame > *uploadedBytes ? _asyncUploadBytesPerFrame - *uploadedBytes : 0;
+    }
+    else if (_asyncUploadMicrosecondsPerFrame > 0)
+    {
+        chunkBytes = TIME_BUDGET_CHUNK_BYTES;
+    }
+
+    Image* image = asyncStruct->image;
+    if (asyncStruct->texture == nullptr)
+    {
+        Texture2D* texture = new (std::nothrow) Texture2D();
+        if (asyncStruct->uploadData == nullptr)
+        {
+            // compressed, or with mipmaps: in one go
+            if (!texture->initWithImage(image, asyncStruct->pixelFormat))
+            {
+                // no texture, the load is reported as failed
+                texture->release();
+                return true;
+            }
+            texture->_filePath = asyncStruct->filename;
+            *uploadedBytes += image->getDataLen();
+            asyncStruct->texture = texture;
+            return true;
+        }
+
+        int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+        if (image->getWidth() > maxTextureSize || image->getHeight() > maxTextureSize)
+        {
+            CCLOG("cocos2d: WARNING: Image (%u x %u) is bigger than the supported %u x %u", image->getWidth(), image->getHeight(), maxTextureSize, maxTextureSize);
+            texture->release();
+            return true;
+        }
+
+        bool initialized = false;
+        if ((size_t)asyncStruct->uploadDataLen <= chunkBytes)
+        {
+            initialized = texture->initWithData(asyncStruct->uploadData, asyncStruct->uploadDataLen, asyncStruct->uploadFormat,
+                                                image->getWidth(), image->getHeight(), Size((float)image->getWidth(), (float)image->getHeight()));
+            asyncStruct->uploadedRows = image->getHeight();
+        }
+        else
+        {
+            // allocate the texture now, and fill it in rows
+            MipmapInfo mipmap;
+            initialized = texture->initWithMipmaps(&mipmap, 1, asyncStruct->uploadFormat, image->getWidth(), image->getHeight());
+        }
+        if (!initialized)
+        {
+            // updateWithRows() would write into a texture that doesn't exist, the load is reported as failed
+            texture->release();
+            return true;
+        }
+        texture->_hasPremultipliedAlpha = image->hasPremultipliedAlpha();
+        // decoded from memory, the image doesn't know where it came from
+        texture->_filePath = asyncStruct->filename;
+        asyncStruct->texture = texture;
+
+        if (asyncStruct->uploadedRows == image->getHeight())
+        {
+            *uploadedBytes += asyncStruct->uploadDataLen;
+            return true;
+        }
+    }
+
+    const int height = image->getHeight();
+    const size_t bytesPerRow = asyncStruct->uploadDataLen / height;
+    while (asyncStruct->uploadedRows < height)
+    {
+        if (*uploadedBytes > 0 && chunkBytes == 0)
+        {
+            return false;
+        }
+        if (_asyncUploadMicrosecondsPerFrame > 0 && *uploadedBytes > 0 &&
+            std::chrono::steady_clock::now() - uploadStart >= std::chrono::microseconds(_asyncUploadMicrosecondsPerFrame))
+        {
+            return false;
+        }
+
+        int rows = std::min(height - asyncStruct->uploadedRows, (int)std::max((size_t)1, chunkBytes / bytesPerRow));
+        asyncStruct->texture->updateWithRows(asyncStruct->uploadData, asyncStruct->uploadedRows, rows);
+        asyncStruct->uploadedRows += rows;
+        *uploadedBytes += rows * bytesPerRow;
+        if (_asyncUploadBytesPerFrame > 0)
+        {
+            chunkBytes = _asyncUploadBytesPerFrame > *uploadedBytes ? _asyncUploadBytesPerFrame - *uploadedBytes : 0;
+        }
+    }
+    return true;
+}
+
+void TextureCache::setAsyncUploadBudget(size_t bytesPerFrame, int microsecondsPerFrame)
+{
+    _asyncUploadBytesPerFrame = bytesPerFrame;
+    _asyncUploadMicrosecondsPerFrame = microsecondsPerFrame;
+}
+
 Texture2D * TextureCache::addImage(const std::string &path)
 {
     Texture2D * texture = nullptr;
@@ -336,7 +619,10 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
+    {
         texture = it->second;
+        touchTexture(texture);
+    }
 
     if (! texture)
     {
@@ -346,7 +632,10 @@ Texture2D * TextureCache::addImage(const std::string &path)
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            // PNG and JPEG files are decoded straight to the texture format, 9-patch images stay in RGBA8888 for their parser
+            Texture2D::PixelFormat decodeFormat = NinePatchImageParser::isNinePatchImage(path)
+                                                ? Texture2D::PixelFormat::NONE : Texture2D::getDefaultAlphaPixelFormat();
+            bool bRet = image->initWithImageFile(fullpath, decodeFormat);
             CC_BREAK_IF(!bRet);
 
             texture = new (std::nothrow) Texture2D();
@@ -362,6 +651,12 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+                if (_dynamicAtlas)
+                {
+                    _dynamicAtlas->addTexture(texture, image);
+                }
+                touchTexture(texture);
+                evictTextures(texture);
             }
             else
             {
@@ -399,6 +694,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if( it != _textures.end() ) {
             texture = it->second;
+            touchTexture(texture);
             break;
         }
 
@@ -410,6 +706,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             texture->retain();
 
             texture->autorelease();
+            touchTexture(texture);
         }
         else
         {
@@ -427,6 +724,11 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
     }
 #endif
 
+    if (texture)
+    {
+        evictTextures(texture);
+    }
+
     return texture;
 }
 
@@ -444,6 +746,10 @@ bool TextureCache::reloadTexture(const std::string& fileName)
     auto it = _textures.find(fullpath);
     if (it != _textures.end()) {
         texture = it->second;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // loaded again below
+        _evictedTextures.erase(texture);
+#endif
     }
 
     bool ret = false;
@@ -461,6 +767,7 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             CC_BREAK_IF(!bRet);
 
             ret = texture->initWithImage(image);
+            touchTexture(texture);
         } while (0);
     }
 
@@ -486,6 +793,11 @@ void TextureCache::removeAllTextures()
         (it->second)->release();
     }
     _textures.clear();
+    _textureUses.clear();
+    _memoryUsage = 0;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    _evictedTextures.clear();
+#endif
 }
 
 void TextureCache::removeUnusedTextures()
@@ -495,6 +807,7 @@ void TextureCache::removeUnusedTextures()
         if( tex->getReferenceCount() == 1 ) {
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
+            forgetTexture(tex);
             tex->release();
             it = _textures.erase(it);
         }
@@ -514,6 +827,7 @@ void TextureCache::removeTexture(Texture2D* texture)
 
     for( auto it=_textures.cbegin(); it!=_textures.cend(); /* nothing */ ) {
         if( it->second == texture ) {
+            forgetTexture(texture);
             it->second->release();
             it = _textures.erase(it);
             break;
@@ -534,12 +848,13 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
     }
 
     if( it != _textures.end() ) {
+        forgetTexture(it->second);
         (it->second)->release();
         _textures.erase(it);
     }
 }
 
-Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) const
+Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName)
 {
     std::string key = textureKeyName;
     auto it = _textures.find(key);
@@ -553,7 +868,10 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if( it != _textures.end() )
+    {
+        touchTexture(it->second);
         return it->second;
+    }
     return nullptr;
 }
 
@@ -583,11 +901,16 @@ void TextureCache::waitForQuit()
     // notify sub thread to quick
     std::unique_lock<std::mutex> ul(_requestMutex);
     _needQuit = true;
-    _sleepCondition.notify_one();
+    _sleepCondition.notify_all();
     ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    for (auto thread : _loadingThreads)
+    {
+        thread->join();
+    }
 
-    // Clear async tasks which are still in the queue.
+    // Clear async tasks which are still in the queue, whatever the upload budget.
+    _asyncUploadBytesPerFrame = 0;
+    _asyncUploadMicrosecondsPerFrame = 0;
     addImageAsyncCallBack(0.0f);
 }
 
@@ -597,7 +920,7 @@ std::string TextureCache::getCachedTextureInfo() const
     char buftmp[4096];
 
     unsigned int count = 0;
-    unsigned int totalBytes = 0;
+    size_t totalBytes = 0;
 
     for( auto it = _textures.begin(); it != _textures.end(); ++it ) {
 
@@ -606,8 +929,8 @@ std::string TextureCache::getCachedTextureInfo() const
 
         Texture2D* tex = it->second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        // mipmaps and compression blocks included, 0 for evicted textures
+        auto bytes = tex->getGPUMemorySize();
         totalBytes += bytes;
         count++;
         snprintf(buftmp,sizeof(buftmp)-1,"\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
@@ -625,9 +948,138 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_memoryBudget > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp)-1, "Memory budget: %.2f MB, %.1f%% used\n",
+                 _memoryBudget / (1024.0f*1024.0f), totalBytes * 100.0f / _memoryBudget);
+        buffer += buftmp;
+    }
+
+    if (_dynamicAtlas)
+    {
+        const int pageSize = _dynamicAtlas->getPageSize();
+        const unsigned int pageBytes = pageSize * pageSize * 4;
+        snprintf(buftmp, sizeof(buftmp)-1, "Dynamic atlas: %d textures in %d pages of %d x %d, for %lu KB\n",
+                 _dynamicAtlas->getTextureCount(), _dynamicAtlas->getPageCount(), pageSize, pageSize,
+                 (long)pageBytes * _dynamicAtlas->getPageCount() / 1024);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
+void TextureCache::setDynamicAtlasEnabled(bool enabled, int pageSize, int maxTextureSize)
+{
+    // the packed textures keep their pages alive
+    CC_SAFE_DELETE(_dynamicAtlas);
+    if (enabled)
+    {
+        _dynamicAtlas = new (std::nothrow) DynamicAtlas(pageSize, maxTextureSize);
+    }
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    evictTextures(nullptr);
+}
+
+size_t TextureCache::getMemoryUsage() const
+{
+    return _memoryUsage;
+}
+
+void TextureCache::touchTexture(Texture2D* texture)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (!_evictedTextures.empty() && _evictedTextures.erase(texture) > 0)
+    {
+        VolatileTextureMgr::reloadTexture(texture);
+    }
+#endif
+
+    // new textures start at 0 bytes, and the size changes when a texture is initialized again
+    TextureUse& use = _textureUses[texture];
+    use.counter = ++_useCounter;
+    size_t bytes = texture->getGPUMemorySize();
+    _memoryUsage = _memoryUsage - use.bytes + bytes;
+    use.bytes = bytes;
+}
+
+void TextureCache::forgetTexture(Texture2D* texture)
+{
+    auto it = _textureUses.find(texture);
+    if (it != _textureUses.end())
+    {
+        _memoryUsage -= it->second.bytes;
+        _textureUses.erase(it);
+    }
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    _evictedTextures.erase(texture);
+#endif
+}
+
+void TextureCache::evictTextures(Texture2D* keep)
+{
+    if (_memoryBudget == 0)
+    {
+        return;
+    }
+
+    if (_memoryUsage <= _memoryBudget)
+    {
+        return;
+    }
+
+    // only the textures nobody else references can go, least recently used first
+    std::vector<std::pair<unsigned int, std::string>> candidates;
+    for (const auto& item : _textures)
+    {
+        Texture2D* tex = item.second;
+        if (tex != keep && tex->getReferenceCount() == 1 && tex->getName() != 0)
+        {
+            auto use = _textureUses.find(tex);
+            candidates.push_back(std::make_pair(use != _textureUses.end() ? use->second.counter : 0, item.first));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& candidate : candidates)
+    {
+        if (_memoryUsage <= _memoryBudget)
+        {
+            break;
+        }
+
+        auto it = _textures.find(candidate.second);
+        Texture2D* tex = it->second;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // keep the texture, VolatileTextureMgr knows how to recreate it
+        tex->releaseGLTexture();
+        _evictedTextures.insert(tex);
+        TextureUse& use = _textureUses[tex];
+        _memoryUsage -= use.bytes;
+        use.bytes = 0;
+#else
+        // textures that aren't from a file couldn't be loaded again
+        if (!FileUtils::getInstance()->isFileExist(candidate.second))
+        {
+            continue;
+        }
+        forgetTexture(tex);
+        tex->release();
+        _textures.erase(it);
+#endif
+        CCLOG("cocos2d: TextureCache: evicted texture: %s", candidate.second.c_str());
+    }
+
+    if (_memoryUsage > _memoryBudget)
+    {
+        CCLOG("cocos2d: TextureCache: %lu KB of textures in use, over the budget of %lu KB",
+              (unsigned long)_memoryUsage / 1024, (unsigned long)_memoryBudget / 1024);
+    }
+}
+
 void TextureCache::renameTextureWithKey(const std::string& srcName, const std::string& dstName)
 {
     std::string key = srcName;
@@ -651,6 +1103,7 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
                 tex->initWithImage(image);
                 _textures.insert(std::make_pair(fullpath, tex));
                 _textures.erase(it);
+                touchTexture(tex);
             }
             CC_SAFE_RELEASE(image);
         }
@@ -808,57 +1261,76 @@ void VolatileTextureMgr::reloadAllTextures()
 
     while (iter != _textures.end())
     {
-        VolatileTexture *vt = *iter++;
+        reloadTexture(*iter++);
+    }
 
-        switch (vt->_cashedImageType)
+    _isReloading = false;
+}
+
+void VolatileTextureMgr::reloadTexture(Texture2D *t)
+{
+    for (auto vt : _textures)
+    {
+        if (vt->_texture == t)
         {
-        case VolatileTexture::kImageFile:
-            {
-                Image* image = new (std::nothrow) Image();
+            bool wasReloading = _isReloading;
+            _isReloading = true;
+            t->releaseGLTexture();
+            reloadTexture(vt);
+            _isReloading = wasReloading;
+            break;
+        }
+    }
+}
 
-                Data data = FileUtils::getInstance()->getDataFromFile(vt->_fileName);
+void VolatileTextureMgr::reloadTexture(VolatileTexture *vt)
+{
+    switch (vt->_cashedImageType)
+    {
+    case VolatileTexture::kImageFile:
+        {
+            Image* image = new (std::nothrow) Image();
 
-                if (image && image->initWithImageData(data.getBytes(), data.getSize()))
-                {
-                    Texture2D::PixelFormat oldPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-                    Texture2D::setDefaultAlphaPixelFormat(vt->_pixelFormat);
-                    vt->_texture->initWithImage(image);
-                    Texture2D::setDefaultAlphaPixelFormat(oldPixelFormat);
-                }
+            Data data = FileUtils::getInstance()->getDataFromFile(vt->_fileName);
 
-                CC_SAFE_RELEASE(image);
-            }
-            break;
-        case VolatileTexture::kImageData:
-            {
-                vt->_texture->initWithData(vt->_textureData,
-                                           vt->_dataLen,
-                                          vt->_pixelFormat,
-                                          vt->_textureSize.width,
-                                          vt->_textureSize.height,
-                                          vt->_textureSize);
-            }
-            break;
-        case VolatileTexture::kString:
-            {
-                vt->_texture->initWithString(vt->_text, vt->_fontDefinition);
-            }
-            break;
-        case VolatileTexture::kImage:
+            if (image && image->initWithImageData(data.getBytes(), data.getSize()))
             {
-                vt->_texture->initWithImage(vt->_uiImage);
+                Texture2D::PixelFormat oldPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+                Texture2D::setDefaultAlphaPixelFormat(vt->_pixelFormat);
+                vt->_texture->initWithImage(image);
+                Texture2D::setDefaultAlphaPixelFormat(oldPixelFormat);
             }
-            break;
-        default:
-            break;
+
+            CC_SAFE_RELEASE(image);
         }
-        if (vt->_hasMipmaps) {
-            vt->_texture->generateMipmap();
+        break;
+    case VolatileTexture::kImageData:
+        {
+            vt->_texture->initWithData(vt->_textureData,
+                                       vt->_dataLen,
+                                      vt->_pixelFormat,
+                                      vt->_textureSize.width,
+                                      vt->_textureSize.height,
+                                      vt->_textureSize);
+        }
+        break;
+    case VolatileTexture::kString:
+        {
+            vt->_texture->initWithString(vt->_text, vt->_fontDefinition);
+        }
+        break;
+    case VolatileTexture::kImage:
+        {
+            vt->_texture->initWithImage(vt->_uiImage);
         }
-        vt->_texture->setTexParameters(vt->_texParams);
+        break;
+    default:
+        break;
     }
-
-    _isReloading = false;
+    if (vt->_hasMipmaps) {
+        vt->_texture->generateMipmap();
+    }
+    vt->_texture->setTexParameters(vt->_texParams);
 }
 
 #endif // CC_ENABLE_CACHE_TEXTURE_DATA
@@ -31,14 +31,18 @@ THE SOFTWARE.
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCDynamicAtlas.h"
 #include "platform/CCImage.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -78,6 +82,30 @@ public:
     CC_DEPRECATED_ATTRIBUTE static void reloadAllTextures();
 
 public:
+    /** The name of the EventCustom dispatched while addImageAsync() requests complete, its user data is an AsyncProgress*.
+     * It is dispatched at most once a frame, after the callbacks of the requests completed in that frame.
+     */
+    static const char* EVENT_ASYNC_PROGRESS;
+
+    /** The progress of the current batch of addImageAsync() requests.
+     * A batch starts with the first request made while none is pending, and ends when no request is pending.
+     */
+    struct AsyncProgress
+    {
+        /** The number of requests whose texture was created. */
+        int loadedCount;
+        /** The number of requests whose image could not be loaded. */
+        int failedCount;
+        /** The number of requests cancelled by cancelImageAsync() or cancelAllImageAsync(). */
+        int cancelledCount;
+        /** The number of requests still waiting for their image. */
+        int pendingCount;
+        /** The size of the decoded images, in bytes. */
+        ssize_t loadedBytes;
+        /** The time since the batch started, in seconds. */
+        float seconds;
+    };
+
     /**
      * @js ctor
      */
@@ -115,6 +143,16 @@ public:
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
 
+    /** Same as addImageAsync(filepath, callback), with a priority.
+    * Pending requests with a higher priority are decoded first, requests with the same priority in the order they were made.
+    * Requests for a file that is already pending share its decode, which gets the higher of both priorities.
+     @param filepath A null terminated string.
+     @param callback A callback function would be invoked after the image is loaded.
+     @param priority The priority of the request, 0 is the priority of addImageAsync(filepath, callback).
+     @js NA
+    */
+    virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, int priority);
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
@@ -128,6 +166,51 @@ public:
      */
     virtual void unbindAllImageAsync();
 
+    /** Cancels the pending asynchronous loads of an image.
+     * Unlike unbindImageAsync(), the image is not decoded if it hasn't been yet, and no texture is created or cached.
+     * The callbacks of the cancelled requests are not called.
+     * @param filename It's the related/absolute path of the file image.
+     * @js NA
+     */
+    virtual void cancelImageAsync(const std::string &filename);
+
+    /** Cancels all the pending asynchronous image loads.
+     * @js NA
+     */
+    virtual void cancelAllImageAsync();
+
+    /** Sets the number of threads decoding the images of addImageAsync().
+     * It has to be called before the first addImageAsync(), once the threads are started their number can't change.
+     * Default is the number of hardware threads minus one, between 1 and 4.
+     * @js NA
+     */
+    void setAsyncLoadingThreadCount(int count);
+
+    /** Returns the number of threads decoding the images of addImageAsync().
+     * @js NA
+     */
+    int getAsyncLoadingThreadCount() const { return _loadingThreadCount; }
+
+    /** Limits the texture uploads of addImageAsync() per frame, so that many images completing together don't stall a frame.
+     * Images bigger than what's left of the budget are uploaded in rows across frames, their callbacks are called once
+     * they are complete. At least one image or group of rows is uploaded every frame.
+     * Compressed images and images with mipmaps are always uploaded at once.
+     * @param bytesPerFrame The number of bytes uploaded per frame, 0 for no limit, the default.
+     * @param microsecondsPerFrame The time spent uploading per frame, 0 for no limit, the default.
+     * @js NA
+     */
+    void setAsyncUploadBudget(size_t bytesPerFrame, int microsecondsPerFrame = 0);
+
+    /** Returns the bytes uploaded per frame by addImageAsync(), 0 for no limit.
+     * @js NA
+     */
+    size_t getAsyncUploadBytesPerFrame() const { return _asyncUploadBytesPerFrame; }
+
+    /** Returns the time spent uploading per frame by addImageAsync(), in microseconds, 0 for no limit.
+     * @js NA
+     */
+    int getAsyncUploadMicrosecondsPerFrame() const { return _asyncUploadMicrosecondsPerFrame; }
+
     /** Returns a Texture2D object given an Image.
     * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image.
@@ -140,7 +223,7 @@ public:
     @param key It's the related/absolute path of the file image.
     @since v0.99.5
     */
-    Texture2D* getTextureForKey(const std::string& key) const;
+    Texture2D* getTextureForKey(const std::string& key);
 
     /** Reload texture from the image file.
     * If the file image hasn't loaded before, load it.
@@ -212,20 +295,69 @@ public:
     */
     void renameTextureWithKey(const std::string& srcName, const std::string& dstName);
 
+    /** Enable/Disable the dynamic atlas.
+    * When enabled, small images loaded by addImage() and addImageAsync() are also packed into shared atlas pages,
+    * and SpriteFrames created with their textures draw from the pages, so they batch together. See DynamicAtlas.
+    * Disabling it doesn't affect textures packed before.
+    * Disabled by default.
+    *
+    * @param enabled Whether to pack the textures loaded from now on.
+    * @param pageSize Width and height of the pages, in pixels.
+    * @param maxTextureSize Images wider or higher than this, in pixels, are not packed.
+    */
+    void setDynamicAtlasEnabled(bool enabled, int pageSize = 1024, int maxTextureSize = 256);
+
+    /** Whether or not the dynamic atlas is enabled. */
+    bool isDynamicAtlasEnabled() const { return _dynamicAtlas != nullptr; }
+
+    /** Returns the dynamic atlas, or nullptr when it is disabled. */
+    DynamicAtlas* getDynamicAtlas() const { return _dynamicAtlas; }
+
+    /** Sets the GPU memory budget of the cached textures, in bytes. 0 means no budget, the default.
+    * When the cached textures use more, the least recently used ones whose only reference is the cache are evicted,
+    * until the usage fits. See getMemoryUsage().
+    * With CC_ENABLE_CACHE_TEXTURE_DATA, an evicted texture only releases its GL texture and stays cached,
+    * it is reloaded like after a context loss the next time it is looked up.
+    * Otherwise it is removed from the cache if it was loaded from a file, which addImage() loads again.
+    * @js NA
+    */
+    void setMemoryBudget(size_t bytes);
+
+    /** Returns the GPU memory budget of the cached textures, in bytes.
+    * @js NA
+    */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Returns the estimated GPU memory used by the cached textures, in bytes. See Texture2D::getGPUMemorySize().
+    * @js NA
+    */
+    size_t getMemoryUsage() const;
+
 
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    // marks a cached texture as the most recently used one, reloads it if it was evicted and updates its memory usage
+    void touchTexture(Texture2D* texture);
+    // evicts the least recently used textures until the memory usage fits the budget, except keep
+    void evictTextures(Texture2D* keep);
+    void forgetTexture(Texture2D* texture);
 public:
 protected:
     struct AsyncStruct;
 
-    std::thread* _loadingThread;
+    // uploads the image of a request within the frame budget, returns false when it isn't complete yet
+    bool uploadAsyncImage(AsyncStruct* asyncStruct, size_t* uploadedBytes, const std::chrono::steady_clock::time_point& uploadStart);
+
+    std::vector<std::thread*> _loadingThreads;
+    int _loadingThreadCount;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
     std::deque<AsyncStruct*> _responseQueue;
+    // decoded, waiting for their upload, GL thread only
+    std::deque<AsyncStruct*> _uploadQueue;
 
     std::mutex _requestMutex;
     std::mutex _responseMutex;
@@ -236,7 +368,31 @@ protected:
 
     int _asyncRefCount;
 
+    size_t _asyncUploadBytesPerFrame;
+    int _asyncUploadMicrosecondsPerFrame;
+
+    AsyncProgress _asyncProgress;
+    std::chrono::steady_clock::time_point _asyncProgressStartTime;
+
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    DynamicAtlas* _dynamicAtlas;
+
+    size_t _memoryBudget;
+    // sum of the bytes of _textureUses
+    size_t _memoryUsage;
+    struct TextureUse
+    {
+        // use counter value of the last lookup, for the LRU eviction
+        unsigned int counter;
+        // GPU memory size at the last lookup
+        size_t bytes;
+    };
+    unsigned int _useCounter;
+    std::unordered_map<Texture2D*, TextureUse> _textureUses;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    std::unordered_set<Texture2D*> _evictedTextures;
+#endif
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -292,10 +448,13 @@ public:
     static void setTexParameters(Texture2D *t, const Texture2D::TexParams &texParams);
     static void removeTexture(Texture2D *t);
     static void reloadAllTextures();
+    /** Recreates the GL texture of a single texture, from what was recorded for it. */
+    static void reloadTexture(Texture2D *t);
 public:
     static std::list<VolatileTexture*> _textures;
     static bool _isReloading;
 private:
+    static void reloadTexture(VolatileTexture *vt);
     // find VolatileTexture by Texture2D*
     // if not found, create a new one
     static VolatileTexture* findVolotileTexture(Texture2D *tt);
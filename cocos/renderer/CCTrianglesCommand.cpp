@@ -39,8 +39,21 @@ TrianglesCommand::TrianglesCommand()
 ,_glProgram(nullptr)
 ,_blendType(BlendFunc::DISABLE)
 ,_alphaTextureID(0)
+,_texture(nullptr)
+,_uniformValues(nullptr)
+,_uniformValueCount(0)
+,_isStatic(false)
+,_isQuads(false)
+,_hasWorldBounds(false)
+,_localBoundsVersion(0)
+,_hasLocalBounds(false)
+,_isGeometryTracked(false)
+,_geometryVersion(0)
+,_transformVersion(0)
 {
     _type = RenderCommand::Type::TRIANGLES_COMMAND;
+    memset(&_triangles, 0, sizeof(_triangles));
+    memset(&_staticGeometry, 0, sizeof(_staticGeometry));
 }
 
 void TrianglesCommand::init(float globalOrder, GLuint textureID, GLProgramState* glProgramState, const BlendFunc& blendType, const Triangles& triangles,const Mat4& mv, uint32_t flags)
@@ -50,6 +63,7 @@ void TrianglesCommand::init(float globalOrder, GLuint textureID, GLProgramState*
 
     RenderCommand::init(globalOrder, mv, flags);
 
+    const Triangles previous = _triangles;
     _triangles = triangles;
     if(_triangles.indexCount % 3 != 0)
     {
@@ -57,7 +71,24 @@ void TrianglesCommand::init(float globalOrder, GLuint textureID, GLProgramState*
         _triangles.indexCount = count / 3 * 3;
         CCLOGERROR("Resize indexCount from %zd to %zd, size must be multiple times of 3", count, _triangles.indexCount);
     }
+    if (_triangles.verts != previous.verts || _triangles.indices != previous.indices ||
+        _triangles.vertCount != previous.vertCount || _triangles.indexCount != previous.indexCount)
+    {
+        ++_geometryVersion;
+    }
+    if (memcmp(_mv.m, mv.m, sizeof(_mv.m)) != 0)
+    {
+        ++_transformVersion;
+    }
     _mv = mv;
+    _hasWorldBounds = false;
+    _texture = nullptr;
+
+    // a single quad indexed like a QuadCommand, e.g. the quad of a Sprite, can be drawn instanced too
+    const unsigned short* indices = _triangles.indices;
+    _isQuads = _triangles.vertCount == 4 && _triangles.indexCount == 6 && indices != nullptr
+        && indices[0] == 0 && indices[1] == 1 && indices[2] == 2
+        && indices[3] == 3 && indices[4] == 2 && indices[5] == 1;
     
     if( _textureID != textureID || _blendType.src != blendType.src || _blendType.dst != blendType.dst ||
        _glProgramState != glProgramState ||
@@ -76,12 +107,74 @@ void TrianglesCommand::init(float globalOrder, Texture2D* texture, GLProgramStat
 {
     init(globalOrder, texture->getName(), glProgramState, blendType, triangles, mv, flags);
     _alphaTextureID = texture->getAlphaTextureName();
+    _texture = texture;
 }
 
 TrianglesCommand::~TrianglesCommand()
 {
 }
 
+void TrianglesCommand::setWorldBounds(const Vec3& min, const Vec3& max)
+{
+    _worldBoundsMin = min;
+    _worldBoundsMax = max;
+    _hasWorldBounds = true;
+}
+
+void TrianglesCommand::getWorldBounds(Vec3* min, Vec3* max)
+{
+    if (!_hasWorldBounds)
+    {
+        // the vertices are only gone over again when the owner may have moved them
+        const bool isTracked = _isGeometryTracked || _isStatic;
+        if (!isTracked || !_hasLocalBounds || _localBoundsVersion != _geometryVersion)
+        {
+            _localBoundsMin.setZero();
+            _localBoundsMax.setZero();
+            if (_triangles.vertCount > 0)
+            {
+                _localBoundsMin = _localBoundsMax = _triangles.verts[0].vertices;
+            }
+            for (int i = 1; i < _triangles.vertCount; ++i)
+            {
+                const Vec3& p = _triangles.verts[i].vertices;
+                _localBoundsMin.x = std::min(_localBoundsMin.x, p.x);
+                _localBoundsMin.y = std::min(_localBoundsMin.y, p.y);
+                _localBoundsMin.z = std::min(_localBoundsMin.z, p.z);
+                _localBoundsMax.x = std::max(_localBoundsMax.x, p.x);
+                _localBoundsMax.y = std::max(_localBoundsMax.y, p.y);
+                _localBoundsMax.z = std::max(_localBoundsMax.z, p.z);
+            }
+            _localBoundsVersion = _geometryVersion;
+            _hasLocalBounds = true;
+        }
+
+        // transform the corners of the local bounding box instead of every vertex
+        for (int c = 0; c < 8; ++c)
+        {
+            Vec3 corner((c & 1) ? _localBoundsMax.x : _localBoundsMin.x, (c & 2) ? _localBoundsMax.y : _localBoundsMin.y, (c & 4) ? _localBoundsMax.z : _localBoundsMin.z);
+            _mv.transformPoint(&corner);
+            if (c == 0)
+            {
+                _worldBoundsMin = _worldBoundsMax = corner;
+            }
+            else
+            {
+                _worldBoundsMin.x = std::min(_worldBoundsMin.x, corner.x);
+                _worldBoundsMin.y = std::min(_worldBoundsMin.y, corner.y);
+                _worldBoundsMin.z = std::min(_worldBoundsMin.z, corner.z);
+                _worldBoundsMax.x = std::max(_worldBoundsMax.x, corner.x);
+                _worldBoundsMax.y = std::max(_worldBoundsMax.y, corner.y);
+                _worldBoundsMax.z = std::max(_worldBoundsMax.z, corner.z);
+            }
+        }
+        _hasWorldBounds = true;
+    }
+
+    *min = _worldBoundsMin;
+    *max = _worldBoundsMax;
+}
+
 void TrianglesCommand::generateMaterialID()
 {
     // do not batch if using custom uniforms (since we cannot batch) it
@@ -106,7 +199,14 @@ void TrianglesCommand::useMaterial() const
     //set blend mode
     GL::blendFunc(_blendType.src, _blendType.dst);
 
-    _glProgramState->apply(_mv);
+    if (_uniformValues)
+    {
+        _glProgramState->apply(_mv, _uniformValues, _uniformValueCount);
+    }
+    else
+    {
+        _glProgramState->apply(_mv);
+    }
 }
 
 NS_CC_END
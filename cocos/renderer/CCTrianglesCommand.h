@@ -93,8 +93,39 @@ public:
     inline BlendFunc getBlendType() const { return _blendType; }
     /**Get the model view matrix.*/
     inline const Mat4& getModelView() const { return _mv; }
+    /**
+     Set whether the geometry rarely changes. The Renderer keeps the world space vertices of a static command in a
+     retained buffer, and only transforms and uploads them again when the model view matrix changes or the geometry
+     is marked dirty, see setGeometryDirty().
+     */
+    inline void setStatic(bool isStatic) { _isStatic = isStatic; }
+    /**Whether the geometry is static.*/
+    inline bool isStatic() const { return _isStatic; }
+    /**
+     Mark the vertices or indices as changed. init() notices another model view matrix, triangles pointer or count,
+     but not new content at the same address: the owner of a static command calls this when it rewrites its vertices.
+     */
+    inline void setGeometryDirty() { ++_geometryVersion; }
+    /**
+     Set whether the owner calls setGeometryDirty() whenever it moves vertices in place. getWorldBounds() then keeps the
+     bounds of the vertices until the geometry changes, instead of going over every vertex each frame.
+     Static commands are always tracked.
+     */
+    inline void setGeometryTracked(bool tracked) { _isGeometryTracked = tracked; }
+    /**Whether the owner reports the changes of the vertices.*/
+    inline bool isGeometryTracked() const { return _isGeometryTracked; }
+    /**
+     Set the axis aligned bounding box of the vertices transformed by the model view matrix, the world coordinates
+     the Renderer batches them in. Used by the Renderer to cull the command. Reset by init().
+     */
+    void setWorldBounds(const Vec3& min, const Vec3& max);
+    /**Get the world bounding box, computed from the vertices and the model view matrix when it was not set.*/
+    void getWorldBounds(Vec3* min, Vec3* max);
 
 protected:
+    friend class Renderer;
+    friend class RenderCapture;
+
     /**Generate the material ID by textureID, glProgramState, and blend function.*/
     void generateMaterialID();
 
@@ -114,6 +145,43 @@ protected:
     Mat4 _mv;
 
     GLuint _alphaTextureID; // ANDROID ETC1 ALPHA supports.
+    /**The texture given to init(), nullptr when only its name was. Not retained.*/
+    Texture2D* _texture;
+    /**Uniform values applied instead of the ones of _glProgramState, set on the copies of a threaded frame.*/
+    UniformValue* _uniformValues;
+    ssize_t _uniformValueCount;
+
+    /**Whether the geometry is static.*/
+    bool _isStatic;
+    /**Whether the triangles are quads indexed as in a QuadCommand, which the Renderer may draw instanced.
+     Set by QuadCommand, and by init() for a single quad with the same indices, like the one of a Sprite.*/
+    bool _isQuads;
+    /**World bounding box, valid when _hasWorldBounds is true.*/
+    Vec3 _worldBoundsMin;
+    Vec3 _worldBoundsMax;
+    bool _hasWorldBounds;
+    /**Bounding box of the vertices before the model view transform, computed for _localBoundsVersion of the geometry.*/
+    Vec3 _localBoundsMin;
+    Vec3 _localBoundsMax;
+    unsigned int _localBoundsVersion;
+    bool _hasLocalBounds;
+    /**Whether the owner reports the changes of the vertices, see setGeometryTracked().*/
+    bool _isGeometryTracked;
+    /**Incremented when the vertices or indices change, see setGeometryDirty().*/
+    unsigned int _geometryVersion;
+    /**Incremented by init() when the model view matrix changes.*/
+    unsigned int _transformVersion;
+    /**Where the Renderer retains the geometry of a static command.*/
+    struct StaticGeometry
+    {
+        unsigned int generation;        // retained buffer generation, 0 means not retained
+        unsigned int geometryVersion;   // _geometryVersion and _transformVersion when uploaded
+        unsigned int transformVersion;
+        int vertexOffset;               // the region, reused when the geometry changes and still fits
+        int indexOffset;
+        int vertexCount;
+        int indexCount;
+    } _staticGeometry;
 };
 
 NS_CC_END
@@ -261,6 +261,26 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+void vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+    glVertexAttribDivisorEXT(index, divisor);
+#else
+    glVertexAttribDivisorARB(index, divisor);
+#endif
+}
+
+// GL Draw functions
+
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+    glDrawArraysInstancedEXT(mode, first, count, instanceCount);
+#else
+    glDrawArraysInstancedARB(mode, first, count, instanceCount);
+#endif
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
@@ -175,6 +175,20 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/**
+ * Sets how many instances are drawn before a vertex attribute advances, 0 to advance it for every vertex.
+ * Calls glVertexAttribDivisorEXT() on OpenGL ES and glVertexAttribDivisorARB() on desktop OpenGL.
+ * Only available when Configuration::supportsInstancedArrays() returns true.
+ */
+void CC_DLL vertexAttribDivisor(GLuint index, GLuint divisor);
+
+/**
+ * Draws instanceCount instances of a range of vertices.
+ * Calls glDrawArraysInstancedEXT() on OpenGL ES and glDrawArraysInstancedARB() on desktop OpenGL.
+ * Only available when Configuration::supportsInstancedArrays() returns true.
+ */
+void CC_DLL drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+
 // end of support group
 /// @}
 
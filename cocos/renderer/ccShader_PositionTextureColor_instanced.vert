@@ -0,0 +1,52 @@
+/*
+ * cocos2d for iPhone: http://www.cocos2d-iphone.org
+ *
+ * Copyright (c) 2011 Ricardo Quesada
+ * Copyright (c) 2012 Zynga Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// One instance per quad: a_position is the corner of the unit quad, the other attributes
+// are per instance and map it to the world space parallelogram and texture coordinates of the quad.
+const char* ccPositionTextureColor_instanced_vert = STRINGIFY(
+attribute vec2 a_position;
+attribute vec4 a_color;
+attribute vec3 a_instanceOrigin;
+attribute vec3 a_instanceAxisX;
+attribute vec3 a_instanceAxisY;
+attribute vec2 a_instanceTexCoord;
+attribute vec4 a_instanceTexAxes;
+
+\n#ifdef GL_ES\n
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec3 position = a_instanceOrigin + a_position.x * a_instanceAxisX + a_position.y * a_instanceAxisY;
+    gl_Position = CC_PMatrix * vec4(position, 1.0);
+    v_fragmentColor = a_color;
+    v_texCoord = a_instanceTexCoord + a_position.x * a_instanceTexAxes.xy + a_position.y * a_instanceTexAxes.zw;
+}
+);
@@ -57,6 +57,7 @@ NS_CC_BEGIN
 //
 #include "renderer/ccShader_PositionTextureColor_noMVP.frag"
 #include "renderer/ccShader_PositionTextureColor_noMVP.vert"
+#include "renderer/ccShader_PositionTextureColor_instanced.vert"
 
 //
 #include "renderer/ccShader_PositionTextureColorAlphaTest.frag"
@@ -1455,6 +1455,14 @@ scheduler
 {
 },
 
+/**
+ * @method resetForReuse
+ */
+resetForReuse : function (
+)
+{
+},
+
 /**
  * @method stopAllActions
  */
@@ -3998,6 +4006,143 @@ getInstance : function (
 
 };
 
+/**
+ * @class NodePool
+ */
+cc.NodePool = {
+
+/**
+ * @method getFreeCount
+ * @param {String} arg0
+ * @return {long}
+ */
+getFreeCount : function (
+str 
+)
+{
+    return 0;
+},
+
+/**
+ * @method clearAll
+ */
+clearAll : function (
+)
+{
+},
+
+/**
+ * @method prewarm
+ * @param {String} arg0
+ * @param {long} arg1
+ */
+prewarm : function (
+str, 
+long 
+)
+{
+},
+
+/**
+ * @method getDescription
+ * @return {String}
+ */
+getDescription : function (
+)
+{
+    return "";
+},
+
+/**
+ * @method setCapacity
+ * @param {String} arg0
+ * @param {long} arg1
+ */
+setCapacity : function (
+str, 
+long 
+)
+{
+},
+
+/**
+ * @method recycle
+ * @param {String} arg0
+ * @param {cc.Node} arg1
+ */
+recycle : function (
+str, 
+node 
+)
+{
+},
+
+/**
+ * @method isTypeRegistered
+ * @param {String} arg0
+ * @return {bool}
+ */
+isTypeRegistered : function (
+str 
+)
+{
+    return false;
+},
+
+/**
+ * @method acquire
+ * @param {String} arg0
+ * @return {cc.Node}
+ */
+acquire : function (
+str 
+)
+{
+    return cc.Node;
+},
+
+/**
+ * @method clear
+ * @param {String} arg0
+ */
+clear : function (
+str 
+)
+{
+},
+
+/**
+ * @method getCapacity
+ * @param {String} arg0
+ * @return {long}
+ */
+getCapacity : function (
+str 
+)
+{
+    return 0;
+},
+
+/**
+ * @method destroyInstance
+ */
+destroyInstance : function (
+)
+{
+},
+
+/**
+ * @method getInstance
+ * @return {cc.NodePool}
+ */
+getInstance : function (
+)
+{
+    return cc.NodePool;
+},
+
+};
+
 /**
  * @class EventAcceleration
  */
@@ -4602,6 +4747,26 @@ bool
 {
 },
 
+/**
+ * @method setFilterByNodeBounds
+ * @param {bool} arg0
+ */
+setFilterByNodeBounds : function (
+bool 
+)
+{
+},
+
+/**
+ * @method isFilterByNodeBounds
+ * @return {bool}
+ */
+isFilterByNodeBounds : function (
+)
+{
+    return false;
+},
+
 /**
  * @method init
  * @return {bool}
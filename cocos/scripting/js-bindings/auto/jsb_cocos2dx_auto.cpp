@@ -3261,6 +3261,21 @@ static bool js_cocos2dx_Node_setScheduler(se::State& s)
 }
 SE_BIND_FUNC(js_cocos2dx_Node_setScheduler)
 
+static bool js_cocos2dx_Node_resetForReuse(se::State& s)
+{
+    cocos2d::Node* cobj = (cocos2d::Node*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_Node_resetForReuse : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->resetForReuse();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_Node_resetForReuse)
+
 static bool js_cocos2dx_Node_stopAllActions(se::State& s)
 {
     cocos2d::Node* cobj = (cocos2d::Node*)s.nativeThisObject();
@@ -4609,6 +4624,7 @@ bool js_register_cocos2dx_Node(se::Object* obj)
     cls->defineFunction("setVertexZ", _SE(js_cocos2dx_Node_setPositionZ));
     cls->defineFunction("getGLProgramState", _SE(js_cocos2dx_Node_getGLProgramState));
     cls->defineFunction("setScheduler", _SE(js_cocos2dx_Node_setScheduler));
+    cls->defineFunction("resetForReuse", _SE(js_cocos2dx_Node_resetForReuse));
     cls->defineFunction("stopAllActions", _SE(js_cocos2dx_Node_stopAllActions));
     cls->defineFunction("getSkewX", _SE(js_cocos2dx_Node_getSkewX));
     cls->defineFunction("getSkewY", _SE(js_cocos2dx_Node_getSkewY));
@@ -8471,6 +8487,268 @@ bool js_register_cocos2dx_FileUtils(se::Object* obj)
     return true;
 }
 
+se::Object* __jsb_cocos2d_NodePool_proto = nullptr;
+se::Class* __jsb_cocos2d_NodePool_class = nullptr;
+
+static bool js_cocos2dx_NodePool_getFreeCount(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_getFreeCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_getFreeCount : Error processing arguments");
+        ssize_t result = cobj->getFreeCount(arg0);
+        ok &= ssize_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_getFreeCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_getFreeCount)
+
+static bool js_cocos2dx_NodePool_clearAll(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_clearAll : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->clearAll();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_clearAll)
+
+static bool js_cocos2dx_NodePool_prewarm(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_prewarm : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        ssize_t arg1 = 0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        ok &= seval_to_ssize(args[1], &arg1);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_prewarm : Error processing arguments");
+        cobj->prewarm(arg0, arg1);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_prewarm)
+
+static bool js_cocos2dx_NodePool_getDescription(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_getDescription : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        std::string result = cobj->getDescription();
+        ok &= std_string_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_getDescription : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_getDescription)
+
+static bool js_cocos2dx_NodePool_setCapacity(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_setCapacity : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        ssize_t arg1 = 0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        ok &= seval_to_ssize(args[1], &arg1);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_setCapacity : Error processing arguments");
+        cobj->setCapacity(arg0, arg1);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_setCapacity)
+
+static bool js_cocos2dx_NodePool_recycle(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_recycle : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        cocos2d::Node* arg1 = nullptr;
+        ok &= seval_to_std_string(args[0], &arg0);
+        ok &= seval_to_native_ptr(args[1], &arg1);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_recycle : Error processing arguments");
+        bool result = cobj->recycle(arg0, arg1);
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_recycle : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_recycle)
+
+static bool js_cocos2dx_NodePool_isTypeRegistered(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_isTypeRegistered : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_isTypeRegistered : Error processing arguments");
+        bool result = cobj->isTypeRegistered(arg0);
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_isTypeRegistered : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_isTypeRegistered)
+
+static bool js_cocos2dx_NodePool_acquire(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_acquire : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_acquire : Error processing arguments");
+        cocos2d::Node* result = cobj->acquire(arg0);
+        ok &= native_ptr_to_seval<cocos2d::Node>((cocos2d::Node*)result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_acquire : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_acquire)
+
+static bool js_cocos2dx_NodePool_clear(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_clear : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_clear : Error processing arguments");
+        cobj->clear(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_clear)
+
+static bool js_cocos2dx_NodePool_getCapacity(se::State& s)
+{
+    cocos2d::NodePool* cobj = (cocos2d::NodePool*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_NodePool_getCapacity : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_getCapacity : Error processing arguments");
+        ssize_t result = cobj->getCapacity(arg0);
+        ok &= ssize_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_getCapacity : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_getCapacity)
+
+static bool js_cocos2dx_NodePool_destroyInstance(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cocos2d::NodePool::destroyInstance();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_destroyInstance)
+
+static bool js_cocos2dx_NodePool_getInstance(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        cocos2d::NodePool* result = cocos2d::NodePool::getInstance();
+        ok &= native_ptr_to_seval<cocos2d::NodePool>((cocos2d::NodePool*)result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_NodePool_getInstance : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_NodePool_getInstance)
+
+
+
+
+bool js_register_cocos2dx_NodePool(se::Object* obj)
+{
+    auto cls = se::Class::create("NodePool", obj, nullptr, nullptr);
+
+    cls->defineFunction("getFreeCount", _SE(js_cocos2dx_NodePool_getFreeCount));
+    cls->defineFunction("clearAll", _SE(js_cocos2dx_NodePool_clearAll));
+    cls->defineFunction("prewarm", _SE(js_cocos2dx_NodePool_prewarm));
+    cls->defineFunction("getDescription", _SE(js_cocos2dx_NodePool_getDescription));
+    cls->defineFunction("setCapacity", _SE(js_cocos2dx_NodePool_setCapacity));
+    cls->defineFunction("recycle", _SE(js_cocos2dx_NodePool_recycle));
+    cls->defineFunction("isTypeRegistered", _SE(js_cocos2dx_NodePool_isTypeRegistered));
+    cls->defineFunction("acquire", _SE(js_cocos2dx_NodePool_acquire));
+    cls->defineFunction("clear", _SE(js_cocos2dx_NodePool_clear));
+    cls->defineFunction("getCapacity", _SE(js_cocos2dx_NodePool_getCapacity));
+    cls->defineStaticFunction("destroyInstance", _SE(js_cocos2dx_NodePool_destroyInstance));
+    cls->defineStaticFunction("getInstance", _SE(js_cocos2dx_NodePool_getInstance));
+    cls->install();
+    JSBClassType::registerClass<cocos2d::NodePool>(cls);
+
+    __jsb_cocos2d_NodePool_proto = cls->getProto();
+    __jsb_cocos2d_NodePool_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
 se::Object* __jsb_cocos2d_EventAcceleration_proto = nullptr;
 se::Class* __jsb_cocos2d_EventAcceleration_class = nullptr;
 
@@ -9848,6 +10126,43 @@ static bool js_cocos2dx_EventListenerTouchOneByOne_setSwallowTouches(se::State&
 }
 SE_BIND_FUNC(js_cocos2dx_EventListenerTouchOneByOne_setSwallowTouches)
 
+static bool js_cocos2dx_EventListenerTouchOneByOne_setFilterByNodeBounds(se::State& s)
+{
+    cocos2d::EventListenerTouchOneByOne* cobj = (cocos2d::EventListenerTouchOneByOne*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_EventListenerTouchOneByOne_setFilterByNodeBounds : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        bool arg0;
+        ok &= seval_to_boolean(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_EventListenerTouchOneByOne_setFilterByNodeBounds : Error processing arguments");
+        cobj->setFilterByNodeBounds(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_EventListenerTouchOneByOne_setFilterByNodeBounds)
+
+static bool js_cocos2dx_EventListenerTouchOneByOne_isFilterByNodeBounds(se::State& s)
+{
+    cocos2d::EventListenerTouchOneByOne* cobj = (cocos2d::EventListenerTouchOneByOne*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_EventListenerTouchOneByOne_isFilterByNodeBounds : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isFilterByNodeBounds();
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_EventListenerTouchOneByOne_isFilterByNodeBounds : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_EventListenerTouchOneByOne_isFilterByNodeBounds)
+
 static bool js_cocos2dx_EventListenerTouchOneByOne_init(se::State& s)
 {
     cocos2d::EventListenerTouchOneByOne* cobj = (cocos2d::EventListenerTouchOneByOne*)s.nativeThisObject();
@@ -9898,6 +10213,8 @@ bool js_register_cocos2dx_EventListenerTouchOneByOne(se::Object* obj)
 
     cls->defineFunction("isSwallowTouches", _SE(js_cocos2dx_EventListenerTouchOneByOne_isSwallowTouches));
     cls->defineFunction("setSwallowTouches", _SE(js_cocos2dx_EventListenerTouchOneByOne_setSwallowTouches));
+    cls->defineFunction("setFilterByNodeBounds", _SE(js_cocos2dx_EventListenerTouchOneByOne_setFilterByNodeBounds));
+    cls->defineFunction("isFilterByNodeBounds", _SE(js_cocos2dx_EventListenerTouchOneByOne_isFilterByNodeBounds));
     cls->defineFunction("init", _SE(js_cocos2dx_EventListenerTouchOneByOne_init));
     cls->defineFinalizeFunction(_SE(js_cocos2d_EventListenerTouchOneByOne_finalize));
     cls->install();
@@ -38294,6 +38611,7 @@ bool register_all_cocos2dx(se::Object* obj)
     js_register_cocos2dx_MotionStreak(ns);
     js_register_cocos2dx_RotateBy(ns);
     js_register_cocos2dx_FileUtils(ns);
+    js_register_cocos2dx_NodePool(ns);
     js_register_cocos2dx_CallFuncN(ns);
     js_register_cocos2dx_BaseJSAction(ns);
     js_register_cocos2dx_Sequence(ns);
@@ -185,6 +185,7 @@ SE_DECLARE_FUNC(js_cocos2dx_Node_removeChildByName);
 SE_DECLARE_FUNC(js_cocos2dx_Node_setPositionZ);
 SE_DECLARE_FUNC(js_cocos2dx_Node_getGLProgramState);
 SE_DECLARE_FUNC(js_cocos2dx_Node_setScheduler);
+SE_DECLARE_FUNC(js_cocos2dx_Node_resetForReuse);
 SE_DECLARE_FUNC(js_cocos2dx_Node_stopAllActions);
 SE_DECLARE_FUNC(js_cocos2dx_Node_getSkewX);
 SE_DECLARE_FUNC(js_cocos2dx_Node_getSkewY);
@@ -468,6 +469,24 @@ SE_DECLARE_FUNC(js_cocos2dx_FileUtils_getWritablePath);
 SE_DECLARE_FUNC(js_cocos2dx_FileUtils_setDelegate);
 SE_DECLARE_FUNC(js_cocos2dx_FileUtils_getInstance);
 
+extern se::Object* __jsb_cocos2d_NodePool_proto;
+extern se::Class* __jsb_cocos2d_NodePool_class;
+
+bool js_register_cocos2d_NodePool(se::Object* obj);
+bool register_all_cocos2dx(se::Object* obj);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_getFreeCount);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_clearAll);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_prewarm);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_getDescription);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_setCapacity);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_recycle);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_isTypeRegistered);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_acquire);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_clear);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_getCapacity);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_destroyInstance);
+SE_DECLARE_FUNC(js_cocos2dx_NodePool_getInstance);
+
 extern se::Object* __jsb_cocos2d_EventAcceleration_proto;
 extern se::Class* __jsb_cocos2d_EventAcceleration_class;
 
@@ -589,6 +608,8 @@ bool js_register_cocos2d_EventListenerTouchOneByOne(se::Object* obj);
 bool register_all_cocos2dx(se::Object* obj);
 SE_DECLARE_FUNC(js_cocos2dx_EventListenerTouchOneByOne_isSwallowTouches);
 SE_DECLARE_FUNC(js_cocos2dx_EventListenerTouchOneByOne_setSwallowTouches);
+SE_DECLARE_FUNC(js_cocos2dx_EventListenerTouchOneByOne_setFilterByNodeBounds);
+SE_DECLARE_FUNC(js_cocos2dx_EventListenerTouchOneByOne_isFilterByNodeBounds);
 SE_DECLARE_FUNC(js_cocos2dx_EventListenerTouchOneByOne_init);
 SE_DECLARE_FUNC(js_cocos2dx_EventListenerTouchOneByOne_EventListenerTouchOneByOne);
 
@@ -824,6 +824,7 @@ namespace ui {
 
         //we must invalide the transform when toggling scale9enabled
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        syncTransformHierarchyState();
 
         if (_scale9Enabled)
         {